@@ -0,0 +1,120 @@
+#include "MaxRects.h"
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+bool contains(const PackRect& outer, const PackRect& inner) {
+    return inner.x >= outer.x && inner.y >= outer.y && inner.x + inner.w <= outer.x + outer.w &&
+           inner.y + inner.h <= outer.y + outer.h;
+}
+
+bool overlaps(const PackRect& a, const PackRect& b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+// 64x64, 128x64, 128x128, 256x128, ...
+void grow(int& w, int& h) {
+    if (w == h)
+        w *= 2;
+    else
+        h *= 2;
+}
+
+}
+
+MaxRectsPacker::MaxRectsPacker(int width, int height) : width_(width), height_(height), usedArea_(0) {
+    PackRect all = {0, 0, width, height};
+    free_.push_back(all);
+}
+
+bool MaxRectsPacker::insert(int w, int h, PackRect& placed) {
+    int bestShort = INT_MAX, bestLong = INT_MAX;
+    for (const PackRect& f : free_) {
+        if (w > f.w || h > f.h) continue;
+        int leftW = f.w - w, leftH = f.h - h;
+        int shortSide = std::min(leftW, leftH), longSide = std::max(leftW, leftH);
+        if (shortSide < bestShort || (shortSide == bestShort && longSide < bestLong)) {
+            placed.x = f.x;
+            placed.y = f.y;
+            bestShort = shortSide;
+            bestLong = longSide;
+        }
+    }
+    if (bestShort == INT_MAX) return false;
+    placed.w = w;
+    placed.h = h;
+    split(placed);
+    prune();
+    usedArea_ += (long long)w * h;
+    return true;
+}
+
+void MaxRectsPacker::split(const PackRect& used) {
+    std::vector<PackRect> next;
+    for (const PackRect& f : free_) {
+        if (!overlaps(f, used)) {
+            next.push_back(f);
+            continue;
+        }
+        // What is left of f on each side of used, each as wide as it can be
+        if (used.x > f.x) next.push_back({f.x, f.y, used.x - f.x, f.h});
+        if (used.x + used.w < f.x + f.w) next.push_back({used.x + used.w, f.y, f.x + f.w - used.x - used.w, f.h});
+        if (used.y > f.y) next.push_back({f.x, f.y, f.w, used.y - f.y});
+        if (used.y + used.h < f.y + f.h) next.push_back({f.x, used.y + used.h, f.w, f.y + f.h - used.y - used.h});
+    }
+    free_.swap(next);
+}
+
+void MaxRectsPacker::prune() {
+    for (size_t i = 0; i < free_.size(); ++i) {
+        for (size_t j = i + 1; j < free_.size(); ++j) {
+            if (contains(free_[j], free_[i])) {
+                free_.erase(free_.begin() + i);
+                --i;
+                break;
+            }
+            if (contains(free_[i], free_[j])) {
+                free_.erase(free_.begin() + j);
+                --j;
+            }
+        }
+    }
+}
+
+double MaxRectsPacker::occupancy() const {
+    return (double)usedArea_ / ((double)width_ * height_);
+}
+
+bool PackAll(const std::vector<PackRect>& sizes, int maxSide, int& width, int& height,
+             std::vector<PackRect>& placed) {
+    std::vector<size_t> order(sizes.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        int sideA = std::max(sizes[a].w, sizes[a].h), sideB = std::max(sizes[b].w, sizes[b].h);
+        if (sideA != sideB) return sideA > sideB;
+        return sizes[a].w * sizes[a].h > sizes[b].w * sizes[b].h;
+    });
+
+    long long area = 0;
+    for (const PackRect& s : sizes) area += (long long)s.w * s.h;
+
+    for (int w = 64, h = 64; w <= maxSide && h <= maxSide; grow(w, h)) {
+        if ((long long)w * h < area) continue;
+        MaxRectsPacker bin(w, h);
+        placed.assign(sizes.size(), PackRect());
+        bool fits = true;
+        for (size_t i : order) {
+            if (!bin.insert(sizes[i].w, sizes[i].h, placed[i])) {
+                fits = false;
+                break;
+            }
+        }
+        if (fits) {
+            width = w;
+            height = h;
+            return true;
+        }
+    }
+    return false;
+}
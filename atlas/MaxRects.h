@@ -0,0 +1,44 @@
+#ifndef MAXRECTS_H
+#define MAXRECTS_H
+
+#include <vector>
+
+struct PackRect {
+    int x, y, w, h;
+};
+
+// MaxRects bin packing: the free space of the bin is kept as the list of
+// all maximal free rectangles (they may overlap). A new rectangle goes
+// where it leaves the shortest leftover side in the free rectangle it
+// lands in (best short side fit); every free rectangle it overlaps is
+// split into the up to four maximal rectangles around it, and any free
+// rectangle inside another one is dropped.
+class MaxRectsPacker {
+public:
+    MaxRectsPacker(int width, int height);
+
+    // Top-left corner of a w x h rectangle, or false if it doesn't fit.
+    bool insert(int w, int h, PackRect& placed);
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    // Share of the bin taken by inserted rectangles.
+    double occupancy() const;
+
+private:
+    void split(const PackRect& used);
+    void prune();
+
+    int width_, height_;
+    long long usedArea_;
+    std::vector<PackRect> free_;
+};
+
+// Packs sizes (w, h each, padding already added) into the smallest power
+// of two bin, square or twice as wide as high, up to maxSide on a side.
+// Larger rectangles go first, which packs tighter. placed[i] is where
+// sizes[i] went; false if they don't fit even at maxSide.
+bool PackAll(const std::vector<PackRect>& sizes, int maxSide, int& width, int& height,
+             std::vector<PackRect>& placed);
+
+#endif
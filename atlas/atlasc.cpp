@@ -0,0 +1,249 @@
+// Packs sprite images into one atlas image plus the table that says where
+// each sprite went (common/AtlasTable.h), so a game can draw all of them
+// from a single texture.
+//
+//   atlasc -o out/circuit src/circuit.sprites    writes out/circuit.png and out/circuit.atlas
+//
+// A .sprites source lists one sprite per line:
+//
+//   padding <pixels>                 around every sprite (default 2)
+//   <name> <max side> <image>        image path relative to the source file
+//
+// Images larger than max side are scaled down (an alpha-weighted box
+// filter) to what the game actually draws. Sprites are packed with
+// MaxRects into the smallest power-of-two atlas, and each one's edge pixels
+// are repeated into its padding, so filtering near an edge picks up the
+// sprite itself and never a neighbour.
+#include "AtlasTable.h"
+#include "MaxRects.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+const int MAX_ATLAS_SIDE = 8192;
+
+// RGBA, 4 bytes a pixel, rows back to back
+struct Image {
+    int w, h;
+    std::vector<uint8_t> rgba;
+};
+
+struct Entry {
+    std::string name;
+    int maxSide;
+    std::string path;
+    Image image;
+    int sourceW, sourceH;
+};
+
+int usage(const char* argv0) {
+    std::cerr << "usage: " << argv0 << " -o <output base> <source.sprites>\n";
+    return 1;
+}
+
+std::string directoryOf(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+std::string baseName(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+bool readSource(const std::string& path, int& padding, std::vector<Entry>& entries) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "cannot open " << path << "\n";
+        return false;
+    }
+    std::string line;
+    int lineNo = 0;
+    bool ok = true;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        std::istringstream fields(line);
+        std::string first;
+        if (!(fields >> first) || first[0] == '#') continue;
+        if (first == "padding") {
+            if (!(fields >> padding) || padding < 0 || padding > 64) {
+                std::cerr << path << ":" << lineNo << ": padding must be 0 to 64\n";
+                ok = false;
+            }
+            continue;
+        }
+        Entry e;
+        e.name = first;
+        // The image path is the rest of the line, spaces and all
+        std::string file;
+        if (!(fields >> e.maxSide) || e.maxSide < 1 || !std::getline(fields >> std::ws, file) || file.empty()) {
+            std::cerr << path << ":" << lineNo << ": expected <name> <max side> <image>\n";
+            ok = false;
+            continue;
+        }
+        for (const Entry& other : entries) {
+            if (other.name == e.name) {
+                std::cerr << path << ":" << lineNo << ": sprite " << e.name << " appears twice\n";
+                ok = false;
+            }
+        }
+        e.path = directoryOf(path) + file;
+        entries.push_back(e);
+    }
+    if (ok && entries.empty()) {
+        std::cerr << path << ": no sprites\n";
+        ok = false;
+    }
+    return ok;
+}
+
+bool load(const std::string& path, Image& image) {
+    SDL_Surface* loaded = IMG_Load(path.c_str());
+    if (!loaded) {
+        std::cerr << "cannot load " << path << ": " << IMG_GetError() << "\n";
+        return false;
+    }
+    SDL_Surface* rgba = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (!rgba) {
+        std::cerr << "cannot convert " << path << ": " << SDL_GetError() << "\n";
+        return false;
+    }
+    image.w = rgba->w;
+    image.h = rgba->h;
+    image.rgba.resize((size_t)image.w * image.h * 4);
+    SDL_LockSurface(rgba);
+    for (int y = 0; y < image.h; ++y) {
+        std::memcpy(&image.rgba[(size_t)y * image.w * 4], static_cast<uint8_t*>(rgba->pixels) + y * rgba->pitch,
+                    (size_t)image.w * 4);
+    }
+    SDL_UnlockSurface(rgba);
+    SDL_FreeSurface(rgba);
+    return true;
+}
+
+// Every source pixel lands in exactly one target pixel, which takes the
+// average; colour is weighted by alpha so transparent pixels don't darken
+// the edges.
+Image shrink(const Image& src, int w, int h) {
+    std::vector<double> sum((size_t)w * h * 4, 0.0);
+    std::vector<int> count((size_t)w * h, 0);
+    for (int y = 0; y < src.h; ++y) {
+        int ty = (int)((long long)y * h / src.h);
+        for (int x = 0; x < src.w; ++x) {
+            int tx = (int)((long long)x * w / src.w);
+            const uint8_t* p = &src.rgba[((size_t)y * src.w + x) * 4];
+            double* s = &sum[((size_t)ty * w + tx) * 4];
+            double a = p[3];
+            s[0] += p[0] * a;
+            s[1] += p[1] * a;
+            s[2] += p[2] * a;
+            s[3] += a;
+            ++count[(size_t)ty * w + tx];
+        }
+    }
+    Image out;
+    out.w = w;
+    out.h = h;
+    out.rgba.resize((size_t)w * h * 4);
+    for (size_t i = 0; i < count.size(); ++i) {
+        const double* s = &sum[i * 4];
+        uint8_t* p = &out.rgba[i * 4];
+        for (int c = 0; c < 3; ++c) p[c] = s[3] > 0 ? (uint8_t)(s[c] / s[3] + 0.5) : 0;
+        p[3] = count[i] ? (uint8_t)(s[3] / count[i] + 0.5) : 0;
+    }
+    return out;
+}
+
+// Copies image to (x, y) in the atlas and repeats its outermost pixels
+// `padding` deep around it.
+void blit(const Image& image, int x, int y, int padding, Image& atlas) {
+    for (int dy = -padding; dy < image.h + padding; ++dy) {
+        int sy = std::min(std::max(dy, 0), image.h - 1);
+        for (int dx = -padding; dx < image.w + padding; ++dx) {
+            int sx = std::min(std::max(dx, 0), image.w - 1);
+            std::memcpy(&atlas.rgba[((size_t)(y + dy) * atlas.w + x + dx) * 4], &image.rgba[((size_t)sy * image.w + sx) * 4],
+                        4);
+        }
+    }
+}
+
+bool save(const Image& atlas, const std::string& path) {
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<uint8_t*>(atlas.rgba.data()), atlas.w,
+                                                              atlas.h, 32, atlas.w * 4, SDL_PIXELFORMAT_RGBA32);
+    bool ok = surface && IMG_SavePNG(surface, path.c_str()) == 0;
+    if (!ok) std::cerr << "cannot write " << path << ": " << IMG_GetError() << "\n";
+    if (surface) SDL_FreeSurface(surface);
+    return ok;
+}
+
+}
+
+int main(int argc, char** argv) {
+    if (argc != 4 || std::strcmp(argv[1], "-o") != 0) return usage(argv[0]);
+    std::string out = argv[2];
+    std::string source = argv[3];
+
+    int padding = 2;
+    std::vector<Entry> entries;
+    if (!readSource(source, padding, entries)) return 1;
+
+    bool ok = true;
+    for (Entry& e : entries) {
+        if (!load(e.path, e.image)) {
+            ok = false;
+            continue;
+        }
+        e.sourceW = e.image.w;
+        e.sourceH = e.image.h;
+        int side = std::max(e.image.w, e.image.h);
+        if (side > e.maxSide) {
+            int w = std::max(1, (int)((long long)e.image.w * e.maxSide / side));
+            int h = std::max(1, (int)((long long)e.image.h * e.maxSide / side));
+            e.image = shrink(e.image, w, h);
+        }
+    }
+    if (!ok) return 1;
+
+    std::vector<PackRect> sizes;
+    for (const Entry& e : entries) sizes.push_back({0, 0, e.image.w + 2 * padding, e.image.h + 2 * padding});
+    int width = 0, height = 0;
+    std::vector<PackRect> placed;
+    if (!PackAll(sizes, MAX_ATLAS_SIDE, width, height, placed)) {
+        std::cerr << source << ": sprites don't fit in " << MAX_ATLAS_SIDE << "x" << MAX_ATLAS_SIDE << "\n";
+        return 1;
+    }
+
+    Image atlas;
+    atlas.w = width;
+    atlas.h = height;
+    atlas.rgba.assign((size_t)width * height * 4, 0);
+    AtlasTable table;
+    table.image = baseName(out) + ".png";
+    table.width = width;
+    table.height = height;
+    long long used = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const Entry& e = entries[i];
+        AtlasSprite s = {e.name, placed[i].x + padding, placed[i].y + padding, e.image.w, e.image.h, e.sourceW, e.sourceH};
+        blit(e.image, s.x, s.y, padding, atlas);
+        table.sprites.push_back(s);
+        used += (long long)e.image.w * e.image.h;
+    }
+
+    if (!save(atlas, out + ".png")) return 1;
+    if (!table.write(out + ".atlas")) {
+        std::cerr << "cannot write " << out << ".atlas\n";
+        return 1;
+    }
+    std::cout << baseName(out) << ": " << entries.size() << " sprites in " << width << "x" << height << ", "
+              << (int)(100.0 * used / ((double)width * height) + 0.5) << "% used\n";
+    return 0;
+}
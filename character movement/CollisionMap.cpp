@@ -0,0 +1,150 @@
+#include "CollisionMap.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const int MAX_DIST = 255;
+
+struct PixelRect {
+    int x0, y0, x1, y1;   // inclusive
+};
+
+// The pixels a box touches, however little.
+PixelRect pixelsOf(const CollisionBox& box) {
+    PixelRect r;
+    r.x0 = static_cast<int>(std::floor(box.left));
+    r.y0 = static_cast<int>(std::floor(box.top));
+    r.x1 = std::max(r.x0, static_cast<int>(std::ceil(box.left + box.width)) - 1);
+    r.y1 = std::max(r.y0, static_cast<int>(std::ceil(box.top + box.height)) - 1);
+    return r;
+}
+
+}
+
+void CollisionMap::build(const uint8_t* rgba, int width, int height) {
+    width_ = width;
+    height_ = height;
+    words_ = (width + 63) / 64;
+    bits_.assign(static_cast<size_t>(words_) * height, 0);
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* p = rgba + static_cast<size_t>(y) * width * 4;
+        uint64_t* row = &bits_[static_cast<size_t>(y) * words_];
+        for (int x = 0; x < width; ++x, p += 4) {
+            bool dark = p[0] + p[1] + p[2] < 3 * 128;
+            if (dark && p[3] >= 128) row[x >> 6] |= uint64_t(1) << (x & 63);
+        }
+    }
+    buildDistance();
+}
+
+void CollisionMap::buildOpen(int width, int height) {
+    width_ = width;
+    height_ = height;
+    words_ = (width + 63) / 64;
+    bits_.assign(static_cast<size_t>(words_) * height, 0);
+    buildDistance();
+}
+
+bool CollisionMap::solid(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width_ || y >= height_) return true;
+    return (bits_[static_cast<size_t>(y) * words_ + (x >> 6)] >> (x & 63)) & 1;
+}
+
+int CollisionMap::clearance(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width_ || y >= height_) return 0;
+    return dist_[static_cast<size_t>(y) * width_ + x];
+}
+
+// Two passes of the 8-neighbour chamfer with every step costing 1, which
+// is exactly the chessboard distance. Pixels off the image count as solid.
+void CollisionMap::buildDistance() {
+    dist_.assign(static_cast<size_t>(width_) * height_, 0);
+    auto at = [&](int x, int y) -> int {
+        if (x < 0 || y < 0 || x >= width_ || y >= height_) return 0;
+        return dist_[static_cast<size_t>(y) * width_ + x];
+    };
+    for (int y = 0; y < height_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            uint8_t& d = dist_[static_cast<size_t>(y) * width_ + x];
+            if (solid(x, y)) continue;
+            int best = std::min(std::min(at(x - 1, y), at(x - 1, y - 1)), std::min(at(x, y - 1), at(x + 1, y - 1)));
+            d = static_cast<uint8_t>(std::min(best + 1, MAX_DIST));
+        }
+    }
+    for (int y = height_ - 1; y >= 0; --y) {
+        for (int x = width_ - 1; x >= 0; --x) {
+            uint8_t& d = dist_[static_cast<size_t>(y) * width_ + x];
+            int best = std::min(std::min(at(x + 1, y), at(x + 1, y + 1)), std::min(at(x, y + 1), at(x - 1, y + 1)));
+            d = static_cast<uint8_t>(std::min<int>(d, best + 1));
+        }
+    }
+}
+
+bool CollisionMap::blocked(const CollisionBox& box) const {
+    PixelRect r = pixelsOf(box);
+    if (r.x0 < 0 || r.y0 < 0 || r.x1 >= width_ || r.y1 >= height_) return true;
+
+    // Every covered pixel is within `reach` of the centre pixel.
+    int reach = std::max(r.x1 - r.x0 + 1, r.y1 - r.y0 + 1) / 2;
+    if (clearance((r.x0 + r.x1) / 2, (r.y0 + r.y1) / 2) > reach) return false;
+
+    int first = r.x0 >> 6, last = r.x1 >> 6;
+    uint64_t firstMask = ~uint64_t(0) << (r.x0 & 63);
+    uint64_t lastMask = ~uint64_t(0) >> (63 - (r.x1 & 63));
+    for (int y = r.y0; y <= r.y1; ++y) {
+        const uint64_t* row = &bits_[static_cast<size_t>(y) * words_];
+        if (first == last) {
+            if (row[first] & firstMask & lastMask) return true;
+            continue;
+        }
+        if (row[first] & firstMask) return true;
+        for (int w = first + 1; w < last; ++w) {
+            if (row[w]) return true;
+        }
+        if (row[last] & lastMask) return true;
+    }
+    return false;
+}
+
+// Conservative advancement: while the distance field says the box has room,
+// take the whole of that room in one step; next to a wall, go a pixel at a
+// time, and at the wall close the last gap to the pixel edge so the box ends
+// up flush against it.
+float CollisionMap::sweep(const CollisionBox& box, int axis, float delta) const {
+    if (delta == 0.0f || width_ == 0) return delta;
+    // Already overlapping something (placed there, or the mask changed):
+    // let it walk out rather than pinning it in place.
+    if (blocked(box)) return delta;
+
+    float dir = delta < 0 ? -1.0f : 1.0f;
+    float remaining = std::fabs(delta), moved = 0.0f;
+    CollisionBox b = box;
+    float& pos = axis == 0 ? b.left : b.top;
+    float size = axis == 0 ? b.width : b.height;
+    while (remaining > 0.0f) {
+        PixelRect r = pixelsOf(b);
+        int reach = std::max(r.x1 - r.x0 + 1, r.y1 - r.y0 + 1) / 2;
+        // Rounding to pixels can add one to the box on each side.
+        float room = static_cast<float>(clearance((r.x0 + r.x1) / 2, (r.y0 + r.y1) / 2) - reach - 2);
+        float step = room >= 1.0f ? std::min(room, remaining) : std::min(1.0f, remaining);
+        float before = pos;
+        pos += dir * step;
+        if (room < 1.0f && blocked(b)) {
+            pos = before;
+            float edge = dir > 0 ? std::ceil(pos + size) - (pos + size) : pos - std::floor(pos);
+            moved += dir * std::min(edge, remaining);
+            break;
+        }
+        moved += dir * step;
+        remaining -= step;
+    }
+    return moved;
+}
+
+CollisionBox CollisionMap::move(const CollisionBox& box, float dx, float dy) const {
+    CollisionBox b = box;
+    b.left += sweep(b, 0, dx);
+    b.top += sweep(b, 1, dy);
+    return b;
+}
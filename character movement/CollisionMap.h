@@ -0,0 +1,57 @@
+#ifndef COLLISIONMAP_H
+#define COLLISIONMAP_H
+
+#include <cstdint>
+#include <vector>
+
+// Axis-aligned box in room pixels; positions are floats so movement can
+// build up in fractions of a pixel from one frame to the next.
+struct CollisionBox {
+    float left, top, width, height;
+};
+
+// Where a room can be walked, taken from a mask image drawn over the room:
+// dark opaque pixels are solid, everything else is floor. Outside the image
+// counts as solid, so the edges of the room are walls too.
+//
+// The mask is packed one bit per pixel, each row padded to whole 64-bit
+// words, so testing a box is a few word operations per row. Next to it is a
+// distance field: for each pixel, how many pixels away (in the larger of x
+// and y) the nearest solid pixel is. A box whose centre is further from any
+// wall than its half size can't be touching one, which is one lookup, so
+// only boxes close to a wall pay for the row test.
+class CollisionMap {
+public:
+    CollisionMap() : width_(0), height_(0), words_(0) {}
+
+    // rgba is width x height x 4 bytes, as sf::Image::getPixelsPtr() gives.
+    void build(const uint8_t* rgba, int width, int height);
+    // No mask: only the image edges are walls.
+    void buildOpen(int width, int height);
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    bool solid(int x, int y) const;
+    // Pixels from (x, y) to the nearest solid pixel, counting diagonal steps
+    // as one; capped at 255.
+    int clearance(int x, int y) const;
+
+    // True if any pixel the box covers is solid.
+    bool blocked(const CollisionBox& box) const;
+
+    // Moves box by (dx, dy) as far as it can go. x and y are resolved one
+    // after the other, so pushing into a wall at an angle slides along it.
+    CollisionBox move(const CollisionBox& box, float dx, float dy) const;
+
+private:
+    // Furthest along one axis (0 x, 1 y) the box can go, up to delta.
+    float sweep(const CollisionBox& box, int axis, float delta) const;
+    void buildDistance();
+
+    int width_, height_;
+    int words_;                   // 64-bit words per row
+    std::vector<uint64_t> bits_;  // 1 = solid
+    std::vector<uint8_t> dist_;
+};
+
+#endif
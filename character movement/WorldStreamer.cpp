@@ -0,0 +1,228 @@
+#include "WorldStreamer.h"
+#include "AllocTracker.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// Tiles that aren't on screen yet are uploaded at most this many a frame,
+// so a burst of them doesn't stall one frame.
+const int PREFETCH_UPLOADS = 2;
+
+sf::FloatRect grow(const sf::FloatRect& r, float by) {
+    return sf::FloatRect(r.left - by, r.top - by, r.width + 2 * by, r.height + 2 * by);
+}
+
+bool inRange(const sf::IntRect& range, int col, int row) {
+    return col >= range.left && col < range.left + range.width && row >= range.top && row < range.top + range.height;
+}
+
+}
+
+WorldStreamer::WorldStreamer()
+    : size_(0, 0), tileSize_(0), cols_(0), rows_(0), budget_(64), resident_(0), stats_(), quit_(false) {}
+
+WorldStreamer::~WorldStreamer() {
+    stop();
+}
+
+void WorldStreamer::stop() {
+    if (!thread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    wake_.notify_all();
+    thread_.join();
+}
+
+bool WorldStreamer::open(const std::string& dir) {
+    stop();
+    cols_ = rows_ = 0;
+    tiles_.clear();
+    queue_.clear();
+    decoded_.clear();
+    resident_ = 0;
+    stats_ = Stats();
+
+    std::ifstream in(dir + "/world.txt");
+    if (!in) return false;
+    unsigned width = 0, height = 0;
+    int tile = 0;
+    std::string mask, line;
+    while (std::getline(in, line)) {
+        std::istringstream words(line);
+        std::string key;
+        words >> key;
+        if (key == "size") words >> width >> height;
+        else if (key == "tile") words >> tile;
+        else if (key == "mask") words >> mask;
+    }
+    if (width == 0 || height == 0 || tile <= 0) {
+        std::cerr << dir << "/world.txt: needs a size and a tile size\n";
+        return false;
+    }
+
+    dir_ = dir;
+    size_ = sf::Vector2u(width, height);
+    tileSize_ = tile;
+    cols_ = static_cast<int>((width + tile - 1) / tile);
+    rows_ = static_cast<int>((height + tile - 1) / tile);
+    maskPath_ = mask.empty() ? "" : dir + "/" + mask;
+    tiles_.assign(static_cast<size_t>(cols_) * rows_, Tile());
+    quit_ = false;
+    thread_ = std::thread(&WorldStreamer::loader, this);
+    return true;
+}
+
+std::string WorldStreamer::tilePath(int index) const {
+    return dir_ + "/tile_" + std::to_string(index / cols_) + "_" + std::to_string(index % cols_) + ".png";
+}
+
+// Columns and rows of the tiles that overlap area, clipped to the world.
+sf::IntRect WorldStreamer::tileRange(const sf::FloatRect& area) const {
+    int c0 = std::max(0, static_cast<int>(std::floor(area.left / tileSize_)));
+    int r0 = std::max(0, static_cast<int>(std::floor(area.top / tileSize_)));
+    int c1 = std::min(cols_ - 1, static_cast<int>(std::floor((area.left + area.width) / tileSize_)));
+    int r1 = std::min(rows_ - 1, static_cast<int>(std::floor((area.top + area.height) / tileSize_)));
+    return sf::IntRect(c0, r0, std::max(0, c1 - c0 + 1), std::max(0, r1 - r0 + 1));
+}
+
+float WorldStreamer::distanceTo(int index, sf::Vector2f point) const {
+    float x = (index % cols_ + 0.5f) * tileSize_ - point.x;
+    float y = (index / cols_ + 0.5f) * tileSize_ - point.y;
+    return std::sqrt(x * x + y * y);
+}
+
+void WorldStreamer::evict(int index) {
+    tiles_[index].texture = sf::Texture();
+    tiles_[index].state = EMPTY;
+    --resident_;
+    ++stats_.evicted;
+}
+
+void WorldStreamer::loader() {
+    ALLOC_TAG("tile loads");
+    for (;;) {
+        Decoded tile;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return quit_ || !queue_.empty(); });
+            if (quit_) return;
+            tile.index = queue_.back();
+            queue_.pop_back();
+            tiles_[tile.index].state = LOADING;
+        }
+        // A tile that fails to load is handed over empty and drawn as a
+        // hole rather than retried every frame.
+        if (!tile.image.loadFromFile(tilePath(tile.index))) tile.image = sf::Image();
+        std::lock_guard<std::mutex> lock(mutex_);
+        tiles_[tile.index].state = DECODED;
+        decoded_.push_back(std::move(tile));
+    }
+}
+
+void WorldStreamer::update(const sf::View& view) {
+    ALLOC_TAG("streaming");
+    if (!isOpen()) return;
+    sf::Vector2f center = view.getCenter(), extent = view.getSize();
+    sf::FloatRect visible(center.x - extent.x / 2, center.y - extent.y / 2, extent.x, extent.y);
+    sf::IntRect see = tileRange(visible);
+    sf::IntRect want = tileRange(grow(visible, tileSize_));
+    sf::IntRect keep = tileRange(grow(visible, 2.0f * tileSize_));
+
+    std::vector<Decoded> ready;
+    bool queued;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready.swap(decoded_);
+        // The queue is rebuilt every frame, so tiles the camera has moved
+        // away from before they were loaded just drop out of it.
+        for (int index : queue_) tiles_[index].state = EMPTY;
+        queue_.clear();
+        for (int r = want.top; r < want.top + want.height; ++r) {
+            for (int c = want.left; c < want.left + want.width; ++c) {
+                int index = r * cols_ + c;
+                if (tiles_[index].state != EMPTY) continue;
+                tiles_[index].state = QUEUED;
+                queue_.push_back(index);
+            }
+        }
+        std::sort(queue_.begin(), queue_.end(),
+                  [&](int a, int b) { return distanceTo(a, center) > distanceTo(b, center); });
+        queued = !queue_.empty();
+    }
+    if (queued) wake_.notify_one();
+
+    std::sort(ready.begin(), ready.end(), [&](const Decoded& a, const Decoded& b) {
+        return distanceTo(a.index, center) < distanceTo(b.index, center);
+    });
+    std::vector<Decoded> later;
+    int prefetch = PREFETCH_UPLOADS;
+    for (Decoded& d : ready) {
+        int col = d.index % cols_, row = d.index / cols_;
+        Tile& tile = tiles_[d.index];
+        bool far = !inRange(keep, col, row);
+        if (!far && !inRange(see, col, row) && prefetch-- <= 0) {
+            later.push_back(std::move(d));
+            continue;
+        }
+        ++stats_.loaded;
+        if (far) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tile.state = EMPTY;
+            continue;
+        }
+        if (d.image.getSize().x > 0 && tile.texture.loadFromImage(d.image)) ++stats_.uploaded;
+        std::lock_guard<std::mutex> lock(mutex_);
+        tile.state = RESIDENT;
+        ++resident_;
+    }
+    if (!later.empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Decoded& d : later) decoded_.push_back(std::move(d));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<int> kept;
+    for (int index = 0; index < static_cast<int>(tiles_.size()); ++index) {
+        if (tiles_[index].state != RESIDENT) continue;
+        if (inRange(keep, index % cols_, index / cols_)) kept.push_back(index);
+        else evict(index);
+    }
+    if (kept.size() > budget_) {
+        std::sort(kept.begin(), kept.end(),
+                  [&](int a, int b) { return distanceTo(a, center) < distanceTo(b, center); });
+        for (size_t i = budget_; i < kept.size(); ++i) evict(kept[i]);
+    }
+    for (int r = see.top; r < see.top + see.height; ++r) {
+        for (int c = see.left; c < see.left + see.width; ++c) {
+            if (tiles_[r * cols_ + c].state != RESIDENT) {
+                ++stats_.holeFrames;
+                return;
+            }
+        }
+    }
+}
+
+void WorldStreamer::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (!isOpen()) return;
+    const sf::View& view = target.getView();
+    sf::Vector2f center = view.getCenter(), extent = view.getSize();
+    sf::IntRect see = tileRange(sf::FloatRect(center.x - extent.x / 2, center.y - extent.y / 2, extent.x, extent.y));
+    sf::Sprite sprite;
+    for (int r = see.top; r < see.top + see.height; ++r) {
+        for (int c = see.left; c < see.left + see.width; ++c) {
+            const Tile& tile = tiles_[r * cols_ + c];
+            // Textures are only touched on this thread (the loader works on
+            // images), so this needs no lock: an empty one isn't in yet.
+            if (tile.texture.getSize().x == 0) continue;
+            sprite.setTexture(tile.texture, true);
+            sprite.setPosition(static_cast<float>(c * tileSize_), static_cast<float>(r * tileSize_));
+            target.draw(sprite, states);
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef WORLDSTREAMER_H
+#define WORLDSTREAMER_H
+
+#include <SFML/Graphics.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Draws a world far bigger than one texture can be, from square tiles that
+// world_cut wrote to a directory:
+//
+//   <dir>/world.txt             "size <w> <h>", "tile <px>", "mask <file>"
+//   <dir>/tile_<row>_<col>.png  edge tiles are cut short
+//
+// Only the tiles around the camera are ever in video memory. update()
+// queues the ones the view needs (and a ring of one tile around it, so
+// walking doesn't show holes) nearest first; a background thread decodes
+// the PNGs; update() then uploads them on the main thread, since textures
+// belong to the GL context. Tiles more than two tiles outside the view are
+// dropped, and if more than the budget are resident the furthest go first.
+class WorldStreamer : public sf::Drawable {
+public:
+    struct Stats {
+        size_t loaded;      // tiles decoded by the loader
+        size_t uploaded;
+        size_t evicted;
+        size_t holeFrames;  // updates where a visible tile wasn't there yet
+    };
+
+    WorldStreamer();
+    ~WorldStreamer();
+
+    bool open(const std::string& dir);
+    bool isOpen() const { return cols_ > 0; }
+    sf::Vector2u size() const { return size_; }
+    // Full path of the world's collision mask, or "" if it has none.
+    const std::string& maskPath() const { return maskPath_; }
+
+    // Most tiles kept in video memory at once. It should cover the view
+    // and the ring around it, or tiles will be dropped and loaded again.
+    void setBudget(size_t tiles) { budget_ = tiles; }
+    // Call once a frame with the view the world will be drawn with.
+    void update(const sf::View& view);
+
+    size_t resident() const { return resident_; }
+    const Stats& stats() const { return stats_; }
+
+private:
+    enum State { EMPTY, QUEUED, LOADING, DECODED, RESIDENT };
+
+    struct Tile {
+        State state = EMPTY;
+        sf::Texture texture;
+    };
+
+    struct Decoded {
+        int index;
+        sf::Image image;
+    };
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    void loader();
+    void stop();
+    std::string tilePath(int index) const;
+    sf::IntRect tileRange(const sf::FloatRect& area) const;
+    float distanceTo(int index, sf::Vector2f point) const;
+    void evict(int index);
+
+    std::string dir_;
+    sf::Vector2u size_;
+    int tileSize_, cols_, rows_;
+    std::string maskPath_;
+    size_t budget_;
+    std::vector<Tile> tiles_;
+    size_t resident_;
+    Stats stats_;
+
+    // Shared with the loader thread; tile states change under the lock too.
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<int> queue_;        // nearest last, so the loader pops the back
+    std::vector<Decoded> decoded_;
+    bool quit_;
+};
+
+#endif
@@ -0,0 +1,106 @@
+// Builds a collision map from a synthetic 4K room mask (floor with random
+// furniture rectangles) and times what the game asks of it each frame:
+// testing the robot's box, and moving it with wall sliding. The box tests
+// are also checked pixel by pixel against the mask, and moved boxes for
+// ending up inside a wall.
+//
+//   collision_bench [width height] [queries]   (defaults: 3840 2160, 200000)
+#include "CollisionMap.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Robot's feet at the room's scale: the game uses the bottom of the sprite.
+const float BOX_W = 92, BOX_H = 58;
+
+bool slowBlocked(const std::vector<uint8_t>& rgba, int width, int height, const CollisionBox& box) {
+    int x0 = static_cast<int>(std::floor(box.left)), y0 = static_cast<int>(std::floor(box.top));
+    int x1 = static_cast<int>(std::ceil(box.left + box.width)) - 1;
+    int y1 = static_cast<int>(std::ceil(box.top + box.height)) - 1;
+    if (x0 < 0 || y0 < 0 || x1 >= width || y1 >= height) return true;
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            if (rgba[(static_cast<size_t>(y) * width + x) * 4] < 128) return true;
+        }
+    }
+    return false;
+}
+
+}
+
+int main(int argc, char** argv) {
+    int width = argc > 2 ? std::atoi(argv[1]) : 3840;
+    int height = argc > 2 ? std::atoi(argv[2]) : 2160;
+    int queries = argc > 3 ? std::atoi(argv[3]) : 200000;
+    if (width < 256 || height < 256) width = height = 256;
+    if (queries < 1) queries = 1;
+
+    std::mt19937 rng(7);
+    std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4, 255);
+    for (int i = 0; i < 60; ++i) {
+        int w = 40 + rng() % 400, h = 40 + rng() % 300;
+        int x = rng() % (width - w), y = rng() % (height - h);
+        for (int yy = y; yy < y + h; ++yy) {
+            for (int xx = x; xx < x + w; ++xx) {
+                uint8_t* p = &rgba[(static_cast<size_t>(yy) * width + xx) * 4];
+                p[0] = p[1] = p[2] = 0;
+            }
+        }
+    }
+
+    CollisionMap map;
+    Clock::time_point start = Clock::now();
+    map.build(rgba.data(), width, height);
+    std::printf("%dx%d mask: build %.1f ms\n", width, height, msSince(start));
+
+    std::uniform_real_distribution<float> px(0, width - BOX_W), py(0, height - BOX_H);
+    std::vector<CollisionBox> boxes(queries);
+    for (CollisionBox& b : boxes) b = CollisionBox{px(rng), py(rng), BOX_W, BOX_H};
+
+    size_t hits = 0;
+    start = Clock::now();
+    for (const CollisionBox& b : boxes) hits += map.blocked(b);
+    double blockedMs = msSince(start);
+
+    int mismatches = 0;
+    for (int i = 0; i < queries; i += 97) {
+        if (map.blocked(boxes[i]) != slowBlocked(rgba, width, height, boxes[i])) ++mismatches;
+    }
+
+    // One frame's worth of movement (6 px) in a random direction, starting
+    // from free spots, as the robot does.
+    std::uniform_real_distribution<float> angle(0, 6.2831853f);
+    double moved = 0;
+    int moves = 0, stuck = 0;
+    start = Clock::now();
+    for (const CollisionBox& b : boxes) {
+        if (map.blocked(b)) continue;
+        float a = angle(rng);
+        CollisionBox after = map.move(b, 6 * std::cos(a), 6 * std::sin(a));
+        moved += std::fabs(after.left - b.left) + std::fabs(after.top - b.top);
+        ++moves;
+    }
+    double moveMs = msSince(start);
+    for (int i = 0; i < queries; i += 97) {
+        if (map.blocked(boxes[i])) continue;
+        CollisionBox after = map.move(boxes[i], 6, -4);
+        if (map.blocked(after)) ++stuck;
+    }
+
+    std::printf("blocked(): %.3f us per box, %zu of %d hit, %d mismatches against the mask\n",
+                blockedMs * 1000.0 / queries, hits, queries, mismatches);
+    std::printf("move():    %.3f us per move (%d moves, %.2f px on average), %d ended inside a wall\n",
+                moveMs * 1000.0 / std::max(1, moves), moves, moved / std::max(1, moves), stuck);
+    return mismatches == 0 && stuck == 0 ? 0 : 1;
+}
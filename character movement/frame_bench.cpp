@@ -0,0 +1,84 @@
+// Runs a stand-in game loop (a few ms of busy work per frame, no window)
+// three ways and compares them: unpaced, as robot_room used to run;
+// paced by sleeping alone; and paced by FramePacer's sleep-then-spin.
+// For each it prints the frame rate, the CPU the loop used, how far the
+// frame intervals stray from the target, and how fast the robot went.
+//
+//   frame_bench [seconds per run] [work ms per frame]   (defaults: 2, 3)
+#include "FramePacer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const double TARGET_FPS = 60.0;
+const float SPEED_PER_FRAME = 6.0f;     // the old robot speed
+const float SPEED_PER_SECOND = 360.0f;  // the same speed at 60 fps
+
+void busyWork(double ms) {
+    Clock::time_point until = Clock::now() + std::chrono::microseconds(static_cast<long long>(ms * 1000));
+    while (Clock::now() < until) {
+    }
+}
+
+void run(const char* name, double seconds, double workMs, int mode) {
+    FramePacer pacer(TARGET_FPS);
+    pacer.setSpin(mode == 2);
+
+    std::vector<double> intervals;
+    float x = 0;
+    std::clock_t cpuStart = std::clock();
+    Clock::time_point start = Clock::now(), last = start;
+    while (Clock::now() - start < std::chrono::duration<double>(seconds)) {
+        busyWork(workMs);
+        if (mode == 0) {
+            x += SPEED_PER_FRAME;
+        } else {
+            x += SPEED_PER_SECOND * pacer.tick();
+        }
+        Clock::time_point now = Clock::now();
+        intervals.push_back(std::chrono::duration<double, std::milli>(now - last).count());
+        last = now;
+    }
+    double wall = std::chrono::duration<double>(Clock::now() - start).count();
+    double cpu = double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+    // The first interval of a paced run is the pacer starting up.
+    if (mode != 0 && !intervals.empty()) intervals.erase(intervals.begin());
+    double target = 1000.0 / TARGET_FPS, sum = 0, sumSq = 0;
+    std::vector<double> off;
+    for (double ms : intervals) {
+        sum += ms;
+        sumSq += ms * ms;
+        off.push_back(std::fabs(ms - target));
+    }
+    double mean = sum / intervals.size();
+    double jitter = std::sqrt(std::max(0.0, sumSq / intervals.size() - mean * mean));
+    std::sort(off.begin(), off.end());
+    double median = off[off.size() / 2], p99 = off[off.size() * 99 / 100];
+
+    std::printf("%-14s %7.1f fps  cpu %5.1f%%  interval %6.2f ms  jitter %5.3f ms  off target: median %5.3f p99 %6.3f ms  robot %4.0f px/s\n",
+                name, intervals.size() / wall, 100.0 * cpu / wall, mean, jitter, median, p99, x / wall);
+}
+
+}
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? std::atof(argv[1]) : 2.0;
+    double workMs = argc > 2 ? std::atof(argv[2]) : 3.0;
+    if (seconds <= 0) seconds = 2.0;
+    if (workMs < 0) workMs = 0;
+
+    std::printf("%.0f s per run, %.1f ms of work per frame, target %.0f fps\n", seconds, workMs, TARGET_FPS);
+    run("unpaced", seconds, workMs, 0);
+    run("sleep only", seconds, workMs, 1);
+    run("sleep + spin", seconds, workMs, 2);
+    return 0;
+}
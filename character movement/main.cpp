@@ -1,76 +1,125 @@
-#include <SFML/Graphics.hpp>
-
-int main() {
-    // Load background texture
-    sf::Texture roomTexture;
-    if (!roomTexture.loadFromFile("room.png")) {
-        return -1;
-    }
-
-    // Get background size
-    sf::Vector2u bgSize = roomTexture.getSize();
-
-    // Create window same size as background
-    sf::RenderWindow window(sf::VideoMode(bgSize.x, bgSize.y), "Robot in Room");
-    sf::Sprite roomSprite(roomTexture);
-
-    // Load robot texture
-    sf::Texture robotTexture;
-    if (!robotTexture.loadFromFile("robot.png")) {
-        return -1;
-    }
-    sf::Sprite robotSprite(robotTexture);
-    robotSprite.setPosition(350, 350); // Start in middle
-
-    // Explicit scaling to make robot twice its previous size
-    // Old size was 0.075, so new scale is 0.15 (double)
-    robotSprite.setScale(0.15f, 0.15f);
-
-    float speed = 6.0f; // Movement speed
-
-    // Main loop
-    while (window.isOpen()) {
-        sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed)
-                window.close();
-        }
-
-        // Movement input
-        sf::Vector2f movement(0.f, 0.f);
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up))
-            movement.y -= speed;
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down))
-            movement.y += speed;
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left))
-            movement.x -= speed;
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
-            movement.x += speed;
-
-        // Predict new position
-        sf::FloatRect newPos = robotSprite.getGlobalBounds();
-        newPos.left += movement.x;
-        newPos.top += movement.y;
-
-        // Check background boundaries
-        bool withinBounds = true;
-        if (newPos.left < 0 || newPos.top < 0 ||
-            newPos.left + newPos.width > bgSize.x ||
-            newPos.top + newPos.height > bgSize.y) {
-            withinBounds = false;
-        }
-
-        // Move only if within boundaries
-        if (withinBounds) {
-            robotSprite.move(movement);
-        }
-
-        // Draw
-        window.clear();
-        window.draw(roomSprite);
-        window.draw(robotSprite);
-        window.display();
-    }
-
-    return 0;
-}
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include "CollisionMap.h"
+#include "AllocTracker.h"
+#include "FramePacer.h"
+#include "WorldStreamer.h"
+
+// The window shows at most one room (room.png's size); bigger worlds scroll.
+const unsigned MAX_WINDOW_W = 1525;
+const unsigned MAX_WINDOW_H = 1355;
+
+int main() {
+    ALLOC_TRACK_START("robot_room");
+    // The world cut into tiles by `make world`, streamed in around the
+    // camera. Without it, just room.png as one texture.
+    WorldStreamer world;
+    sf::Texture roomTexture;
+    std::string maskPath = "room_mask.png";
+    sf::Vector2u bgSize;
+    if (world.open("world")) {
+        bgSize = world.size();
+        maskPath = world.maskPath();
+    } else if (roomTexture.loadFromFile("room.png")) {
+        bgSize = roomTexture.getSize();
+    } else {
+        return -1;
+    }
+    sf::Sprite roomSprite(roomTexture);
+
+    // Window the size of the background, up to one room
+    sf::Vector2u windowSize(std::min(bgSize.x, MAX_WINDOW_W), std::min(bgSize.y, MAX_WINDOW_H));
+    sf::RenderWindow window(sf::VideoMode(windowSize.x, windowSize.y), "Robot in Room");
+    sf::View camera(sf::FloatRect(0, 0, windowSize.x, windowSize.y));
+
+    // Walls and furniture: black in the mask, drawn over the background.
+    // Without a mask the robot can go anywhere inside the background.
+    CollisionMap walls;
+    sf::Image mask;
+    if (!maskPath.empty() && mask.loadFromFile(maskPath) && mask.getSize() == bgSize) {
+        walls.build(mask.getPixelsPtr(), bgSize.x, bgSize.y);
+    } else {
+        walls.buildOpen(bgSize.x, bgSize.y);
+    }
+
+    // Load robot texture
+    sf::Texture robotTexture;
+    if (!robotTexture.loadFromFile("robot.png")) {
+        return -1;
+    }
+    sf::Sprite robotSprite(robotTexture);
+
+    // Explicit scaling to make robot twice its previous size
+    // Old size was 0.075, so new scale is 0.15 (double)
+    robotSprite.setScale(0.15f, 0.15f);
+
+    // Only the robot's feet collide, so it can stand in front of a desk
+    // with its head over it. The box keeps the fractions of a pixel each
+    // frame moves; the sprite is drawn at the nearest whole pixel.
+    sf::FloatRect robotSize = robotSprite.getGlobalBounds();
+    sf::Vector2f feetOffset(robotSize.width * 0.2f, robotSize.height * 0.85f);
+    CollisionBox feet = {683 + feetOffset.x, 800 + feetOffset.y, robotSize.width * 0.6f, robotSize.height * 0.15f};
+    // Start in the aisle
+    robotSprite.setPosition(683, 800);
+
+    float speed = 360.0f; // Movement speed, pixels per second
+
+    // 60 fps, vsync while frames keep up with it
+    FramePacer pacer(60.0);
+    pacer.useAdaptiveVsync([&](bool on) { window.setVerticalSyncEnabled(on); });
+    float dt = 0.0f;
+
+    // Main loop
+    while (window.isOpen()) {
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed)
+                window.close();
+        }
+
+        // Movement input
+        sf::Vector2f movement(0.f, 0.f);
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up))
+            movement.y -= speed;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down))
+            movement.y += speed;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left))
+            movement.x -= speed;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
+            movement.x += speed;
+        movement *= dt;
+
+        // Go as far as the walls allow, sliding along any it runs into
+        feet = walls.move(feet, movement.x, movement.y);
+        robotSprite.setPosition(std::round(feet.left - feetOffset.x), std::round(feet.top - feetOffset.y));
+
+        // Camera follows the robot, stopping at the edges of the world
+        sf::Vector2f half(windowSize.x / 2.0f, windowSize.y / 2.0f);
+        sf::Vector2f focus(feet.left + feet.width / 2, feet.top);
+        camera.setCenter(std::round(std::max(half.x, std::min(focus.x, bgSize.x - half.x))),
+                         std::round(std::max(half.y, std::min(focus.y, bgSize.y - half.y))));
+        world.update(camera);
+
+        // Draw
+        window.clear();
+        window.setView(camera);
+        if (world.isOpen())
+            window.draw(world);
+        else
+            window.draw(roomSprite);
+        window.draw(robotSprite);
+        window.display();
+        ALLOC_FRAME();
+        dt = pacer.tick();
+    }
+
+    if (world.isOpen()) {
+        const WorldStreamer::Stats& stats = world.stats();
+        std::cout << "world tiles: " << stats.loaded << " loaded, " << stats.evicted << " evicted, "
+                  << world.resident() << " resident at exit; " << stats.holeFrames
+                  << " frames waited on a visible tile\n";
+    }
+    return 0;
+}
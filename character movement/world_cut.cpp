@@ -0,0 +1,100 @@
+// Lays room images out in a grid and cuts the result into square tiles for
+// WorldStreamer, with a matching collision mask for the whole world.
+//
+//   world_cut <dir> <tile px> <rooms per row> <room.png[:mask.png]>...
+//
+// Every room gets a cell as big as the largest room. Space a room doesn't
+// fill is black and solid; a room given without a mask is open floor.
+// Writes <dir>/world.txt, <dir>/tile_<row>_<col>.png and <dir>/mask.png.
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+int main(int argc, char** argv) {
+    if (argc < 5) {
+        std::cerr << "usage: world_cut <dir> <tile px> <rooms per row> <room.png[:mask.png]>...\n";
+        return 1;
+    }
+    std::string dir = argv[1];
+    int tile = std::atoi(argv[2]);
+    int perRow = std::atoi(argv[3]);
+    if (tile < 16 || perRow < 1) {
+        std::cerr << "world_cut: tile must be at least 16 px and rooms per row at least 1\n";
+        return 1;
+    }
+
+    std::vector<sf::Image> rooms, masks;
+    std::vector<bool> hasMask;
+    unsigned cellW = 0, cellH = 0;
+    for (int i = 4; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t colon = arg.find(':');
+        sf::Image room, mask;
+        if (!room.loadFromFile(arg.substr(0, colon))) return 1;
+        bool masked = colon != std::string::npos;
+        if (masked && (!mask.loadFromFile(arg.substr(colon + 1)) || mask.getSize() != room.getSize())) {
+            std::cerr << "world_cut: " << arg.substr(colon + 1) << " must load and match its room's size\n";
+            return 1;
+        }
+        cellW = std::max(cellW, room.getSize().x);
+        cellH = std::max(cellH, room.getSize().y);
+        rooms.push_back(room);
+        masks.push_back(mask);
+        hasMask.push_back(masked);
+    }
+
+    int count = static_cast<int>(rooms.size());
+    unsigned width = cellW * std::min(count, perRow);
+    unsigned height = cellH * ((count + perRow - 1) / perRow);
+    sf::Image world, worldMask;
+    world.create(width, height, sf::Color::Black);
+    worldMask.create(width, height, sf::Color::Black);
+    for (int i = 0; i < count; ++i) {
+        unsigned x = cellW * (i % perRow), y = cellH * (i / perRow);
+        world.copy(rooms[i], x, y);
+        if (hasMask[i]) {
+            worldMask.copy(masks[i], x, y);
+        } else {
+            sf::Image open;
+            open.create(rooms[i].getSize().x, rooms[i].getSize().y, sf::Color::White);
+            worldMask.copy(open, x, y);
+        }
+    }
+
+    if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << "world_cut: can't create " << dir << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    int cols = (width + tile - 1) / tile, rows = (height + tile - 1) / tile;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            int w = std::min<int>(tile, width - c * tile), h = std::min<int>(tile, height - r * tile);
+            sf::Image piece;
+            piece.create(w, h);
+            piece.copy(world, 0, 0, sf::IntRect(c * tile, r * tile, w, h));
+            std::string path = dir + "/tile_" + std::to_string(r) + "_" + std::to_string(c) + ".png";
+            if (!piece.saveToFile(path)) return 1;
+        }
+    }
+    if (!worldMask.saveToFile(dir + "/mask.png")) return 1;
+
+    std::ofstream out(dir + "/world.txt");
+    out << "# written by world_cut\n"
+        << "size " << width << " " << height << "\n"
+        << "tile " << tile << "\n"
+        << "mask mask.png\n";
+    if (!out) {
+        std::cerr << "world_cut: can't write " << dir << "/world.txt\n";
+        return 1;
+    }
+    std::cout << count << " rooms, " << width << "x" << height << " px, " << cols << "x" << rows << " tiles of "
+              << tile << " px in " << dir << "\n";
+    return 0;
+}
@@ -0,0 +1,258 @@
+#include "CircuitPuzzle.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <ostream>
+#include <sstream>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// An LED above this current is destroyed.
+const double LED_BURN_AMPS = 0.05;
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+}
+
+CircuitPuzzle::CircuitPuzzle()
+    : solved_(false), burnt_(false), previewSlot_(-1), previewAmps_(0.0), previewVolts_(0.0) {
+    clear();
+}
+
+void CircuitPuzzle::clear() {
+    nets_.clear();
+    fixed_.clear();
+    values_.clear();
+    ledRange_ = ammeterRange_ = voltmeterRange_ = Range{0.0, 0.0, false};
+    circuit_.clear();
+    slotElement_.clear();
+    slotKind_.clear();
+    elementKind_.clear();
+    leds_.clear();
+    ammeters_.clear();
+    voltmeters_.clear();
+    solved_ = burnt_ = false;
+    status_.clear();
+    previewSlot_ = -1;
+}
+
+bool CircuitPuzzle::loadLayout(const std::string& path) {
+    std::ifstream in(path.c_str());
+    if (!in) return false;
+
+    clear();
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        std::istringstream ss(line);
+        std::string what, kind;
+        if (!(ss >> what)) continue;
+
+        bool ok = true;
+        if (what == "net") {
+            int slot, a, b;
+            ok = static_cast<bool>(ss >> slot >> a >> b) && slot >= 0 && a >= 0 && b >= 0;
+            if (ok) setNet(slot, a, b);
+        } else if (what == "fixed") {
+            int a, b;
+            ok = static_cast<bool>(ss >> kind >> a >> b) && a >= 0 && b >= 0;
+            if (ok) addFixed(kind, a, b);
+        } else if (what == "value") {
+            double v;
+            ok = static_cast<bool>(ss >> kind >> v);
+            if (ok) setValue(kind, v);
+        } else if (what == "expect") {
+            double lo, hi;
+            ok = static_cast<bool>(ss >> kind >> lo >> hi);
+            if (ok) expect(kind, lo, hi);
+        }
+        if (!ok) std::cerr << path << ":" << lineNo << ": bad '" << what << "' line\n";
+    }
+    return !nets_.empty();
+}
+
+void CircuitPuzzle::setNet(int slot, int a, int b) {
+    if (slot >= static_cast<int>(nets_.size())) nets_.resize(slot + 1, Net{-1, -1});
+    nets_[slot] = Net{a, b};
+}
+
+void CircuitPuzzle::addFixed(const std::string& kind, int a, int b) {
+    fixed_.push_back(Fixed{kind, a, b});
+}
+
+void CircuitPuzzle::expect(const std::string& what, double lo, double hi) {
+    Range r = {lo, hi, true};
+    if (what == "led") ledRange_ = r;
+    else if (what == "ammeter") ammeterRange_ = r;
+    else if (what == "voltmeter") voltmeterRange_ = r;
+    else std::cerr << "CircuitPuzzle: nothing called '" << what << "' to expect\n";
+}
+
+double CircuitPuzzle::value(const std::string& kind, double fallback) const {
+    std::map<std::string, double>::const_iterator it = values_.find(kind);
+    return it == values_.end() ? fallback : it->second;
+}
+
+Circuit::Part CircuitPuzzle::partFor(const std::string& kind) const {
+    if (kind == "battery") return Circuit::battery(value("battery", 9.0));
+    if (kind == "resistor") return Circuit::resistor(value("resistor", 470.0));
+    if (kind == "capacitor") return Circuit::capacitor(value("capacitor", 2200e-6));
+    if (kind == "diode") return Circuit::diode();
+    if (kind == "led") return Circuit::led();
+    if (kind == "ammeter") return Circuit::ammeter();
+    if (kind == "voltmeter") return Circuit::voltmeter();
+    // Anything else has no electrical meaning and leaves the slot open.
+    return Circuit::open();
+}
+
+void CircuitPuzzle::build(const PuzzleBoard& board) {
+    circuit_.clear();
+    size_t count = board.slots().size();
+    slotElement_.assign(count, -1);
+    slotKind_.assign(count, std::string());
+    elementKind_.clear();
+    for (size_t i = 0; i < count && i < nets_.size(); ++i) {
+        if (nets_[i].a < 0) continue;
+        slotElement_[i] = circuit_.add(nets_[i].a, nets_[i].b, Circuit::open());
+        elementKind_.push_back(std::string());
+    }
+    for (const Fixed& f : fixed_) {
+        circuit_.add(f.a, f.b, partFor(f.kind));
+        elementKind_.push_back(f.kind);
+    }
+    previewSlot_ = -1;
+    update(board);
+}
+
+void CircuitPuzzle::setSlotPart(int slot, const std::string& kind) {
+    int id = slotElement_[slot];
+    if (id < 0) return;
+    circuit_.replace(id, partFor(kind));
+    elementKind_[id] = kind;
+}
+
+void CircuitPuzzle::collectParts() {
+    leds_.clear();
+    ammeters_.clear();
+    voltmeters_.clear();
+    for (size_t id = 0; id < elementKind_.size(); ++id) {
+        if (elementKind_[id] == "led") leds_.push_back(static_cast<int>(id));
+        else if (elementKind_[id] == "ammeter") ammeters_.push_back(static_cast<int>(id));
+        else if (elementKind_[id] == "voltmeter") voltmeters_.push_back(static_cast<int>(id));
+    }
+}
+
+void CircuitPuzzle::update(const PuzzleBoard& board) {
+    Clock::time_point start = Clock::now();
+    if (previewSlot_ >= 0) {
+        setSlotPart(previewSlot_, slotKind_[previewSlot_]);
+        previewSlot_ = -1;
+    }
+
+    bool allFilled = true;
+    const std::vector<BoardSlot>& slots = board.slots();
+    for (size_t i = 0; i < slots.size() && i < slotKind_.size(); ++i) {
+        std::string kind;
+        if (slots[i].occupant >= 0) kind = board.kindName(board.pieces()[slots[i].occupant].kind);
+        else allFilled = false;
+        if (kind != slotKind_[i]) {
+            slotKind_[i] = kind;
+            setSlotPart(static_cast<int>(i), kind);
+        }
+    }
+    collectParts();
+    judge(allFilled);
+    circuit_.resetTransient();
+    latencies_.push_back(static_cast<float>(msSince(start)));
+}
+
+bool CircuitPuzzle::preview(const PuzzleBoard& board) {
+    int slot = board.snapTarget();
+    if (slot == previewSlot_) return false;
+
+    Clock::time_point start = Clock::now();
+    if (previewSlot_ >= 0) setSlotPart(previewSlot_, slotKind_[previewSlot_]);
+    previewSlot_ = slot;
+    collectParts();
+    if (slot < 0) return false;
+
+    const BoardPiece& piece = board.pieces()[board.draggedPiece()];
+    setSlotPart(slot, board.kindName(piece.kind));
+    collectParts();
+    previewAmps_ = previewVolts_ = 0.0;
+    if (circuit_.solveDC()) {
+        if (!ammeters_.empty()) previewAmps_ = std::fabs(circuit_.reading(ammeters_[0]));
+        if (!voltmeters_.empty()) previewVolts_ = std::fabs(circuit_.reading(voltmeters_[0]));
+    }
+    latencies_.push_back(static_cast<float>(msSince(start)));
+    return true;
+}
+
+// Judged on the steady state, so a slow capacitor does not delay the result.
+void CircuitPuzzle::judge(bool allFilled) {
+    solved_ = false;
+    burnt_ = false;
+    if (!circuit_.solveDC()) {
+        status_ = "Short circuit: " + circuit_.error();
+        return;
+    }
+
+    bool lit = !leds_.empty();
+    for (int id : leds_) {
+        double amps = circuit_.current(id);
+        if (amps > LED_BURN_AMPS) burnt_ = true;
+        if (!inRange(ledRange_, amps) || amps <= 0.0) lit = false;
+    }
+    bool metersOk = true;
+    for (int id : ammeters_) metersOk = metersOk && inRange(ammeterRange_, std::fabs(circuit_.reading(id)));
+    for (int id : voltmeters_) metersOk = metersOk && inRange(voltmeterRange_, std::fabs(circuit_.reading(id)));
+    if (ammeterRange_.set && ammeters_.empty()) metersOk = false;
+    if (voltmeterRange_.set && voltmeters_.empty()) metersOk = false;
+
+    if (burnt_) status_ = "The LED burnt out!";
+    else if (!allFilled) status_ = "Fill every slot";
+    else if (!lit) status_ = "The LED is not lit";
+    else if (!metersOk) status_ = "Meter readings are off";
+    else status_.clear();
+    solved_ = status_.empty();
+}
+
+void CircuitPuzzle::step(double dt) {
+    if (circuit_.elementCount() > 0) circuit_.step(dt);
+}
+
+double CircuitPuzzle::ledCurrent() const {
+    double amps = 0.0;
+    for (int id : leds_) amps = std::max(amps, circuit_.current(id));
+    return amps;
+}
+
+double CircuitPuzzle::ammeterReading() const {
+    if (previewSlot_ >= 0) return previewAmps_;
+    return ammeters_.empty() ? 0.0 : std::fabs(circuit_.reading(ammeters_[0]));
+}
+
+double CircuitPuzzle::voltmeterReading() const {
+    if (previewSlot_ >= 0) return previewVolts_;
+    return voltmeters_.empty() ? 0.0 : std::fabs(circuit_.reading(voltmeters_[0]));
+}
+
+void CircuitPuzzle::printLatencyReport(std::ostream& out) const {
+    if (latencies_.empty()) return;
+    std::vector<float> sorted(latencies_);
+    std::sort(sorted.begin(), sorted.end());
+    const SolveStats& s = circuit_.stats();
+    out << "circuit: " << sorted.size() << " solve events, p50 " << sorted[sorted.size() / 2]
+        << " ms, p99 " << sorted[sorted.size() * 99 / 100] << " ms, max " << sorted.back() << " ms; "
+        << s.lowRankSolves << " low-rank solves, " << s.refactorizations << " refactorizations, "
+        << s.factorizations << " factorizations\n";
+}
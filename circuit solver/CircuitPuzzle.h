@@ -0,0 +1,116 @@
+#ifndef CIRCUITPUZZLE_H
+#define CIRCUITPUZZLE_H
+
+#include "CircuitSim.h"
+#include "PuzzleBoard.h"
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+// Electrical side of the circuit puzzle. Each board slot is wired between
+// two nodes; whatever piece sits in a slot becomes that kind of component
+// there, and an empty slot is an open circuit. The puzzle is judged on the
+// DC operating point: every LED must carry a current in its expected range
+// (without burning out) and every meter must read within its range.
+//
+// The circuit is built once with one element per slot. Picking up,
+// dropping or hovering a piece only swaps that slot's element, which the
+// simulator solves as a low-rank update of its existing factors, so the
+// meters can follow the piece at drag rate. The time each of those events
+// takes to solve is recorded.
+//
+// The transient solution, stepped every frame, is what the LED shows:
+// capacitors start discharged after each drop, so the LED fades in.
+class CircuitPuzzle {
+public:
+    struct Range {
+        double lo, hi;
+        bool set;
+    };
+
+    CircuitPuzzle();
+
+    // Reads the netlist lines of a layout file ('#' starts a comment); the
+    // slot and piece lines are PuzzleBoard's and are skipped here.
+    //   net    <slot> <node a> <node b>     slot index in file order, 0 = ground
+    //   fixed  <kind> <node a> <node b>     part that is always in the circuit
+    //   value  <kind> <number>              ohms, volts, farads
+    //   expect <led|ammeter|voltmeter> <min> <max>
+    bool loadLayout(const std::string& path);
+    void clear();
+
+    void setNet(int slot, int a, int b);
+    void addFixed(const std::string& kind, int a, int b);
+    void setValue(const std::string& kind, double value) { values_[kind] = value; }
+    void expect(const std::string& what, double lo, double hi);
+
+    // Builds the circuit for the board's slots; call once after loading.
+    void build(const PuzzleBoard& board);
+    // Brings the slots' parts in line with the board and judges the result.
+    // Call after a piece is picked up or dropped.
+    void update(const PuzzleBoard& board);
+    // Puts the dragged piece into the slot it would snap into and solves
+    // for the meters, without judging. Only solves when that slot changes;
+    // returns true if it did.
+    bool preview(const PuzzleBoard& board);
+    bool previewing() const { return previewSlot_ >= 0; }
+    // Advances the displayed transient.
+    void step(double dt);
+
+    bool solved() const { return solved_; }
+    // Why the circuit is not solved yet, for the HUD.
+    const std::string& status() const { return status_; }
+
+    // 0 when the part is not in the circuit. LED current follows the
+    // transient; the meters show the DC preview while one is active.
+    double ledCurrent() const;
+    bool ledBurnt() const { return burnt_; }
+    bool hasAmmeter() const { return !ammeters_.empty(); }
+    bool hasVoltmeter() const { return !voltmeters_.empty(); }
+    double ammeterReading() const;
+    double voltmeterReading() const;
+
+    const Circuit& circuit() const { return circuit_; }
+    // Solve time of every pick-up, drop and preview, in milliseconds.
+    const std::vector<float>& eventLatencies() const { return latencies_; }
+    void printLatencyReport(std::ostream& out) const;
+
+private:
+    struct Net {
+        int a, b;
+    };
+    struct Fixed {
+        std::string kind;
+        int a, b;
+    };
+
+    double value(const std::string& kind, double fallback) const;
+    Circuit::Part partFor(const std::string& kind) const;
+    void setSlotPart(int slot, const std::string& kind);
+    void collectParts();
+    bool inRange(const Range& r, double v) const { return !r.set || (v >= r.lo && v <= r.hi); }
+    void judge(bool allFilled);
+
+    std::vector<Net> nets_;
+    std::vector<Fixed> fixed_;
+    std::map<std::string, double> values_;
+    Range ledRange_, ammeterRange_, voltmeterRange_;
+
+    Circuit circuit_;
+    std::vector<int> slotElement_;          // -1 for slots without a net
+    std::vector<std::string> slotKind_;     // part in each slot, "" when empty
+    std::vector<std::string> elementKind_;  // part name of every element
+    std::vector<int> leds_;
+    std::vector<int> ammeters_;
+    std::vector<int> voltmeters_;
+    bool solved_;
+    bool burnt_;
+    std::string status_;
+
+    int previewSlot_;
+    double previewAmps_, previewVolts_;
+    std::vector<float> latencies_;
+};
+
+#endif
@@ -0,0 +1,484 @@
+#include "CircuitSim.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const double GMIN = 1e-12;          // siemens, node to ground and across junctions
+const double THERMAL_VOLTAGE = 0.025852;
+const double ABSTOL = 1e-6;
+const double RELTOL = 1e-3;
+const int MAX_NEWTON = 150;
+const int DEFAULT_MAX_RANK = 8;
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// SPICE pnjlim: a junction voltage may only grow logarithmically per
+// iteration once it is above the point where the exponential takes off.
+double limitJunction(double vnew, double vold, double vt, double vcrit) {
+    if (vnew > vcrit && std::fabs(vnew - vold) > 2.0 * vt) {
+        if (vold > 0.0) {
+            double arg = 1.0 + (vnew - vold) / vt;
+            vnew = arg > 0.0 ? vold + vt * std::log(arg) : vcrit;
+        } else {
+            vnew = vt * std::log(vnew / vt);
+        }
+    }
+    return vnew;
+}
+
+double criticalVoltage(double vt, double is) {
+    return vt * std::log(vt / (std::sqrt(2.0) * is));
+}
+
+}
+
+Circuit::Part Circuit::resistor(double ohms) {
+    return Part{RESISTOR, std::max(ohms, 1e-6), 0.0};
+}
+
+Circuit::Part Circuit::battery(double volts, double internalOhms) {
+    return Part{BATTERY, volts, std::max(internalOhms, 1e-6)};
+}
+
+Circuit::Circuit()
+    : nodes_(0), branches_(0), patternDirty_(true), baseDirty_(true),
+      maxRank_(DEFAULT_MAX_RANK), time_(0.0) {
+    stats_ = SolveStats{0, 0, 0, 0, 0, 0, 0, 0.0, 0.0, 0.0};
+}
+
+void Circuit::clear() {
+    nodes_ = 0;
+    branches_ = 0;
+    elements_.clear();
+    diodes_.clear();
+    capacitors_.clear();
+    x_.clear();
+    patternDirty_ = true;
+    time_ = 0.0;
+    error_.clear();
+}
+
+int Circuit::addNode() {
+    patternDirty_ = true;
+    return ++nodes_;
+}
+
+int Circuit::add(int a, int b, const Part& part) {
+    nodes_ = std::max(nodes_, std::max(a, b));
+    Element e;
+    e.kind = OPEN;
+    e.a = a;
+    e.b = b;
+    e.value = e.param = 0.0;
+    e.branch = part.kind == VOLTAGE_SOURCE ? branches_++ : -1;
+    e.pos[0] = e.pos[1] = e.pos[2] = e.pos[3] = -1;
+    e.vd = e.vPrev = e.amps = 0.0;
+    int id = static_cast<int>(elements_.size());
+    elements_.push_back(e);
+    setPart(id, part);
+    patternDirty_ = true;
+    return id;
+}
+
+bool Circuit::replace(int element, const Part& part) {
+    Element& e = elements_[element];
+    if ((e.kind == VOLTAGE_SOURCE) != (part.kind == VOLTAGE_SOURCE)) return false;
+    setPart(element, part);
+    baseDirty_ = true;
+    return true;
+}
+
+void Circuit::setPart(int element, const Part& part) {
+    Element& e = elements_[element];
+    if (e.kind == DIODE) diodes_.erase(std::find(diodes_.begin(), diodes_.end(), element));
+    if (e.kind == CAPACITOR) capacitors_.erase(std::find(capacitors_.begin(), capacitors_.end(), element));
+    e.kind = part.kind;
+    e.value = part.value;
+    e.param = part.param;
+    e.vd = part.kind == DIODE ? criticalVoltage(part.param * THERMAL_VOLTAGE, part.value) : 0.0;
+    e.vPrev = 0.0;
+    e.amps = 0.0;
+    if (e.kind == DIODE) diodes_.push_back(element);
+    if (e.kind == CAPACITOR) capacitors_.push_back(element);
+}
+
+// The pattern holds the diagonal of every node row plus every position any
+// element can stamp, so it does not change between iterations, steps or
+// replace() calls.
+void Circuit::buildPattern() {
+    int n = unknowns();
+    std::vector<std::pair<int, int>> entries;   // (column, row)
+    for (int i = 0; i < nodes_; ++i) entries.push_back(std::make_pair(i, i));
+    for (const Element& e : elements_) {
+        int ra = e.a > 0 ? row(e.a) : -1;
+        int rb = e.b > 0 ? row(e.b) : -1;
+        if (e.kind == VOLTAGE_SOURCE) {
+            int k = nodes_ + e.branch;
+            if (ra >= 0) {
+                entries.push_back(std::make_pair(k, ra));
+                entries.push_back(std::make_pair(ra, k));
+            }
+            if (rb >= 0) {
+                entries.push_back(std::make_pair(k, rb));
+                entries.push_back(std::make_pair(rb, k));
+            }
+            continue;
+        }
+        if (ra >= 0 && rb >= 0) {
+            entries.push_back(std::make_pair(rb, ra));
+            entries.push_back(std::make_pair(ra, rb));
+        }
+    }
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+    colPtr_.assign(n + 1, 0);
+    rowIdx_.resize(entries.size());
+    for (size_t p = 0; p < entries.size(); ++p) {
+        ++colPtr_[entries[p].first + 1];
+        rowIdx_[p] = entries[p].second;
+    }
+    for (int j = 0; j < n; ++j) colPtr_[j + 1] += colPtr_[j];
+
+    auto find = [this](int r, int c) -> int {
+        if (r < 0 || c < 0) return -1;
+        std::vector<int>::const_iterator first = rowIdx_.begin() + colPtr_[c];
+        std::vector<int>::const_iterator last = rowIdx_.begin() + colPtr_[c + 1];
+        return static_cast<int>(std::lower_bound(first, last, r) - rowIdx_.begin());
+    };
+    diagPos_.resize(nodes_);
+    for (int i = 0; i < nodes_; ++i) diagPos_[i] = find(i, i);
+    for (Element& e : elements_) {
+        int ra = e.a > 0 ? row(e.a) : -1;
+        int rb = e.b > 0 ? row(e.b) : -1;
+        if (e.kind == VOLTAGE_SOURCE) {
+            int k = nodes_ + e.branch;
+            e.pos[0] = find(ra, k);
+            e.pos[1] = find(k, ra);
+            e.pos[2] = find(rb, k);
+            e.pos[3] = find(k, rb);
+        } else {
+            e.pos[0] = find(ra, ra);
+            e.pos[1] = find(ra, rb);
+            e.pos[2] = find(rb, ra);
+            e.pos[3] = find(rb, rb);
+        }
+    }
+
+    Clock::time_point start = Clock::now();
+    lu_.analyze(n, colPtr_, rowIdx_);
+    stats_.analyzeMs = msSince(start);
+    ++stats_.analyses;
+    x_.assign(n, 0.0);
+    elemG_.assign(elements_.size(), 0.0);
+    factoredG_.assign(elements_.size(), 0.0);
+    z_.assign(elements_.size(), std::vector<double>());
+    cachedZ_.clear();
+    patternDirty_ = false;
+    baseDirty_ = true;
+}
+
+// Everything that does not depend on the timestep or operating point.
+void Circuit::assembleBase() {
+    base_.assign(rowIdx_.size(), 0.0);
+    baseRhs_.assign(unknowns(), 0.0);
+    for (int i = 0; i < nodes_; ++i) base_[diagPos_[i]] += GMIN;
+    for (size_t id = 0; id < elements_.size(); ++id) {
+        const Element& e = elements_[id];
+        elemG_[id] = 0.0;
+        switch (e.kind) {
+        case RESISTOR:
+        case AMMETER:
+        case VOLTMETER:
+            stampConductance(base_, id, 1.0 / e.value);
+            break;
+        case BATTERY:
+            stampConductance(base_, id, 1.0 / e.param);
+            stampCurrent(baseRhs_, e, -e.value / e.param);
+            break;
+        case CURRENT_SOURCE:
+            stampCurrent(baseRhs_, e, e.value);
+            break;
+        case VOLTAGE_SOURCE:
+            if (e.pos[0] >= 0) base_[e.pos[0]] += 1.0;
+            if (e.pos[1] >= 0) base_[e.pos[1]] += 1.0;
+            if (e.pos[2] >= 0) base_[e.pos[2]] -= 1.0;
+            if (e.pos[3] >= 0) base_[e.pos[3]] -= 1.0;
+            baseRhs_[nodes_ + e.branch] = e.value;
+            break;
+        default:
+            break;
+        }
+    }
+    baseDirty_ = false;
+}
+
+void Circuit::stampConductance(std::vector<double>& vals, int element, double g) {
+    const Element& e = elements_[element];
+    if (e.pos[0] >= 0) vals[e.pos[0]] += g;
+    if (e.pos[1] >= 0) vals[e.pos[1]] -= g;
+    if (e.pos[2] >= 0) vals[e.pos[2]] -= g;
+    if (e.pos[3] >= 0) vals[e.pos[3]] += g;
+    elemG_[element] = g;
+}
+
+// `amps` flowing through the element from a to b leaves node a.
+void Circuit::stampCurrent(std::vector<double>& rhs, const Element& e, double amps) const {
+    if (e.a > 0) rhs[row(e.a)] -= amps;
+    if (e.b > 0) rhs[row(e.b)] += amps;
+}
+
+double Circuit::elementVoltage(const Element& e, const std::vector<double>& x) const {
+    double va = e.a > 0 ? x[row(e.a)] : 0.0;
+    double vb = e.b > 0 ? x[row(e.b)] : 0.0;
+    return va - vb;
+}
+
+bool Circuit::factorize() {
+    Clock::time_point start = Clock::now();
+    bool ok = false;
+    if (lu_.factored()) {
+        ok = lu_.refactor(values_);
+        if (ok) ++stats_.refactorizations;
+    }
+    if (!ok) {
+        ok = lu_.factor(values_);
+        if (ok) ++stats_.factorizations;
+    }
+    stats_.factorMs += msSince(start);
+    if (!ok) {
+        error_ = "circuit matrix is singular";
+        return false;
+    }
+    factoredG_ = elemG_;
+    for (int id : cachedZ_) std::vector<double>().swap(z_[id]);
+    cachedZ_.clear();
+    return true;
+}
+
+// Solves (A0 + U D U^T) x = b given the factors of A0, where the columns
+// of U are the incidence vectors of the changed elements and D their
+// conductance changes:
+//   x = y - Z (D^-1 + U^T Z)^-1 U^T y,   y = A0^-1 b,  Z = A0^-1 U.
+// x holds b on entry. Returns false, leaving x undefined, if too many
+// elements changed or the result does not check out.
+bool Circuit::solveUpdated(std::vector<double>& x) {
+    changed_.clear();
+    for (size_t id = 0; id < elements_.size(); ++id) {
+        if (elemG_[id] != factoredG_[id]) {
+            if (static_cast<int>(changed_.size()) == maxRank_) return false;
+            changed_.push_back(static_cast<int>(id));
+        }
+    }
+    int k = static_cast<int>(changed_.size());
+    stats_.lastRank = k;
+    lu_.solve(x);
+    if (k == 0) return true;
+
+    int n = unknowns();
+    for (int id : changed_) {
+        if (!z_[id].empty()) continue;
+        const Element& e = elements_[id];
+        std::vector<double>& z = z_[id];
+        z.assign(n, 0.0);
+        if (e.a > 0) z[row(e.a)] += 1.0;
+        if (e.b > 0) z[row(e.b)] -= 1.0;
+        lu_.solve(z);
+        cachedZ_.push_back(id);
+    }
+
+    // Capacitance matrix M = D^-1 + U^T Z and t = U^T y, solved densely.
+    std::vector<double> m(k * k), t(k);
+    for (int i = 0; i < k; ++i) {
+        const Element& ei = elements_[changed_[i]];
+        for (int j = 0; j < k; ++j) m[i * k + j] = elementVoltage(ei, z_[changed_[j]]);
+        m[i * k + i] += 1.0 / (elemG_[changed_[i]] - factoredG_[changed_[i]]);
+        t[i] = elementVoltage(ei, x);
+    }
+    double largest = 0.0;
+    for (double v : m) largest = std::max(largest, std::fabs(v));
+    for (int c = 0; c < k; ++c) {
+        int p = c;
+        for (int r = c + 1; r < k; ++r) {
+            if (std::fabs(m[r * k + c]) > std::fabs(m[p * k + c])) p = r;
+        }
+        if (!(std::fabs(m[p * k + c]) > largest * 1e-13)) return false;
+        if (p != c) {
+            for (int j = 0; j < k; ++j) std::swap(m[p * k + j], m[c * k + j]);
+            std::swap(t[p], t[c]);
+        }
+        for (int r = c + 1; r < k; ++r) {
+            double f = m[r * k + c] / m[c * k + c];
+            if (f == 0.0) continue;
+            for (int j = c; j < k; ++j) m[r * k + j] -= f * m[c * k + j];
+            t[r] -= f * t[c];
+        }
+    }
+    for (int c = k - 1; c >= 0; --c) {
+        for (int j = c + 1; j < k; ++j) t[c] -= m[c * k + j] * t[j];
+        t[c] /= m[c * k + c];
+    }
+    for (int j = 0; j < k; ++j) {
+        const std::vector<double>& z = z_[changed_[j]];
+        for (int i = 0; i < n; ++i) x[i] -= t[j] * z[i];
+    }
+
+    // A large conductance change can cancel badly; check the residual
+    // against the assembled matrix before trusting the result.
+    double worst = 0.0, scale = 0.0;
+    for (int i = 0; i < n; ++i) scale = std::max(scale, std::fabs(rhs_[i]));
+    std::vector<double> res(rhs_);
+    for (int j = 0; j < n; ++j) {
+        double xj = x[j];
+        for (int p = colPtr_[j]; p < colPtr_[j + 1]; ++p) res[rowIdx_[p]] -= values_[p] * xj;
+    }
+    for (int i = 0; i < n; ++i) worst = std::max(worst, std::fabs(res[i]));
+    return worst <= 1e-9 * (1.0 + scale);
+}
+
+bool Circuit::solveLinear(std::vector<double>& x) {
+    x = rhs_;
+    if (lu_.factored() && maxRank_ > 0 && solveUpdated(x)) {
+        ++stats_.lowRankSolves;
+        return true;
+    }
+    if (!factorize()) return false;
+    stats_.lastRank = 0;
+    x = rhs_;
+    lu_.solve(x);
+    return true;
+}
+
+// dt == 0 solves for the DC operating point.
+bool Circuit::newton(double dt) {
+    if (patternDirty_) buildPattern();
+    if (baseDirty_) assembleBase();
+    stats_.newtonIterations = 0;
+    stats_.factorMs = 0.0;
+    error_.clear();
+    if (unknowns() == 0) return true;
+
+    std::vector<double> next;
+    for (int iter = 0; iter < MAX_NEWTON; ++iter) {
+        values_ = base_;
+        rhs_ = baseRhs_;
+        for (int id : capacitors_) {
+            const Element& e = elements_[id];
+            double geq = dt > 0.0 ? e.value / dt : 0.0;
+            stampConductance(values_, id, geq);
+            stampCurrent(rhs_, e, -geq * e.vPrev);
+        }
+        for (int id : diodes_) {
+            const Element& e = elements_[id];
+            double nvt = e.param * THERMAL_VOLTAGE;
+            double ex = std::exp(e.vd / nvt);
+            double gd = e.value * ex / nvt + GMIN;
+            double id0 = e.value * (ex - 1.0);
+            stampConductance(values_, id, gd);
+            stampCurrent(rhs_, e, id0 - gd * e.vd);
+        }
+
+        if (!solveLinear(next)) return false;
+        ++stats_.newtonIterations;
+        ++stats_.totalIterations;
+
+        bool converged = true;
+        for (size_t i = 0; i < next.size(); ++i) {
+            double tol = ABSTOL + RELTOL * std::max(std::fabs(next[i]), std::fabs(x_[i]));
+            if (std::fabs(next[i] - x_[i]) > tol) {
+                converged = false;
+                break;
+            }
+        }
+        x_.swap(next);
+
+        for (int id : diodes_) {
+            Element& e = elements_[id];
+            double nvt = e.param * THERMAL_VOLTAGE;
+            double v = elementVoltage(e, x_);
+            double limited = limitJunction(v, e.vd, nvt, criticalVoltage(nvt, e.value));
+            if (limited != v || std::fabs(limited - e.vd) > ABSTOL + RELTOL * std::fabs(limited)) converged = false;
+            e.vd = limited;
+        }
+        if (converged || diodes_.empty()) {
+            for (int id : diodes_) {
+                Element& e = elements_[id];
+                e.amps = e.value * (std::exp(e.vd / (e.param * THERMAL_VOLTAGE)) - 1.0);
+            }
+            return true;
+        }
+    }
+    error_ = "Newton iteration did not converge";
+    return false;
+}
+
+bool Circuit::solveDC() {
+    Clock::time_point start = Clock::now();
+    bool ok = newton(0.0);
+    if (ok) {
+        for (int id : capacitors_) elements_[id].amps = 0.0;
+    }
+    stats_.solveMs = msSince(start);
+    return ok;
+}
+
+bool Circuit::step(double dt) {
+    Clock::time_point start = Clock::now();
+    bool ok = dt > 0.0 && newton(dt);
+    if (ok) {
+        for (int id : capacitors_) {
+            Element& e = elements_[id];
+            double v = elementVoltage(e, x_);
+            e.amps = e.value / dt * (v - e.vPrev);
+            e.vPrev = v;
+        }
+        time_ += dt;
+    }
+    stats_.solveMs = msSince(start);
+    return ok;
+}
+
+void Circuit::resetTransient() {
+    for (int id : capacitors_) {
+        elements_[id].vPrev = 0.0;
+        elements_[id].amps = 0.0;
+    }
+    time_ = 0.0;
+}
+
+double Circuit::voltage(int node) const {
+    if (node <= 0 || row(node) >= static_cast<int>(x_.size())) return 0.0;
+    return x_[row(node)];
+}
+
+double Circuit::current(int element) const {
+    const Element& e = elements_[element];
+    if (x_.empty()) return 0.0;
+    switch (e.kind) {
+    case RESISTOR:
+    case AMMETER:
+    case VOLTMETER:
+        return elementVoltage(e, x_) / e.value;
+    case BATTERY:
+        return (elementVoltage(e, x_) - e.value) / e.param;
+    case VOLTAGE_SOURCE:
+        return x_[nodes_ + e.branch];
+    case CURRENT_SOURCE:
+        return e.value;
+    default:
+        return e.amps;
+    }
+}
+
+double Circuit::reading(int element) const {
+    const Element& e = elements_[element];
+    if (e.kind == VOLTMETER) return x_.empty() ? 0.0 : elementVoltage(e, x_);
+    return current(element);
+}
@@ -0,0 +1,186 @@
+#ifndef CIRCUITSIM_H
+#define CIRCUITSIM_H
+
+#include "SparseLU.h"
+#include <string>
+#include <vector>
+
+struct SolveStats {
+    int analyses;          // symbolic orderings (pattern changes)
+    int factorizations;    // full factorizations with pivot search
+    int refactorizations;  // numeric-only factorizations reusing the pattern
+    int lowRankSolves;     // solves done as an update of the existing factors
+    int lastRank;          // elements changed since the factors, in the last solve
+    int newtonIterations;  // in the last solve
+    int totalIterations;
+    double analyzeMs;
+    double factorMs;       // factor + refactor time in the last solve
+    double solveMs;        // wall time of the last solveDC() / step()
+};
+
+// Circuit simulation by modified nodal analysis.
+//
+// Unknowns are the node voltages (node 0 is ground and has none) plus one
+// branch current per ideal voltage source. Every element is stamped into a
+// sparse matrix whose nonzero pattern is fixed once the netlist is, so the
+// fill-reducing order and the L/U patterns are computed once and reused:
+// Newton iterations and timesteps only refactor the numbers.
+//
+// Apart from voltage sources, every element enters the matrix as a single
+// conductance g between its nodes, i.e. g * u * u^T with u = e_a - e_b.
+// When only a few elements' conductances differ from the ones the factors
+// were computed with (a part swapped by replace(), a diode moving along its
+// curve) the solve reuses the factors through the Woodbury identity: one
+// triangular solve per changed element, cached until the next
+// factorization, and a small dense system. Past setMaxUpdateRank() changed
+// elements, or if the updated solution fails a residual check, the matrix
+// is refactored instead.
+//
+// Diodes are linearized around their operating point each Newton iteration,
+// with SPICE-style junction voltage limiting to keep exp() in range.
+// Capacitors use the backward-Euler companion model (a conductance C/dt in
+// parallel with a current source carrying the previous step's charge) and
+// are open circuits in the DC solution. A small conductance from every node
+// to ground keeps floating parts of the circuit solvable.
+//
+// For every two-terminal element, current() is the current flowing through
+// it from terminal a to terminal b.
+class Circuit {
+public:
+    enum Kind { OPEN, RESISTOR, VOLTAGE_SOURCE, CURRENT_SOURCE, BATTERY, CAPACITOR, DIODE, AMMETER, VOLTMETER };
+
+    // What an element is, without its nodes.
+    struct Part {
+        Kind kind;
+        double value;     // ohms, volts, amps, farads or saturation current
+        double param;     // internal resistance, emission coefficient
+    };
+    // Conducts nothing; keeps a place in the matrix for a later replace().
+    static Part open() { return Part{OPEN, 0.0, 0.0}; }
+    static Part resistor(double ohms);
+    // Holds a at `volts` above b.
+    static Part voltageSource(double volts) { return Part{VOLTAGE_SOURCE, volts, 0.0}; }
+    // Drives `amps` out of the circuit at a and back in at b, i.e. through
+    // the source from a to b.
+    static Part currentSource(double amps) { return Part{CURRENT_SOURCE, amps, 0.0}; }
+    // Voltage source with internal resistance, a being the positive terminal.
+    // Stamped in Norton form, so it adds no branch current.
+    static Part battery(double volts, double internalOhms = 0.5);
+    static Part capacitor(double farads) { return Part{CAPACITOR, farads, 0.0}; }
+    static Part diode(double saturationAmps = 1e-14, double emission = 1.0) { return Part{DIODE, saturationAmps, emission}; }
+    // A diode whose knee sits around 2 V, like a red LED.
+    static Part led() { return diode(1e-20, 2.0); }
+    // Meters are ordinary elements: a 10 mOhm shunt and a 10 MOhm probe.
+    static Part ammeter() { return Part{AMMETER, 0.01, 0.0}; }
+    static Part voltmeter() { return Part{VOLTMETER, 1e7, 0.0}; }
+
+    Circuit();
+
+    void clear();
+    // Returns the new node's index; ground is node 0. Elements may also
+    // name nodes that were never added, which creates them.
+    int addNode();
+    int nodeCount() const { return nodes_; }
+
+    // Returns an element id.
+    int add(int a, int b, const Part& part);
+    int addResistor(int a, int b, double ohms) { return add(a, b, resistor(ohms)); }
+    int addVoltageSource(int a, int b, double volts) { return add(a, b, voltageSource(volts)); }
+    int addCurrentSource(int a, int b, double amps) { return add(a, b, currentSource(amps)); }
+    int addBattery(int a, int b, double volts, double internalOhms = 0.5) { return add(a, b, battery(volts, internalOhms)); }
+    int addCapacitor(int a, int b, double farads) { return add(a, b, capacitor(farads)); }
+    int addDiode(int anode, int cathode, double saturationAmps = 1e-14, double emission = 1.0) {
+        return add(anode, cathode, diode(saturationAmps, emission));
+    }
+    int addLed(int anode, int cathode) { return add(anode, cathode, led()); }
+    int addAmmeter(int a, int b) { return add(a, b, ammeter()); }
+    int addVoltmeter(int a, int b) { return add(a, b, voltmeter()); }
+
+    // Turns an element into another part between the same nodes. The matrix
+    // pattern is unchanged, so the next solve is a low-rank update of the
+    // current factors. Voltage sources own a branch row and cannot be
+    // swapped in or out; returns false for those.
+    bool replace(int element, const Part& part);
+
+    int elementCount() const { return static_cast<int>(elements_.size()); }
+    Kind kind(int element) const { return elements_[element].kind; }
+
+    // Operating point with capacitors open. Leaves the transient state
+    // (capacitor charges and time) alone.
+    bool solveDC();
+    // Advances the transient solution by dt seconds.
+    bool step(double dt);
+    // Discharges every capacitor and restarts the transient at t = 0.
+    void resetTransient();
+    double time() const { return time_; }
+
+    double voltage(int node) const;
+    double current(int element) const;
+    // Amps for an ammeter, volts for a voltmeter, otherwise current().
+    double reading(int element) const;
+
+    // 0 turns the low-rank updates off: every change refactors.
+    void setMaxUpdateRank(int rank) { maxRank_ = rank; }
+
+    const SolveStats& stats() const { return stats_; }
+    const std::string& error() const { return error_; }
+    int unknowns() const { return nodes_ + branches_; }
+    size_t factorNonzeros() const { return lu_.nnzL() + lu_.nnzU(); }
+
+private:
+    struct Element {
+        Kind kind;
+        int a, b;
+        double value;
+        double param;
+        int branch;       // voltage sources: index of the branch current
+        int pos[4];       // value slots for (a,a) (a,b) (b,a) (b,b), -1 at ground
+        double vd;        // diodes: limited junction voltage of the last iteration
+        double vPrev;     // capacitors: voltage at the previous timestep
+        double amps;      // diodes and capacitors: current at the last solution
+    };
+
+    void setPart(int element, const Part& part);
+    int row(int node) const { return node - 1; }
+    void buildPattern();
+    void assembleBase();
+    void stampConductance(std::vector<double>& vals, int element, double g);
+    void stampCurrent(std::vector<double>& rhs, const Element& e, double amps) const;
+    bool newton(double dt);
+    bool solveLinear(std::vector<double>& x);
+    bool solveUpdated(std::vector<double>& x);
+    bool factorize();
+    double elementVoltage(const Element& e, const std::vector<double>& x) const;
+
+    int nodes_;
+    int branches_;
+    std::vector<Element> elements_;
+    std::vector<int> diodes_;
+    std::vector<int> capacitors_;
+
+    bool patternDirty_;
+    bool baseDirty_;
+    std::vector<int> colPtr_;
+    std::vector<int> rowIdx_;
+    std::vector<int> diagPos_;      // (i,i) slot for every node row
+    std::vector<double> base_;      // linear, time-invariant part of the matrix
+    std::vector<double> baseRhs_;
+    std::vector<double> values_;
+    std::vector<double> rhs_;
+    std::vector<double> x_;
+    SparseLU lu_;
+
+    // Low-rank updates against the factored matrix.
+    int maxRank_;
+    std::vector<double> elemG_;     // conductance stamped by each element now
+    std::vector<double> factoredG_; // ... and when the factors were computed
+    std::vector<std::vector<double>> z_;   // A^-1 u per element, empty if not cached
+    std::vector<int> cachedZ_;
+    std::vector<int> changed_;
+
+    double time_;
+    SolveStats stats_;
+    std::string error_;
+};
+
+#endif
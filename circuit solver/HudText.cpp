@@ -0,0 +1,51 @@
+#include "HudText.h"
+#include <cstdio>
+#include <ostream>
+
+HudText::HudText(const FontCache& font)
+    : font_(font), frameLabels_(0), frameGlyphs_(0), frames_(0), totalLabels_(0), totalGlyphs_(0),
+      maxFrameGlyphs_(0) {}
+
+// One glyph per character that leaves ink: spaces only advance, and a
+// UTF-8 sequence draws as a single '?'.
+void HudText::count(const char* text) {
+    int glyphs = 0;
+    for (const unsigned char* p = reinterpret_cast<const unsigned char*>(text); *p; ++p) {
+        if (*p != ' ' && (*p & 0xC0) != 0x80) ++glyphs;
+    }
+    ++frameLabels_;
+    ++totalLabels_;
+    frameGlyphs_ += glyphs;
+    totalGlyphs_ += glyphs;
+}
+
+SDL_Rect HudText::draw(const char* text, SDL_Color color, int x, int y) {
+    count(text);
+    return font_.draw(text, color, x, y);
+}
+
+SDL_Rect HudText::draw(const std::string& text, SDL_Color color, int x, int y) {
+    return draw(text.c_str(), color, x, y);
+}
+
+SDL_Rect HudText::measure(const char* text) const {
+    return font_.measure(text);
+}
+
+SDL_Rect HudText::drawNumber(double value, int decimals, SDL_Color color, int x, int y) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+    return draw(buf, color, x, y);
+}
+
+void HudText::beginFrame() {
+    if (frames_ > 0 && frameGlyphs_ > maxFrameGlyphs_) maxFrameGlyphs_ = frameGlyphs_;
+    ++frames_;
+    frameLabels_ = 0;
+    frameGlyphs_ = 0;
+}
+
+void HudText::printReport(std::ostream& out) const {
+    out << "hud: " << frames_ << " frames, " << totalLabels_ << " labels and " << totalGlyphs_
+        << " glyphs drawn from the atlas (max " << maxFrameGlyphs_ << " glyphs in one frame), nothing rasterized\n";
+}
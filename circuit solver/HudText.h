@@ -0,0 +1,49 @@
+#ifndef HUDTEXT_H
+#define HUDTEXT_H
+
+#include "FontCache.h"
+#include <SDL2/SDL.h>
+#include <iosfwd>
+#include <string>
+
+// Text layer for the HUD. Every label and number is drawn glyph by glyph
+// from the font cache's atlas, tinted to its color, so no text is ever
+// rasterized or uploaded while the game runs: a label whose text changes
+// every frame costs the same as one that never does.
+//
+// Every label and glyph drawn is counted, so the HUD's per-frame cost can
+// be shown and reported.
+class HudText {
+public:
+    explicit HudText(const FontCache& font);
+
+    // Draws `text` at (x, y) and returns the area it covers.
+    SDL_Rect draw(const char* text, SDL_Color color, int x, int y);
+    SDL_Rect draw(const std::string& text, SDL_Color color, int x, int y);
+    SDL_Rect measure(const char* text) const;
+    // Draws `value` with `decimals` digits after the point.
+    SDL_Rect drawNumber(double value, int decimals, SDL_Color color, int x, int y);
+
+    // Call at the start of every frame.
+    void beginFrame();
+    int frameLabels() const { return frameLabels_; }
+    int frameGlyphs() const { return frameGlyphs_; }
+    void printReport(std::ostream& out) const;
+
+private:
+    HudText(const HudText&);
+    HudText& operator=(const HudText&);
+
+    void count(const char* text);
+
+    const FontCache& font_;
+
+    int frameLabels_;
+    int frameGlyphs_;
+    unsigned long long frames_;
+    unsigned long long totalLabels_;
+    unsigned long long totalGlyphs_;
+    int maxFrameGlyphs_;
+};
+
+#endif
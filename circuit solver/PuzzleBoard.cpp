@@ -0,0 +1,241 @@
+#include "PuzzleBoard.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// ---------------------------------------------------------------------------
+// SpatialHash
+
+int SpatialHash::cellOf(int v) const {
+    // Floor division so negative coordinates land in their own cells.
+    return v >= 0 ? v / cellSize_ : -((-v + cellSize_ - 1) / cellSize_);
+}
+
+long long SpatialHash::key(int cx, int cy) const {
+    return (static_cast<long long>(cx) << 32) ^ static_cast<unsigned int>(cy);
+}
+
+void SpatialHash::insert(int id, const SDL_Rect& r) {
+    for (int cy = cellOf(r.y); cy <= cellOf(r.y + r.h - 1); ++cy) {
+        for (int cx = cellOf(r.x); cx <= cellOf(r.x + r.w - 1); ++cx) {
+            cells_[key(cx, cy)].push_back(id);
+        }
+    }
+}
+
+void SpatialHash::remove(int id, const SDL_Rect& r) {
+    for (int cy = cellOf(r.y); cy <= cellOf(r.y + r.h - 1); ++cy) {
+        for (int cx = cellOf(r.x); cx <= cellOf(r.x + r.w - 1); ++cx) {
+            auto it = cells_.find(key(cx, cy));
+            if (it == cells_.end()) continue;
+            std::vector<int>& ids = it->second;
+            ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+            if (ids.empty()) cells_.erase(it);
+        }
+    }
+}
+
+void SpatialHash::move(int id, const SDL_Rect& from, const SDL_Rect& to) {
+    if (cellOf(from.x) == cellOf(to.x) && cellOf(from.y) == cellOf(to.y) &&
+        cellOf(from.x + from.w - 1) == cellOf(to.x + to.w - 1) &&
+        cellOf(from.y + from.h - 1) == cellOf(to.y + to.h - 1)) {
+        return;
+    }
+    remove(id, from);
+    insert(id, to);
+}
+
+const std::vector<int>* SpatialHash::query(int x, int y) const {
+    auto it = cells_.find(key(cellOf(x), cellOf(y)));
+    return it == cells_.end() ? nullptr : &it->second;
+}
+
+// ---------------------------------------------------------------------------
+// PuzzleBoard
+
+namespace {
+
+bool contains(const SDL_Rect& r, int x, int y) {
+    return x > r.x && x < r.x + r.w && y > r.y && y < r.y + r.h;
+}
+
+}
+
+PuzzleBoard::PuzzleBoard(int snapRadius)
+    : snapRadius_(snapRadius), pieceHash_(64), slotHash_(2 * snapRadius),
+      dragged_(-1), grabDx_(0), grabDy_(0), correct_(0) {}
+
+void PuzzleBoard::clear() {
+    slots_.clear();
+    pieces_.clear();
+    order_.clear();
+    zIndex_.clear();
+    pieceHash_.clear();
+    slotHash_.clear();
+    kindNames_.clear();
+    kindIds_.clear();
+    dragged_ = -1;
+    correct_ = 0;
+}
+
+int PuzzleBoard::kindId(const std::string& name) {
+    auto it = kindIds_.find(name);
+    if (it != kindIds_.end()) return it->second;
+    int id = static_cast<int>(kindNames_.size());
+    kindNames_.push_back(name);
+    kindIds_[name] = id;
+    return id;
+}
+
+bool PuzzleBoard::loadLayout(const std::string& path) {
+    std::ifstream in(path.c_str());
+    if (!in) return false;
+
+    clear();
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        std::istringstream ss(line);
+        std::string what, kind;
+        SDL_Rect r = {0, 0, 64, 64};
+        if (!(ss >> what)) continue;
+        // Other entries in the file belong to other readers (the netlist).
+        if (what != "slot" && what != "piece") continue;
+        if (!(ss >> kind >> r.x >> r.y)) {
+            std::cerr << path << ":" << lineNo << ": expected '" << what << " <kind> <x> <y> [w h]'\n";
+            continue;
+        }
+        int w, h;
+        if (ss >> w >> h) {
+            r.w = w;
+            r.h = h;
+        } else if (what == "slot") {
+            r.w = r.h = 48;
+        }
+
+        if (what == "slot") addSlot(kind, r);
+        else addPiece(kind, r);
+    }
+    return !slots_.empty() && !pieces_.empty();
+}
+
+int PuzzleBoard::addSlot(const std::string& kind, const SDL_Rect& rect) {
+    int id = static_cast<int>(slots_.size());
+    BoardSlot s = {kindId(kind), rect, -1};
+    slots_.push_back(s);
+    // Indexed by the area a piece's corner must reach to snap here.
+    SDL_Rect area = {rect.x - snapRadius_, rect.y - snapRadius_, 2 * snapRadius_, 2 * snapRadius_};
+    slotHash_.insert(id, area);
+    return id;
+}
+
+int PuzzleBoard::addPiece(const std::string& kind, const SDL_Rect& rect) {
+    int id = static_cast<int>(pieces_.size());
+    BoardPiece p = {kindId(kind), rect, -1};
+    pieces_.push_back(p);
+    zIndex_.push_back(static_cast<int>(order_.size()));
+    order_.push_back(id);
+    pieceHash_.insert(id, rect);
+
+    // A piece laid out on a free slot starts snapped into it.
+    int slot = findSnapSlot(pieces_[id]);
+    if (slot >= 0 && slots_[slot].rect.x == rect.x && slots_[slot].rect.y == rect.y) {
+        pieces_[id].slot = slot;
+        slots_[slot].occupant = id;
+        if (slots_[slot].kind == pieces_[id].kind) ++correct_;
+    }
+    return id;
+}
+
+int PuzzleBoard::pieceAt(int x, int y) const {
+    const std::vector<int>* ids = pieceHash_.query(x, y);
+    if (!ids) return -1;
+    int best = -1;
+    for (int id : *ids) {
+        if (contains(pieces_[id].rect, x, y) && (best < 0 || zIndex_[id] > zIndex_[best])) best = id;
+    }
+    return best;
+}
+
+void PuzzleBoard::raise(int piece) {
+    int z = zIndex_[piece];
+    order_.erase(order_.begin() + z);
+    order_.push_back(piece);
+    for (size_t i = z; i < order_.size(); ++i) zIndex_[order_[i]] = static_cast<int>(i);
+}
+
+void PuzzleBoard::detach(int piece) {
+    BoardPiece& p = pieces_[piece];
+    if (p.slot < 0) return;
+    BoardSlot& s = slots_[p.slot];
+    if (s.kind == p.kind) --correct_;
+    s.occupant = -1;
+    p.slot = -1;
+}
+
+bool PuzzleBoard::beginDrag(int x, int y) {
+    int id = pieceAt(x, y);
+    if (id < 0) return false;
+    dragged_ = id;
+    grabDx_ = x - pieces_[id].rect.x;
+    grabDy_ = y - pieces_[id].rect.y;
+    detach(id);
+    raise(id);
+    return true;
+}
+
+void PuzzleBoard::dragTo(int x, int y) {
+    if (dragged_ < 0) return;
+    BoardPiece& p = pieces_[dragged_];
+    SDL_Rect moved = p.rect;
+    moved.x = x - grabDx_;
+    moved.y = y - grabDy_;
+    pieceHash_.move(dragged_, p.rect, moved);
+    p.rect = moved;
+}
+
+int PuzzleBoard::findSnapSlot(const BoardPiece& p) const {
+    const std::vector<int>* ids = slotHash_.query(p.rect.x, p.rect.y);
+    if (!ids) return -1;
+    int best = -1;
+    long long bestDist = LLONG_MAX;
+    for (int id : *ids) {
+        const BoardSlot& s = slots_[id];
+        if (s.occupant >= 0) continue;
+        int dx = p.rect.x - s.rect.x;
+        int dy = p.rect.y - s.rect.y;
+        if (std::abs(dx) >= snapRadius_ || std::abs(dy) >= snapRadius_) continue;
+        long long d = static_cast<long long>(dx) * dx + static_cast<long long>(dy) * dy;
+        if (d < bestDist) {
+            bestDist = d;
+            best = id;
+        }
+    }
+    return best;
+}
+
+bool PuzzleBoard::endDrag() {
+    if (dragged_ < 0) return false;
+    int id = dragged_;
+    dragged_ = -1;
+
+    BoardPiece& p = pieces_[id];
+    int slot = findSnapSlot(p);
+    if (slot < 0) return false;
+
+    SDL_Rect snapped = p.rect;
+    snapped.x = slots_[slot].rect.x;
+    snapped.y = slots_[slot].rect.y;
+    pieceHash_.move(id, p.rect, snapped);
+    p.rect = snapped;
+    p.slot = slot;
+    slots_[slot].occupant = id;
+    if (slots_[slot].kind == p.kind) ++correct_;
+    return true;
+}
@@ -0,0 +1,109 @@
+#ifndef PUZZLEBOARD_H
+#define PUZZLEBOARD_H
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Uniform grid over the board. Each cell lists the ids whose rectangle
+// overlaps it, so a point query only looks at the handful of items in one
+// cell instead of scanning everything on the board.
+class SpatialHash {
+public:
+    explicit SpatialHash(int cellSize = 64) : cellSize_(cellSize) {}
+
+    void insert(int id, const SDL_Rect& r);
+    void remove(int id, const SDL_Rect& r);
+    // Cheap when the rectangle stays within the same cells, as it does for
+    // most mouse-motion steps.
+    void move(int id, const SDL_Rect& from, const SDL_Rect& to);
+    void clear() { cells_.clear(); }
+    // Ids whose cells contain (x, y); callers still test the exact rectangle.
+    const std::vector<int>* query(int x, int y) const;
+
+private:
+    long long key(int cx, int cy) const;
+    int cellOf(int v) const;
+
+    int cellSize_;
+    std::unordered_map<long long, std::vector<int>> cells_;
+};
+
+struct BoardSlot {
+    int kind;
+    SDL_Rect rect;
+    int occupant;  // piece id, or -1
+};
+
+struct BoardPiece {
+    int kind;
+    SDL_Rect rect;
+    int slot;      // slot id it is snapped to, or -1
+};
+
+// Drag-and-drop board for the circuit puzzle. Pieces are picked and slots
+// found through spatial hashes, a released piece snaps into the nearest
+// free slot within range, and the solved state is kept as a running count
+// of correctly filled slots that only changes on pick-up and drop.
+class PuzzleBoard {
+public:
+    explicit PuzzleBoard(int snapRadius = 40);
+
+    // Layout file, one entry per line ('#' starts a comment):
+    //   slot  <kind> <x> <y> [w h]
+    //   piece <kind> <x> <y> [w h]
+    // Lines starting with any other word are skipped.
+    bool loadLayout(const std::string& path);
+    void clear();
+
+    int addSlot(const std::string& kind, const SDL_Rect& rect);
+    int addPiece(const std::string& kind, const SDL_Rect& rect);
+
+    // Topmost piece under the point, or -1.
+    int pieceAt(int x, int y) const;
+
+    bool beginDrag(int x, int y);
+    void dragTo(int x, int y);
+    // Drops the dragged piece, snapping it into a slot if one is in range.
+    // Returns true if the piece ended up in a slot.
+    bool endDrag();
+    bool dragging() const { return dragged_ >= 0; }
+    // Slot the dragged piece would snap into if dropped now, or -1.
+    int snapTarget() const { return dragged_ < 0 ? -1 : findSnapSlot(pieces_[dragged_]); }
+    int draggedPiece() const { return dragged_; }
+
+    bool solved() const { return !slots_.empty() && correct_ == static_cast<int>(slots_.size()); }
+    int correctCount() const { return correct_; }
+
+    const std::vector<BoardSlot>& slots() const { return slots_; }
+    const std::vector<BoardPiece>& pieces() const { return pieces_; }
+    // Piece ids from bottom to top.
+    const std::vector<int>& drawOrder() const { return order_; }
+
+    const std::string& kindName(int kind) const { return kindNames_[kind]; }
+    int kindCount() const { return static_cast<int>(kindNames_.size()); }
+
+private:
+    int kindId(const std::string& name);
+    void detach(int piece);
+    int findSnapSlot(const BoardPiece& p) const;
+    void raise(int piece);
+
+    int snapRadius_;
+    std::vector<BoardSlot> slots_;
+    std::vector<BoardPiece> pieces_;
+    std::vector<int> order_;
+    std::vector<int> zIndex_;   // position of each piece in order_
+    SpatialHash pieceHash_;
+    SpatialHash slotHash_;      // slots indexed by their snap area
+
+    std::vector<std::string> kindNames_;
+    std::unordered_map<std::string, int> kindIds_;
+
+    int dragged_;
+    int grabDx_, grabDy_;
+    int correct_;
+};
+
+#endif
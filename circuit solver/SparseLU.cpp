@@ -0,0 +1,310 @@
+#include "SparseLU.h"
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <utility>
+
+SparseLU::SparseLU() : n_(0), pivotTol_(0.001), factored_(false) {}
+
+void SparseLU::analyze(int n, const std::vector<int>& colPtr, const std::vector<int>& rowIdx) {
+    n_ = n;
+    colPtr_ = colPtr;
+    rowIdx_ = rowIdx;
+    q_.assign(n, 0);
+    pinv_.assign(n, -1);
+    xi_.assign(2 * n, 0);
+    mark_.assign(n, 0);
+    work_.assign(n, 0.0);
+    factored_ = false;
+    minimumDegreeOrder();
+}
+
+// Approximate minimum degree on the quotient graph of A + A^T. Eliminated
+// variables become elements (cliques stored as member lists) rather than
+// adding fill edges, and each variable's degree is bounded from its
+// remaining variable neighbours plus the part of each adjacent element that
+// is outside the newest one, as in AMD.
+void SparseLU::minimumDegreeOrder() {
+    enum { VARIABLE, ELEMENT, ABSORBED };
+    int n = n_;
+    std::vector<std::vector<int>> varAdj(n), elemAdj(n), elemVars(n);
+    for (int j = 0; j < n; ++j) {
+        for (int p = colPtr_[j]; p < colPtr_[j + 1]; ++p) {
+            int i = rowIdx_[p];
+            if (i == j) continue;
+            varAdj[i].push_back(j);
+            varAdj[j].push_back(i);
+        }
+    }
+
+    std::vector<int> status(n, VARIABLE), degree(n), w(n, -1), inLp(n, 0);
+    std::set<std::pair<int, int>> queue;
+    for (int i = 0; i < n; ++i) {
+        std::vector<int>& a = varAdj[i];
+        std::sort(a.begin(), a.end());
+        a.erase(std::unique(a.begin(), a.end()), a.end());
+        degree[i] = static_cast<int>(a.size());
+        queue.insert(std::make_pair(degree[i], i));
+    }
+
+    std::vector<int> Lp, touched;
+    for (int k = 0; k < n; ++k) {
+        int p = queue.begin()->second;
+        queue.erase(queue.begin());
+        q_[k] = p;
+        status[p] = ELEMENT;
+
+        // The new element's members: p's variable neighbours plus the
+        // members of every element p belonged to, which it absorbs.
+        Lp.clear();
+        for (int v : varAdj[p]) {
+            if (status[v] == VARIABLE && !inLp[v]) {
+                inLp[v] = 1;
+                Lp.push_back(v);
+            }
+        }
+        for (int e : elemAdj[p]) {
+            if (status[e] != ELEMENT) continue;
+            for (int v : elemVars[e]) {
+                if (status[v] == VARIABLE && !inLp[v]) {
+                    inLp[v] = 1;
+                    Lp.push_back(v);
+                }
+            }
+            status[e] = ABSORBED;
+            std::vector<int>().swap(elemVars[e]);
+        }
+        std::vector<int>().swap(varAdj[p]);
+        std::vector<int>().swap(elemAdj[p]);
+        elemVars[p] = Lp;
+
+        // w[e] = |Le \ Lp| for every element next to a member of Lp.
+        touched.clear();
+        for (int i : Lp) {
+            for (int e : elemAdj[i]) {
+                if (status[e] != ELEMENT || e == p) continue;
+                if (w[e] < 0) {
+                    w[e] = static_cast<int>(elemVars[e].size());
+                    touched.push_back(e);
+                }
+                --w[e];
+            }
+        }
+
+        int remaining = n - k - 1;
+        int lpSize = static_cast<int>(Lp.size());
+        for (int i : Lp) {
+            std::vector<int>& ea = elemAdj[i];
+            size_t out = 0;
+            int deg = lpSize - 1;
+            for (int e : ea) {
+                if (status[e] != ELEMENT || e == p) continue;
+                if (w[e] == 0) {
+                    // Every member is already in Lp, so p covers it.
+                    status[e] = ABSORBED;
+                    continue;
+                }
+                deg += w[e];
+                ea[out++] = e;
+            }
+            ea.resize(out);
+            ea.push_back(p);
+
+            std::vector<int>& va = varAdj[i];
+            out = 0;
+            for (int v : va) {
+                if (status[v] == VARIABLE && !inLp[v]) va[out++] = v;
+            }
+            va.resize(out);
+            deg += static_cast<int>(out);
+
+            deg = std::min(deg, remaining);
+            if (deg != degree[i]) {
+                queue.erase(std::make_pair(degree[i], i));
+                degree[i] = deg;
+                queue.insert(std::make_pair(deg, i));
+            }
+        }
+
+        for (int e : touched) {
+            w[e] = -1;
+            if (status[e] == ABSORBED) std::vector<int>().swap(elemVars[e]);
+        }
+        for (int v : Lp) inLp[v] = 0;
+    }
+}
+
+// Depth-first search from row j through the columns of L finished so far,
+// pushing rows onto xi_[top..] in reverse postorder.
+int SparseLU::dfs(int j, int top, int stamp) {
+    int* stack = &xi_[0];
+    int* pstack = &xi_[n_];
+    int head = 0;
+    stack[0] = j;
+    while (head >= 0) {
+        j = stack[head];
+        int jnew = pinv_[j];
+        if (mark_[j] != stamp) {
+            mark_[j] = stamp;
+            pstack[head] = jnew < 0 ? 0 : Lp_[jnew] + 1;
+        }
+        bool done = true;
+        int end = jnew < 0 ? 0 : Lp_[jnew + 1];
+        for (int p = pstack[head]; p < end; ++p) {
+            int i = Li_[p];
+            if (mark_[i] == stamp) continue;
+            pstack[head] = p + 1;
+            stack[++head] = i;
+            done = false;
+            break;
+        }
+        if (done) {
+            --head;
+            xi_[--top] = j;
+        }
+    }
+    return top;
+}
+
+// Nonzero pattern of L \ A(:, col), in an order that is safe to solve in.
+int SparseLU::reach(int col, int stamp) {
+    int top = n_;
+    for (int p = colPtr_[col]; p < colPtr_[col + 1]; ++p) {
+        if (mark_[rowIdx_[p]] != stamp) top = dfs(rowIdx_[p], top, stamp);
+    }
+    return top;
+}
+
+bool SparseLU::factor(const std::vector<double>& values) {
+    int n = n_;
+    factored_ = false;
+    std::fill(pinv_.begin(), pinv_.end(), -1);
+    std::fill(mark_.begin(), mark_.end(), 0);
+    Lp_.assign(n + 1, 0);
+    Up_.assign(n + 1, 0);
+    Li_.clear();
+    Lx_.clear();
+    Ui_.clear();
+    Ux_.clear();
+    std::vector<double>& x = work_;
+    std::fill(x.begin(), x.end(), 0.0);
+
+    for (int k = 0; k < n; ++k) {
+        int col = q_[k];
+        Lp_[k] = static_cast<int>(Li_.size());
+        Up_[k] = static_cast<int>(Ui_.size());
+
+        // Sparse triangular solve x = L \ A(:, col).
+        int top = reach(col, k + 1);
+        for (int p = top; p < n; ++p) x[xi_[p]] = 0.0;
+        for (int p = colPtr_[col]; p < colPtr_[col + 1]; ++p) x[rowIdx_[p]] += values[p];
+        for (int p = top; p < n; ++p) {
+            int j = xi_[p];
+            int J = pinv_[j];
+            if (J < 0) continue;
+            double xj = x[j];
+            for (int q = Lp_[J] + 1; q < Lp_[J + 1]; ++q) x[Li_[q]] -= Lx_[q] * xj;
+        }
+
+        // Rows already pivoted go to U; the largest remaining one is the pivot.
+        int ipiv = -1;
+        double best = -1.0;
+        for (int p = top; p < n; ++p) {
+            int i = xi_[p];
+            if (pinv_[i] < 0) {
+                double a = std::fabs(x[i]);
+                if (a > best) {
+                    best = a;
+                    ipiv = i;
+                }
+            } else {
+                Ui_.push_back(pinv_[i]);
+                Ux_.push_back(x[i]);
+            }
+        }
+        if (ipiv < 0 || best <= 0.0 || !std::isfinite(best)) return false;
+        if (pinv_[col] < 0 && mark_[col] == k + 1 && std::fabs(x[col]) >= best * pivotTol_) ipiv = col;
+
+        double pivot = x[ipiv];
+        Ui_.push_back(k);
+        Ux_.push_back(pivot);
+        pinv_[ipiv] = k;
+        Li_.push_back(ipiv);
+        Lx_.push_back(1.0);
+        for (int p = top; p < n; ++p) {
+            int i = xi_[p];
+            if (pinv_[i] < 0) {
+                Li_.push_back(i);
+                Lx_.push_back(x[i] / pivot);
+            }
+            x[i] = 0.0;
+        }
+    }
+    Lp_[n] = static_cast<int>(Li_.size());
+    Up_[n] = static_cast<int>(Ui_.size());
+
+    // From here on L is indexed by pivot step like U.
+    for (int& i : Li_) i = pinv_[i];
+    factored_ = true;
+    return true;
+}
+
+bool SparseLU::refactor(const std::vector<double>& values) {
+    if (!factored_) return false;
+    int n = n_;
+    std::vector<double>& x = work_;
+
+    for (int k = 0; k < n; ++k) {
+        int col = q_[k];
+        for (int p = colPtr_[col]; p < colPtr_[col + 1]; ++p) x[pinv_[rowIdx_[p]]] += values[p];
+
+        int uEnd = Up_[k + 1] - 1;
+        for (int p = Up_[k]; p < uEnd; ++p) {
+            int j = Ui_[p];
+            double xj = x[j];
+            Ux_[p] = xj;
+            x[j] = 0.0;
+            for (int q = Lp_[j] + 1; q < Lp_[j + 1]; ++q) x[Li_[q]] -= Lx_[q] * xj;
+        }
+
+        double pivot = x[k];
+        x[k] = 0.0;
+        double largest = 0.0;
+        for (int p = Lp_[k] + 1; p < Lp_[k + 1]; ++p) largest = std::max(largest, std::fabs(x[Li_[p]]));
+        if (pivot == 0.0 || !std::isfinite(pivot) || std::fabs(pivot) < largest * pivotTol_) {
+            std::fill(x.begin(), x.end(), 0.0);
+            factored_ = false;
+            return false;
+        }
+        Ux_[uEnd] = pivot;
+        for (int p = Lp_[k] + 1; p < Lp_[k + 1]; ++p) {
+            Lx_[p] = x[Li_[p]] / pivot;
+            x[Li_[p]] = 0.0;
+        }
+    }
+    return true;
+}
+
+void SparseLU::solve(std::vector<double>& b) const {
+    int n = n_;
+    std::vector<double>& y = work_;
+    for (int i = 0; i < n; ++i) y[pinv_[i]] = b[i];
+
+    for (int j = 0; j < n; ++j) {
+        double yj = y[j];
+        if (yj == 0.0) continue;
+        for (int p = Lp_[j] + 1; p < Lp_[j + 1]; ++p) y[Li_[p]] -= Lx_[p] * yj;
+    }
+    for (int j = n - 1; j >= 0; --j) {
+        int diag = Up_[j + 1] - 1;
+        y[j] /= Ux_[diag];
+        double yj = y[j];
+        if (yj == 0.0) continue;
+        for (int p = Up_[j]; p < diag; ++p) y[Ui_[p]] -= Ux_[p] * yj;
+    }
+
+    for (int k = 0; k < n; ++k) {
+        b[q_[k]] = y[k];
+        y[k] = 0.0;
+    }
+}
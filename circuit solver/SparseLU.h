@@ -0,0 +1,67 @@
+#ifndef SPARSELU_H
+#define SPARSELU_H
+
+#include <cstddef>
+#include <vector>
+
+// Sparse LU factorization for the circuit matrix, P*A*Q = L*U.
+//
+// analyze() picks a fill-reducing column order (approximate minimum degree
+// on the pattern of A + A^T). factor() runs a left-looking Gilbert-Peierls
+// factorization with partial pivoting, preferring the diagonal. Once that
+// has run, refactor() recomputes the numbers for a matrix with the same
+// pattern by reusing the pivot order and the L/U patterns, so it skips the
+// graph searches and pivot choice; it fails if a reused pivot has become
+// too small, and the caller falls back to factor().
+//
+// Matrices are compressed sparse column: column j holds rows
+// rowIdx[colPtr[j] .. colPtr[j+1]-1] with the matching values.
+class SparseLU {
+public:
+    SparseLU();
+
+    void analyze(int n, const std::vector<int>& colPtr, const std::vector<int>& rowIdx);
+    bool factor(const std::vector<double>& values);
+    bool refactor(const std::vector<double>& values);
+    bool factored() const { return factored_; }
+
+    // Solves A x = b in place.
+    void solve(std::vector<double>& b) const;
+
+    int size() const { return n_; }
+    size_t nnzL() const { return Li_.size(); }
+    size_t nnzU() const { return Ui_.size(); }
+
+    // Partial pivoting keeps the diagonal unless another row is larger by
+    // more than 1 / pivotTolerance.
+    void setPivotTolerance(double tol) { pivotTol_ = tol; }
+
+private:
+    void minimumDegreeOrder();
+    int reach(int col, int stamp);
+    int dfs(int j, int top, int stamp);
+
+    int n_;
+    std::vector<int> colPtr_;
+    std::vector<int> rowIdx_;
+
+    std::vector<int> q_;      // column order
+    std::vector<int> pinv_;   // row -> pivot step, -1 before it is chosen
+
+    // L: unit lower triangular, diagonal stored first in each column.
+    // U: diagonal stored last in each column, off-diagonals in an order in
+    // which they can be computed (topological order of the reach).
+    std::vector<int> Lp_, Li_;
+    std::vector<double> Lx_;
+    std::vector<int> Up_, Ui_;
+    std::vector<double> Ux_;
+
+    std::vector<int> xi_;     // reach stack and DFS scratch
+    std::vector<int> mark_;
+    mutable std::vector<double> work_;
+
+    double pivotTol_;
+    bool factored_;
+};
+
+#endif
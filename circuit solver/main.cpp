@@ -8,26 +8,105 @@
 #include <sstream>
 #include <iostream>
 #include <cmath>
+#include <cstdio>
+#include <algorithm>
+#include <memory>
+#include "PuzzleBoard.h"
+#include "CircuitPuzzle.h"
+#include "FontCache.h"
+#include "HudText.h"
+#include "TextField.h"
+#include "LevelPack.h"
+#include "SpriteAtlas.h"
+#include "AllocTracker.h"
 
 const int WIN_W = 800, WIN_H = 600;
-const int COMP_COUNT = 6;
-const SDL_Point targetSlots[COMP_COUNT] = {
-    {124, 457}, {530, 178}, {534, 282}, {433,494 }, {536, 452}, {125, 305}, 
-};
-const char* fileNames[COMP_COUNT] = {
-    "battery.png",
-    "resistor.png",
-    "capacitor.png",
-    "diode.png",
-    "voltmeter.png",
-    "ammeter.png"
-};
-
-bool isNear(int x1, int y1, int x2, int y2, int range = 40) {
-    return (std::abs(x1 - x2) < range && std::abs(y1 - y2) < range);
+// Built from ../levels/src by `make -C ../levels`; LEVEL_PACK overrides it.
+const char* LEVEL_PACK_PATH = "../levels/levels.pak";
+const char* ATLAS_PATH = "../atlas/out/circuit.atlas";
+
+
+// Used when circuit_layout.txt is missing.
+void loadDefaultLayout(PuzzleBoard& board, CircuitPuzzle& circuit) {
+    const char* kinds[] = {"battery", "resistor", "capacitor", "diode", "voltmeter", "ammeter"};
+    const SDL_Point slots[] = {{124, 457}, {530, 178}, {534, 282}, {433, 494}, {536, 452}, {125, 305}};
+    board.clear();
+    for (int i = 0; i < 6; ++i) {
+        board.addSlot(kinds[i], {slots[i].x, slots[i].y, 48, 48});
+        board.addPiece(kinds[i], {100 + i * 100, 400, 64, 64});
+    }
+
+    // battery(+) 1 - ammeter - 2 - resistor - 3 - diode - 4 - LED - ground,
+    // capacitor from 3 and voltmeter from 4 to ground.
+    const int nets[][2] = {{1, 0}, {2, 3}, {3, 0}, {3, 4}, {4, 0}, {1, 2}};
+    circuit.clear();
+    for (int i = 0; i < 6; ++i) circuit.setNet(i, nets[i][0], nets[i][1]);
+    circuit.addFixed("led", 4, 0);
+    circuit.expect("led", 0.005, 0.040);
+    circuit.expect("ammeter", 0.005, 0.040);
+    circuit.expect("voltmeter", 1.8, 2.6);
+}
+
+std::vector<std::string> splitWords(const std::string& text) {
+    std::istringstream in(text);
+    std::vector<std::string> words;
+    std::string w;
+    while (in >> w) words.push_back(w);
+    return words;
+}
+
+SDL_Rect rectAt(const double* v) {
+    return SDL_Rect{(int)v[0], (int)v[1], (int)v[2], (int)v[3]};
+}
+
+// First circuit level of the pack. levelc has checked that every list has
+// the right length, so the numbers are read straight from the mapping.
+bool loadPackedLayout(const LevelPack& pack, PuzzleBoard& board, CircuitPuzzle& circuit) {
+    std::vector<size_t> ids = pack.levelsOfKind("circuit");
+    if (ids.empty()) return false;
+    size_t id = ids[0], count = 0;
+
+    board.clear();
+    std::vector<std::string> slots = splitWords(pack.text(id, "slotKinds"));
+    const double* rects = pack.numbers(id, "slotRects", count);
+    for (size_t i = 0; i < slots.size() && 4 * i + 3 < count; ++i) board.addSlot(slots[i], rectAt(rects + 4 * i));
+    std::vector<std::string> pieces = splitWords(pack.text(id, "pieceKinds"));
+    rects = pack.numbers(id, "pieceRects", count);
+    for (size_t i = 0; i < pieces.size() && 4 * i + 3 < count; ++i) board.addPiece(pieces[i], rectAt(rects + 4 * i));
+
+    circuit.clear();
+    const double* nets = pack.numbers(id, "nets", count);
+    for (size_t i = 0; 2 * i + 1 < count; ++i) circuit.setNet((int)i, (int)nets[2 * i], (int)nets[2 * i + 1]);
+    std::vector<std::string> fixed = splitWords(pack.text(id, "fixedKinds"));
+    nets = pack.numbers(id, "fixedNets", count);
+    for (size_t i = 0; i < fixed.size() && 2 * i + 1 < count; ++i) {
+        circuit.addFixed(fixed[i], (int)nets[2 * i], (int)nets[2 * i + 1]);
+    }
+    std::vector<std::string> valued = splitWords(pack.text(id, "valueKinds"));
+    const double* values = pack.numbers(id, "values", count);
+    for (size_t i = 0; i < valued.size() && i < count; ++i) circuit.setValue(valued[i], values[i]);
+    std::vector<std::string> expected = splitWords(pack.text(id, "expectKinds"));
+    const double* ranges = pack.numbers(id, "expectRanges", count);
+    for (size_t i = 0; i < expected.size() && 2 * i + 1 < count; ++i) {
+        circuit.expect(expected[i], ranges[2 * i], ranges[2 * i + 1]);
+    }
+    return true;
+}
+
+// A sprite per piece kind (named after the kind, from <kind>.png when the
+// atlas doesn't have it), plus the LED.
+void loadKindSprites(SpriteAtlas& sprites, const PuzzleBoard& board, std::vector<int>& kindSprite, int& ledSprite) {
+    sprites.clear();
+    kindSprite.assign(board.kindCount(), -1);
+    for (int k = 0; k < board.kindCount(); ++k) {
+        kindSprite[k] = sprites.add(board.kindName(k), board.kindName(k) + ".png");
+    }
+    ledSprite = sprites.add("led", "led.png");
 }
 
 int main(int argc, char* argv[]) {
+    ALLOC_TRACK_START("circuit solver");
+    ALLOC_TRACK_SDL();
     if (SDL_Init(SDL_INIT_VIDEO) != 0) {
         std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
         return 1;
@@ -53,48 +132,56 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    TTF_Font* font = TTF_OpenFont("arial.ttf", 24);
-    if (!font) {
-        std::cerr << "TTF_OpenFont Error: " << TTF_GetError() << std::endl;
-        return 1;
-    }
+    // The HUD's glyphs come from the font cache after the first run; the
+    // TTF font itself is only opened for the key field.
+    FontCache font(ren);
+    if (!font.open("arial.ttf", 24)) return 1;
+    font.printReport(std::cout);
 
     SDL_Texture* background = IMG_LoadTexture(ren, "background.png");
-    SDL_Texture* ledTex = IMG_LoadTexture(ren, "led.png");
-    SDL_Texture* compTex[COMP_COUNT];
-    for (int i = 0; i < COMP_COUNT; ++i) {
-        compTex[i] = IMG_LoadTexture(ren, fileNames[i]);
-        if (!compTex[i]) {
-            std::cerr << "IMG_LoadTexture Error for " << fileNames[i] << ": " << IMG_GetError() << std::endl;
-        }
-    }
 
-    struct Comp { SDL_Rect rect; bool placed; };
-    std::vector<Comp> comps(COMP_COUNT);
-    for (int i = 0; i < COMP_COUNT; ++i) {
-        comps[i].rect = {100 + i * 100, 400, 64, 64};
-        comps[i].placed = false;
+    // The level pack comes first, then circuit_layout.txt, then the
+    // built-in layout.
+    PuzzleBoard board;
+    CircuitPuzzle circuit;
+    LevelPack pack;
+    bool packed = pack.open(LevelPack::defaultPath(LEVEL_PACK_PATH)) && loadPackedLayout(pack, board, circuit);
+    if (!packed && (!board.loadLayout("circuit_layout.txt") || !circuit.loadLayout("circuit_layout.txt"))) {
+        loadDefaultLayout(board, circuit);
     }
+    circuit.build(board);
 
     bool quit = false;
     bool paused = false, solved = false;
-    bool dragging = false;
-    int dragged = -1;
-    int offsetX = 0, offsetY = 0;
     Uint32 startTicks = SDL_GetTicks();
     Uint32 pausedTicks = 0;
+    Uint32 lastTicks = startTicks;
+    Uint32 lastReloadCheck = startTicks;
     const int TIME_LIMIT = 60;
 
     std::string unlockKey;
     bool inputActive = false;
-    std::string userInput;
     std::string accessMsg;
+    bool showHudStats = false;
 
     SDL_Color white = {255,255,255,255};
     SDL_Color green = {0,255,0,255};
     SDL_Color red   = {255,0,0,255};
     SDL_Color black = {0,0,0,255};
 
+    // These hold textures, so they live in this block and are gone before
+    // the font and renderer are destroyed below.
+    {
+    HudText hud(font);
+    // Made when the puzzle is solved, the first time a key can be typed.
+    std::unique_ptr<TextField> keyField;
+    // Every piece and the LED come from one texture, so they draw as one batch
+    SpriteAtlas sprites(ren);
+    sprites.load(ATLAS_PATH);
+    std::vector<int> kindSprite;
+    int ledSprite;
+    loadKindSprites(sprites, board, kindSprite, ledSprite);
+
     std::srand((unsigned)std::time(nullptr));
     SDL_StartTextInput();
     inputActive = false;
@@ -115,47 +202,59 @@ int main(int argc, char* argv[]) {
                         startTicks = SDL_GetTicks() - pausedTicks;
                     }
                 }
-                if (solved && inputActive) {
-                    if (e.key.keysym.sym == SDLK_BACKSPACE && !userInput.empty()) {
-                        userInput.pop_back();
-                    }
-                    if ((e.key.keysym.sym == SDLK_RETURN || e.key.keysym.sym == SDLK_KP_ENTER)) {
-                        std::string code = unlockKey.substr(unlockKey.find(':') + 2);
-                        if (userInput == code) accessMsg = "Access Granted!";
-                        else                   accessMsg = "Wrong Key!";
-                    }
-                }
+                if (e.key.keysym.sym == SDLK_F3) showHudStats = !showHudStats;
             }
             if (!paused && !solved) {
                 if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT) {
-                    int mx = e.button.x, my = e.button.y;
-                    for (int i = 0; i < COMP_COUNT; ++i) {
-                        SDL_Rect r = comps[i].rect;
-                        if (mx > r.x && mx < r.x + r.w && my > r.y && my < r.y + r.h) {
-                            dragging = true;
-                            dragged = i;
-                            offsetX = mx - r.x;
-                            offsetY = my - r.y;
-                            break;
-                        }
+                    if (board.beginDrag(e.button.x, e.button.y)) {
+                        circuit.update(board);
+                        circuit.preview(board);
                     }
                 }
-                if (e.type == SDL_MOUSEBUTTONUP && e.button.button == SDL_BUTTON_LEFT) {
-                    dragging = false;
-                    dragged = -1;
+                if (e.type == SDL_MOUSEBUTTONUP && e.button.button == SDL_BUTTON_LEFT && board.dragging()) {
+                    // Only a drop is judged; while dragging, the preview just moves the meters.
+                    board.endDrag();
+                    circuit.update(board);
+                    if (circuit.solved()) {
+                        solved = true;
+                        int keyNum = 1000 + std::rand() % 9000;
+                        unlockKey = "Puzzle Solved! Unlock Key: " + std::to_string(keyNum);
+                        inputActive = true;
+                        if (!keyField && font.font()) {
+                            keyField.reset(new TextField(ren, font.font(), white, {260, 554, 280, 0}, 8));
+                        }
+                    }
                 }
-                if (e.type == SDL_MOUSEMOTION && dragging && dragged != -1) {
-                    comps[dragged].rect.x = e.motion.x - offsetX;
-                    comps[dragged].rect.y = e.motion.y - offsetY;
+                if (e.type == SDL_MOUSEMOTION && board.dragging()) {
+                    board.dragTo(e.motion.x, e.motion.y);
+                    circuit.preview(board);
                 }
             }
-            if (e.type == SDL_TEXTINPUT && solved && inputActive) {
-                userInput += e.text.text;
+            if (solved && inputActive && keyField) {
+                keyField->handleEvent(e);
+                if (keyField->submitted()) {
+                    std::string code = unlockKey.substr(unlockKey.find(':') + 2);
+                    if (keyField->text() == code) accessMsg = "Access Granted!";
+                    else                         accessMsg = "Wrong Key!";
+                    keyField->resetSubmitted();
+                }
             }
         }
 
         Uint32 now = SDL_GetTicks();
+        // A rebuilt pack replaces the layout, unless a piece is in hand or
+        // the round is over.
+        if (now - lastReloadCheck >= 1000 && !solved && !board.dragging()) {
+            lastReloadCheck = now;
+            if (pack.reloadIfChanged() && loadPackedLayout(pack, board, circuit)) {
+                circuit.build(board);
+                loadKindSprites(sprites, board, kindSprite, ledSprite);
+            }
+        }
+
         int secLeft;
+        if (!paused) circuit.step(std::min(now - lastTicks, 100u) / 1000.0);
+        lastTicks = now;
 
         if (paused || solved) {
             secLeft = TIME_LIMIT - (int)(pausedTicks / 1000);
@@ -170,24 +269,7 @@ int main(int argc, char* argv[]) {
             inputActive = false;
         }
 
-        if (!solved) {
-            bool all = true;
-            for (int i = 0; i < COMP_COUNT; ++i) {
-                if (isNear(comps[i].rect.x, comps[i].rect.y, targetSlots[i].x, targetSlots[i].y))
-                    comps[i].placed = true;
-                else {
-                    comps[i].placed = false;
-                    all = false;
-                }
-            }
-            if (all) {
-                solved = true;
-                int keyNum = 1000 + std::rand() % 9000;
-                unlockKey = "Puzzle Solved! Unlock Key: " + std::to_string(keyNum);
-                inputActive = true;
-            }
-        }
-
+        hud.beginFrame();
         SDL_SetRenderDrawColor(ren, 20,20,20,255);
         SDL_RenderClear(ren);
 
@@ -196,83 +278,86 @@ int main(int argc, char* argv[]) {
             SDL_RenderCopy(ren, background, NULL, &bgRect);
         }
 
-        if (ledTex) {
+        SDL_SetRenderDrawColor(ren, 100,255,200,120);
+        for (const BoardSlot& slot : board.slots()) {
+            SDL_RenderDrawRect(ren, &slot.rect);
+        }
+
+        {
+            // Brightness follows the simulated LED current, full at 20 mA.
             SDL_Rect lr = {700,20,60,60};
-            if (solved && inputActive)
-                SDL_SetTextureColorMod(ledTex, 0,255,0);
-            else
-                SDL_SetTextureColorMod(ledTex, 100,100,100);
-            SDL_RenderCopy(ren, ledTex, NULL, &lr);
+            double glow = std::min(1.0, circuit.ledCurrent() / 0.020);
+            SDL_Color tint = {100, (Uint8)(100 + 155 * glow), 100, 255};
+            if (circuit.ledBurnt()) tint = {60, 20, 20, 255};
+            sprites.draw(ledSprite, lr, tint);
         }
 
-        for (int i = 0; i < COMP_COUNT; ++i) {
-            SDL_SetRenderDrawColor(ren, 100,255,200,120);
-            SDL_Rect sr = {targetSlots[i].x, targetSlots[i].y, 48, 48};
-            SDL_RenderDrawRect(ren, &sr);
+        for (int id : board.drawOrder()) {
+            const BoardPiece& piece = board.pieces()[id];
+            sprites.draw(kindSprite[piece.kind], piece.rect);
         }
 
-        for (int i = 0; i < COMP_COUNT; ++i) {
-            if (compTex[i]) SDL_RenderCopy(ren, compTex[i], NULL, &comps[i].rect);
+        {
+            SDL_Rect r = hud.draw("Time Left: ", black, 10, 10);
+            r = hud.drawNumber(secLeft > 0 ? secLeft : 0, 0, black, r.x + r.w, 10);
+            hud.draw("s", black, r.x + r.w, 10);
         }
 
         {
-            std::stringstream ss;
-            ss << "Time Left: " << (secLeft>0?secLeft:0) << "s";
-            SDL_Surface* ts = TTF_RenderText_Blended(font, ss.str().c_str(), black);
-            if (ts) {
-                SDL_Texture* tt = SDL_CreateTextureFromSurface(ren, ts);
-                SDL_Rect tr = {10,10,ts->w,ts->h}; SDL_RenderCopy(ren, tt, NULL, &tr);
-                SDL_FreeSurface(ts); SDL_DestroyTexture(tt);
+            SDL_Rect r = hud.draw("Ammeter: ", black, 10, 40);
+            if (circuit.hasAmmeter()) {
+                r = hud.drawNumber(circuit.ammeterReading() * 1000.0, 1, black, r.x + r.w, 40);
+                r = hud.draw(" mA", black, r.x + r.w, 40);
+            } else {
+                r = hud.draw("--", black, r.x + r.w, 40);
+            }
+            r = hud.draw("   Voltmeter: ", black, r.x + r.w, 40);
+            if (circuit.hasVoltmeter()) {
+                r = hud.drawNumber(circuit.voltmeterReading(), 2, black, r.x + r.w, 40);
+                r = hud.draw(" V", black, r.x + r.w, 40);
+            } else {
+                r = hud.draw("--", black, r.x + r.w, 40);
+            }
+            if (circuit.previewing()) hud.draw("   (if dropped)", black, r.x + r.w, 40);
+            if (!solved && !circuit.status().empty()) {
+                hud.draw(circuit.status(), circuit.ledBurnt() ? red : black, 10, 70);
             }
         }
 
         if (solved) {
-            SDL_Surface* rs = TTF_RenderText_Blended(font, unlockKey.c_str(), (inputActive? green:white));
-            if (rs) {
-                SDL_Texture* rt = SDL_CreateTextureFromSurface(ren, rs);
-                SDL_Rect rr = {150,500,rs->w,rs->h}; SDL_RenderCopy(ren, rt, NULL, &rr);
-                SDL_FreeSurface(rs); SDL_DestroyTexture(rt);
-            }
+            hud.draw(unlockKey, inputActive ? green : white, 150, 500);
             if (inputActive) {
                 SDL_Rect box = {250,550,300,36};
                 SDL_SetRenderDrawColor(ren, 255,255,255,60); SDL_RenderFillRect(ren,&box);
                 SDL_SetRenderDrawColor(ren, 100,255,200,180); SDL_RenderDrawRect(ren,&box);
-                SDL_Surface* ps = TTF_RenderText_Blended(font, "Enter Key:", white);
-                if (ps) {
-                    SDL_Texture* pt = SDL_CreateTextureFromSurface(ren, ps);
-                    SDL_Rect pr = {box.x-ps->w-10,box.y+4,ps->w,ps->h};
-                    SDL_RenderCopy(ren,pt,NULL,&pr);
-                    SDL_FreeSurface(ps); SDL_DestroyTexture(pt);
-                }
-                SDL_Surface* us = TTF_RenderText_Blended(font, userInput.c_str(), white);
-                if (us) {
-                    SDL_Texture* ut = SDL_CreateTextureFromSurface(ren, us);
-                    SDL_Rect ur = {box.x+10,box.y+4,us->w,us->h};
-                    SDL_RenderCopy(ren,ut,NULL,&ur);
-                    SDL_FreeSurface(us); SDL_DestroyTexture(ut);
-                }
+                SDL_Rect pr = hud.measure("Enter Key:");
+                hud.draw("Enter Key:", white, box.x - pr.w - 10, box.y + 4);
+                if (keyField) keyField->render();
                 if (!accessMsg.empty()) {
                     SDL_Color col = (accessMsg=="Access Granted!"?green:red);
-                    SDL_Surface* am = TTF_RenderText_Blended(font,accessMsg.c_str(),col);
-                    if (am) {
-                        SDL_Texture* at = SDL_CreateTextureFromSurface(ren,am);
-                        SDL_Rect ar = {box.x+50,box.y-40,am->w,am->h};
-                        SDL_RenderCopy(ren,at,NULL,&ar);
-                        SDL_FreeSurface(am); SDL_DestroyTexture(at);
-                    }
+                    hud.draw(accessMsg, col, box.x+50, box.y-40);
                 }
             }
         }
 
+        if (showHudStats) {
+            // Glyphs the HUD drew from the atlas this frame, before this line.
+            int glyphs = hud.frameGlyphs();
+            SDL_Rect r = hud.draw("HUD glyphs drawn: ", white, 10, WIN_H - 30);
+            hud.drawNumber(glyphs, 0, white, r.x + r.w, WIN_H - 30);
+        }
+
         SDL_RenderPresent(ren);
+        ALLOC_FRAME();
         SDL_Delay(16);
     }
 
     SDL_StopTextInput();
-    for (int i=0; i<COMP_COUNT; ++i) if(compTex[i]) SDL_DestroyTexture(compTex[i]);
-    if (ledTex) SDL_DestroyTexture(ledTex);
+    circuit.printLatencyReport(std::cout);
+    hud.printReport(std::cout);
+    }
     if (background) SDL_DestroyTexture(background);
-    TTF_CloseFont(font);
+    font.close();
     SDL_DestroyRenderer(ren);
     SDL_DestroyWindow(window);
     TTF_Quit(); IMG_Quit(); SDL_Quit();
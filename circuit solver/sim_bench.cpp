@@ -0,0 +1,152 @@
+// Solve-time benchmark for the circuit engine.
+//
+// Builds a side x side grid of resistors with a diode on some of the links
+// and a capacitor to ground on some nodes, driven by a battery in one
+// corner, then times the symbolic analysis, the DC operating point (Newton
+// with full factorization and refactorization) and transient steps.
+//
+// A second table plays back drag events on a linear grid with a few slots
+// and an LED, as the puzzle does when a piece is hovered over slots: each
+// event swaps one slot's part and re-solves the DC point, once with
+// low-rank updates of the factors and once refactoring every time.
+//
+//   sim_bench [side] [steps]       default: a sweep of grid sizes, 100 steps
+#include "CircuitSim.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void buildGrid(Circuit& c, int side) {
+    // Node (x, y) is 1 + y * side + x; the battery feeds the first one and
+    // the far corner is tied to ground.
+    int links = 0;
+    for (int y = 0; y < side; ++y) {
+        for (int x = 0; x < side; ++x) {
+            int n = 1 + y * side + x;
+            if (x + 1 < side) {
+                if (++links % 7 == 0) c.addDiode(n, n + 1);
+                else c.addResistor(n, n + 1, 100.0 + (n % 13) * 10.0);
+            }
+            if (y + 1 < side) c.addResistor(n, n + side, 220.0);
+            if (n % 5 == 0) c.addCapacitor(n, 0, 1e-6);
+        }
+    }
+    c.addBattery(1, 0, 9.0);
+    c.addResistor(side * side, 0, 10.0);
+}
+
+void run(int side, int steps) {
+    Circuit c;
+    Clock::time_point start = Clock::now();
+    buildGrid(c, side);
+    double buildMs = msSince(start);
+
+    if (!c.solveDC()) {
+        std::printf("%6d  DC solve failed: %s\n", side * side, c.error().c_str());
+        return;
+    }
+    SolveStats dc = c.stats();
+
+    c.resetTransient();
+    start = Clock::now();
+    int iterations = 0;
+    double factorMs = 0.0;
+    for (int i = 0; i < steps; ++i) {
+        if (!c.step(1e-5)) {
+            std::printf("%6d  step %d failed: %s\n", side * side, i, c.error().c_str());
+            return;
+        }
+        iterations += c.stats().newtonIterations;
+        factorMs += c.stats().factorMs;
+    }
+    double stepMs = msSince(start) / steps;
+    const SolveStats& s = c.stats();
+
+    std::printf("%6d %8zu %8.2f %8.2f %8.2f %5d %5d %8.3f %8.3f %6.2f %5d\n",
+                c.unknowns(), c.factorNonzeros(), buildMs, dc.analyzeMs, dc.solveMs,
+                dc.newtonIterations, dc.factorizations, dc.factorMs / dc.newtonIterations,
+                stepMs, static_cast<double>(iterations) / steps,
+                s.factorizations - dc.factorizations);
+}
+
+struct Latency {
+    double p50, p99;
+};
+
+Latency dragEvents(int side, int events, int maxRank, int* lowRank) {
+    Circuit c;
+    c.setMaxUpdateRank(maxRank);
+    std::vector<int> slots;
+    int count = side * side;
+    for (int y = 0; y < side; ++y) {
+        for (int x = 0; x < side; ++x) {
+            int n = 1 + y * side + x;
+            if (x + 1 < side) c.addResistor(n, n + 1, 100.0 + (n % 13) * 10.0);
+            if (y + 1 < side) c.addResistor(n, n + side, 220.0);
+        }
+    }
+    for (int i = 1; i <= 6; ++i) slots.push_back(c.add(i * count / 8, (i * count / 8 + 17) % count + 1, Circuit::open()));
+    c.addBattery(1, 0, 9.0);
+    c.addLed(count, 0);
+    c.solveDC();
+
+    const Circuit::Part parts[] = {Circuit::open(), Circuit::resistor(47.0), Circuit::ammeter(),
+                                   Circuit::voltmeter(), Circuit::diode(), Circuit::capacitor(1e-4)};
+    std::mt19937 rng(1);
+    std::vector<double> ms;
+    int before = c.stats().lowRankSolves;
+    for (int i = 0; i < events; ++i) {
+        c.replace(slots[rng() % slots.size()], parts[rng() % 6]);
+        Clock::time_point start = Clock::now();
+        c.solveDC();
+        ms.push_back(msSince(start));
+    }
+    *lowRank = c.stats().lowRankSolves - before;
+    std::sort(ms.begin(), ms.end());
+    return Latency{ms[ms.size() / 2], ms[ms.size() * 99 / 100]};
+}
+
+void runDrag(int side, int events) {
+    int lowRank = 0, unused = 0;
+    Latency updated = dragEvents(side, events, 8, &lowRank);
+    Latency refactored = dragEvents(side, events, 0, &unused);
+    std::printf("%6d %10.3f %10.3f %10.3f %10.3f %8.1fx %9d\n", side * side, updated.p50, updated.p99,
+                refactored.p50, refactored.p99, refactored.p50 / updated.p50, lowRank);
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::vector<int> sides;
+    if (argc > 1) sides.push_back(std::atoi(argv[1]));
+    else sides = {10, 32, 64, 100};
+    int steps = argc > 2 ? std::atoi(argv[2]) : 100;
+
+    std::printf("%6s %8s %8s %8s %8s %5s %5s %8s %8s %6s %5s\n", "nodes", "nnz(LU)", "build",
+                "analyze", "DC ms", "newt", "fact", "fact/it", "step ms", "it/st", "refac");
+    for (int side : sides) {
+        if (side < 2 || steps < 1) {
+            std::fprintf(stderr, "usage: %s [side >= 2] [steps >= 1]\n", argv[0]);
+            return 1;
+        }
+        run(side, steps);
+    }
+    std::printf("fact: full factorizations with pivot search; every other iteration refactored.\n"
+                "refac: full factorizations needed during the transient (0 = pattern and pivots reused).\n\n");
+
+    std::printf("drag events, ms per DC re-solve\n%6s %10s %10s %10s %10s %9s %9s\n", "nodes", "update p50",
+                "update p99", "refac p50", "refac p99", "speedup", "lr solves");
+    for (int side : sides) runDrag(side, 200);
+    return 0;
+}
@@ -0,0 +1,243 @@
+#include "AllocTracker.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <sys/resource.h>
+
+namespace {
+
+// In front of every block handed out; 16 bytes keeps malloc's alignment
+struct Header {
+    size_t size;
+    int tag;
+    int fromSDL;
+};
+
+const int MAX_TAGS = 32;
+const int UNTAGGED = 0;
+const int OTHER = 1;   // tags past MAX_TAGS
+
+struct TagStats {
+    std::atomic<size_t> newCalls, sdlCalls, bytes, live, liveBytes;
+    // Only touched by frame() and the report
+    size_t firstCalls, firstBytes, lastCalls, lastBytes, worstCalls, worstBytes;
+};
+
+const char* names[MAX_TAGS] = {"untagged", "other"};
+std::atomic<int> tagCount(2);
+std::mutex tagMutex;
+TagStats tags[MAX_TAGS];
+
+thread_local int currentTag = UNTAGGED;
+
+std::atomic<size_t> liveBytes(0), peakLiveBytes(0);
+
+const char* programName = "program";
+size_t frames = 0;
+size_t quietFrames = 0;   // frames without a single allocation
+size_t worstFrame = 0;
+
+size_t calls(const TagStats& t) {
+    return t.newCalls.load(std::memory_order_relaxed) + t.sdlCalls.load(std::memory_order_relaxed);
+}
+
+void addLive(const Header* h) {
+    TagStats& t = tags[h->tag];
+    t.live.fetch_add(1, std::memory_order_relaxed);
+    t.liveBytes.fetch_add(h->size, std::memory_order_relaxed);
+    size_t now = liveBytes.fetch_add(h->size, std::memory_order_relaxed) + h->size;
+    size_t peak = peakLiveBytes.load(std::memory_order_relaxed);
+    while (now > peak && !peakLiveBytes.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+}
+
+void removeLive(const Header* h) {
+    TagStats& t = tags[h->tag];
+    t.live.fetch_sub(1, std::memory_order_relaxed);
+    t.liveBytes.fetch_sub(h->size, std::memory_order_relaxed);
+    liveBytes.fetch_sub(h->size, std::memory_order_relaxed);
+}
+
+// Counts a block just allocated (or nullptr) and returns what the caller gets
+void* take(void* block, size_t size, bool fromSDL) {
+    if (!block) return nullptr;
+    Header* h = static_cast<Header*>(block);
+    h->size = size;
+    h->tag = currentTag;
+    h->fromSDL = fromSDL;
+    TagStats& t = tags[h->tag];
+    (fromSDL ? t.sdlCalls : t.newCalls).fetch_add(1, std::memory_order_relaxed);
+    t.bytes.fetch_add(size, std::memory_order_relaxed);
+    addLive(h);
+    return h + 1;
+}
+
+Header* headerOf(void* p) {
+    return static_cast<Header*>(p) - 1;
+}
+
+void* allocate(size_t size) {
+    return take(std::malloc(sizeof(Header) + size), size, false);
+}
+
+void release(void* p) {
+    if (!p) return;
+    Header* h = headerOf(p);
+    removeLive(h);
+    std::free(h);
+}
+
+void report() {
+    std::fprintf(stderr, "\n%s heap use over %zu frames (ALLOC_TRACK)\n", programName, frames);
+    std::fprintf(stderr, "%-14s %9s %9s %12s %8s %7s %11s %8s %11s\n", "tag", "new", "SDL", "bytes", "/frame",
+                 "worst", "bytes/frame", "at exit", "exit bytes");
+    size_t spanFrames = frames > 1 ? frames - 1 : 1;
+    int count = tagCount.load();
+    for (int i = 0; i < count; ++i) {
+        const TagStats& t = tags[i];
+        if (calls(t) == 0) continue;
+        // Per frame from the first ALLOC_FRAME on, so loading doesn't count
+        double perFrame = frames > 1 ? double(t.lastCalls - t.firstCalls) / spanFrames : 0.0;
+        double bytesPerFrame = frames > 1 ? double(t.lastBytes - t.firstBytes) / spanFrames : 0.0;
+        std::fprintf(stderr, "%-14s %9zu %9zu %12zu %8.1f %7zu %11.0f %8zu %11zu\n", names[i], t.newCalls.load(),
+                     t.sdlCalls.load(), t.bytes.load(), perFrame, t.worstCalls, bytesPerFrame, t.live.load(),
+                     t.liveBytes.load());
+    }
+    if (frames > 0) {
+        std::fprintf(stderr, "frames without an allocation: %zu of %zu; worst frame: %zu allocations\n", quietFrames,
+                     frames, worstFrame);
+    }
+    struct rusage usage;
+    long rssKB = getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : 0;
+    std::fprintf(stderr, "peak live heap: %zu KB; peak RSS: %ld KB\n", peakLiveBytes.load() / 1024, rssKB);
+    std::fprintf(stderr, "(\"at exit\" is what was never freed, plus statics not yet destroyed)\n");
+}
+
+}
+
+namespace AllocTracker {
+
+void start(const char* program) {
+    programName = program;
+    std::atexit(report);
+}
+
+int tagId(const char* name) {
+    std::lock_guard<std::mutex> lock(tagMutex);
+    int count = tagCount.load();
+    for (int i = 0; i < count; ++i) {
+        if (std::strcmp(names[i], name) == 0) return i;
+    }
+    if (count == MAX_TAGS) return OTHER;
+    names[count] = name;
+    tagCount.store(count + 1);
+    return count;
+}
+
+Scope::Scope(int tag) : previous_(currentTag) {
+    currentTag = tag;
+}
+
+Scope::~Scope() {
+    currentTag = previous_;
+}
+
+void frame() {
+    size_t total = 0;
+    int count = tagCount.load();
+    for (int i = 0; i < count; ++i) {
+        TagStats& t = tags[i];
+        size_t c = calls(t);
+        size_t b = t.bytes.load(std::memory_order_relaxed);
+        if (frames == 0) {
+            t.firstCalls = c;
+            t.firstBytes = b;
+        } else {
+            if (c - t.lastCalls > t.worstCalls) t.worstCalls = c - t.lastCalls;
+            if (b - t.lastBytes > t.worstBytes) t.worstBytes = b - t.lastBytes;
+            total += c - t.lastCalls;
+        }
+        t.lastCalls = c;
+        t.lastBytes = b;
+    }
+    if (frames > 0) {
+        if (total == 0) ++quietFrames;
+        if (total > worstFrame) worstFrame = total;
+    }
+    ++frames;
+}
+
+void* sdlMalloc(size_t size) {
+    return take(std::malloc(sizeof(Header) + size), size, true);
+}
+
+void* sdlCalloc(size_t count, size_t size) {
+    if (size != 0 && count > (static_cast<size_t>(-1) - sizeof(Header)) / size) return nullptr;
+    return take(std::calloc(1, sizeof(Header) + count * size), count * size, true);
+}
+
+void* sdlRealloc(void* p, size_t size) {
+    if (!p) return sdlMalloc(size);
+    Header* h = headerOf(p);
+    removeLive(h);
+    void* moved = std::realloc(h, sizeof(Header) + size);
+    if (!moved) {
+        // p is still there as it was
+        addLive(h);
+        return nullptr;
+    }
+    return take(moved, size, true);
+}
+
+void sdlFree(void* p) {
+    release(p);
+}
+
+}
+
+void* operator new(size_t size) {
+    void* p = allocate(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void operator delete(void* p) noexcept {
+    release(p);
+}
+
+void operator delete[](void* p) noexcept {
+    release(p);
+}
+
+#if __cpp_sized_deallocation
+void operator delete(void* p, size_t) noexcept {
+    release(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    release(p);
+}
+#endif
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    release(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    release(p);
+}
@@ -0,0 +1,78 @@
+#ifndef ALLOCTRACKER_H
+#define ALLOCTRACKER_H
+
+#include <cstddef>
+
+// Opt-in heap instrumentation. Build a game with `make ALLOC_TRACK=1` (after
+// a `make clean`) and AllocTracker.cpp is linked in and ALLOC_TRACK defined:
+// global operator new/delete are replaced, ALLOC_TRACK_SDL() routes SDL's
+// own allocations (surfaces, textures, SDL_ttf and SDL_image buffers)
+// through the same counters, and a report goes to stderr at exit. Without
+// the flag every macro below compiles to nothing.
+//
+//   ALLOC_TRACK_START("name")  first thing in main: names the report and
+//                              schedules it for exit
+//   ALLOC_TRACK_SDL()          before SDL_Init (SDL allows it only before
+//                              its first allocation)
+//   ALLOC_TAG("text")          allocations on this thread until the end of
+//                              the enclosing block count towards "text";
+//                              tags nest, the innermost wins
+//   ALLOC_FRAME()              after each present: closes a frame for the
+//                              per-frame counts
+//
+// The report has, per tag: calls through new and through SDL, bytes, mean
+// and worst per frame, and what was still allocated at exit (leaks, plus
+// anything static that isn't destroyed yet). Then the peak of live heap
+// bytes and the process's peak RSS.
+//
+// Every block carries a 16-byte header with its size and tag. malloc calls
+// made directly (FreeType, the C library, raylib) are not seen, and
+// over-aligned new is left to the C++ library.
+namespace AllocTracker {
+
+void start(const char* program);
+void frame();
+
+// Tag number for name (a string that lives for the whole program); the
+// same name always gets the same number.
+int tagId(const char* name);
+
+class Scope {
+public:
+    explicit Scope(int tag);
+    ~Scope();
+
+private:
+    Scope(const Scope&);
+    Scope& operator=(const Scope&);
+
+    int previous_;
+};
+
+// For SDL_SetMemoryFunctions
+void* sdlMalloc(size_t size);
+void* sdlCalloc(size_t count, size_t size);
+void* sdlRealloc(void* p, size_t size);
+void sdlFree(void* p);
+
+}
+
+#ifdef ALLOC_TRACK
+#define ALLOC_TRACK_CAT2(a, b) a##b
+#define ALLOC_TRACK_CAT(a, b) ALLOC_TRACK_CAT2(a, b)
+#define ALLOC_TRACK_START(program) AllocTracker::start(program)
+#define ALLOC_TRACK_SDL() \
+    SDL_SetMemoryFunctions(AllocTracker::sdlMalloc, AllocTracker::sdlCalloc, AllocTracker::sdlRealloc, \
+                           AllocTracker::sdlFree)
+#define ALLOC_TAG(name) \
+    static const int ALLOC_TRACK_CAT(allocTag_, __LINE__) = AllocTracker::tagId(name); \
+    AllocTracker::Scope ALLOC_TRACK_CAT(allocScope_, __LINE__)(ALLOC_TRACK_CAT(allocTag_, __LINE__))
+#define ALLOC_FRAME() AllocTracker::frame()
+#else
+#define ALLOC_TRACK_START(program) ((void)0)
+#define ALLOC_TRACK_SDL() ((void)0)
+#define ALLOC_TAG(name) ((void)0)
+#define ALLOC_FRAME() ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,62 @@
+#include "AtlasTable.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool AtlasTable::read(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) return false;
+    image.clear();
+    sprites.clear();
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        std::istringstream fields(line);
+        std::string word;
+        if (!(fields >> word) || word[0] == '#') continue;
+        bool ok;
+        if (word == "image") {
+            ok = static_cast<bool>(fields >> image >> width >> height) && width > 0 && height > 0;
+        } else if (word == "sprite") {
+            AtlasSprite s;
+            ok = fields >> s.name >> s.x >> s.y >> s.w >> s.h >> s.sourceW >> s.sourceH && s.x >= 0 && s.y >= 0 &&
+                 s.w > 0 && s.h > 0 && s.x + s.w <= width && s.y + s.h <= height && s.sourceW > 0 && s.sourceH > 0;
+            if (ok) sprites.push_back(s);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << path << ":" << lineNo << ": bad line: " << line << "\n";
+            return false;
+        }
+    }
+    if (image.empty()) {
+        std::cerr << path << ": no image line\n";
+        return false;
+    }
+    return true;
+}
+
+bool AtlasTable::write(const std::string& path) const {
+    std::ofstream out(path);
+    out << "# written by atlasc; sprite <name> <x> <y> <w> <h> <source w> <source h>\n";
+    out << "image " << image << " " << width << " " << height << "\n";
+    for (const AtlasSprite& s : sprites) {
+        out << "sprite " << s.name << " " << s.x << " " << s.y << " " << s.w << " " << s.h << " " << s.sourceW << " "
+            << s.sourceH << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+const AtlasSprite* AtlasTable::find(const std::string& name) const {
+    for (const AtlasSprite& s : sprites) {
+        if (s.name == name) return &s;
+    }
+    return nullptr;
+}
+
+std::string AtlasTable::imagePath(const std::string& tablePath) const {
+    size_t slash = tablePath.find_last_of('/');
+    return slash == std::string::npos ? image : tablePath.substr(0, slash + 1) + image;
+}
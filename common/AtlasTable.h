@@ -0,0 +1,39 @@
+#ifndef ATLASTABLE_H
+#define ATLASTABLE_H
+
+#include <string>
+#include <vector>
+
+// Where each sprite is in a packed atlas image, as written by atlas/atlasc.
+struct AtlasSprite {
+    std::string name;
+    int x, y, w, h;            // in the atlas image
+    int sourceW, sourceH;      // the original image, before any downscaling
+};
+
+// The metadata table that goes with an atlas image. A text file:
+//
+//     image <file, next to the table> <width> <height>
+//     sprite <name> <x> <y> <w> <h> <source w> <source h>
+//
+// Games size and place sprites by the source size, so an atlas built at
+// a different scale draws the same.
+class AtlasTable {
+public:
+    AtlasTable() : width(0), height(0) {}
+
+    // False (and says why on stderr) if the file is missing or malformed.
+    bool read(const std::string& path);
+    bool write(const std::string& path) const;
+
+    // nullptr if there is no sprite by that name.
+    const AtlasSprite* find(const std::string& name) const;
+    // The image's path, next to the table read from tablePath.
+    std::string imagePath(const std::string& tablePath) const;
+
+    std::string image;
+    int width, height;
+    std::vector<AtlasSprite> sprites;
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include "ChecksumFile.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+void syncDirOf(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+    int fd = ::open(dir.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+
+// CRC-32 (IEEE) lookup table.
+struct CrcTable {
+    uint32_t entry[256];
+
+    CrcTable() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            entry[i] = c;
+        }
+    }
+};
+
+}
+
+ChecksumFile::ChecksumFile()
+    : out_(nullptr), headerSize_(0), offset_(0), crc_(0), ok_(false) {}
+
+ChecksumFile::~ChecksumFile() {
+    abandon();
+}
+
+bool ChecksumFile::create(const std::string& path, const void* header, size_t headerSize) {
+    abandon();
+    path_ = path;
+    tmpPath_ = path + ".tmp";
+    out_ = std::fopen(tmpPath_.c_str(), "wb");
+    if (!out_) return false;
+    buffer_.resize(1 << 20);
+    std::setvbuf(out_, buffer_.data(), _IOFBF, buffer_.size());
+
+    headerSize_ = headerSize;
+    offset_ = headerSize;
+    crc_ = 0;
+    ok_ = std::fwrite(header, headerSize, 1, out_) == 1;
+    return true;
+}
+
+void ChecksumFile::put(const void* data, size_t len) {
+    if (!ok_ || len == 0) return;
+    ok_ = std::fwrite(data, 1, len, out_) == len;
+    crc_ = checksum(data, len, crc_);
+    offset_ += len;
+}
+
+void ChecksumFile::padTo(uint64_t target) {
+    static const char zeros[8] = {0};
+    if (target > offset_) put(zeros, static_cast<size_t>(target - offset_));
+}
+
+bool ChecksumFile::commit(const void* header) {
+    if (!out_) return false;
+    bool ok = ok_ && std::fflush(out_) == 0 &&
+              std::fseek(out_, 0, SEEK_SET) == 0 &&
+              std::fwrite(header, headerSize_, 1, out_) == 1 &&
+              std::fflush(out_) == 0 && ::fsync(fileno(out_)) == 0;
+    ok = std::fclose(out_) == 0 && ok;
+    out_ = nullptr;
+
+    if (!ok || std::rename(tmpPath_.c_str(), path_.c_str()) != 0) {
+        int err = errno;
+        ::unlink(tmpPath_.c_str());
+        errno = err;
+        return false;
+    }
+    syncDirOf(path_);
+    return true;
+}
+
+void ChecksumFile::abandon() {
+    if (!out_) return;
+    std::fclose(out_);
+    out_ = nullptr;
+    ::unlink(tmpPath_.c_str());
+}
+
+uint32_t ChecksumFile::checksum(const void* data, size_t len, uint32_t crc) {
+    // Built on first use; a local static's initialization is thread-safe.
+    static const CrcTable table;
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i) crc = table.entry[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
@@ -0,0 +1,65 @@
+#ifndef CHECKSUMFILE_H
+#define CHECKSUMFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Writer for the mmap'ed binary formats (LeaderboardFile, LevelPack).
+//
+// Each of those files is a fixed-size header followed by a body of
+// sections, in host byte order with every section 8-byte aligned. The
+// header carries the CRC-32 of the whole body, which open() with verify
+// set checks in one pass.
+//
+// The file is written as path + ".tmp". The header is written first as a
+// placeholder and patched once the body's checksum is known; commit() then
+// fsyncs it and renames it over path, so a reader that has the old file
+// mapped keeps a complete copy. A writer destroyed before commit() removes
+// the temporary file.
+class ChecksumFile {
+public:
+    ChecksumFile();
+    ~ChecksumFile();
+
+    // Opens path + ".tmp" and writes header (headerSize bytes) at offset 0.
+    bool create(const std::string& path, const void* header, size_t headerSize);
+
+    // Appends to the body. A failed write is remembered and reported by
+    // commit(), so callers need not check each one.
+    void put(const void* data, size_t len);
+    // Zero-pads the body up to file offset target.
+    void padTo(uint64_t target);
+
+    uint64_t offset() const { return offset_; }
+    // Checksum of everything put() so far.
+    uint32_t bodyCrc() const { return crc_; }
+
+    // Rewrites the header (with bodyCrc() filled in by the caller), fsyncs
+    // and renames the file into place. On failure errno says why and the
+    // temporary file is gone.
+    bool commit(const void* header);
+
+    // CRC-32 (IEEE); pass the previous result as crc to continue a sum.
+    static uint32_t checksum(const void* data, size_t len, uint32_t crc = 0);
+    static uint64_t align8(uint64_t n) { return (n + 7) & ~uint64_t(7); }
+
+private:
+    ChecksumFile(const ChecksumFile&);
+    ChecksumFile& operator=(const ChecksumFile&);
+
+    void abandon();
+
+    std::string path_;
+    std::string tmpPath_;
+    std::FILE* out_;
+    std::vector<char> buffer_;
+    size_t headerSize_;
+    uint64_t offset_;
+    uint32_t crc_;
+    bool ok_;
+};
+
+#endif
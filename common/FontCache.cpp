@@ -0,0 +1,401 @@
+#include "FontCache.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char MAGIC[8] = {'E', 'R', 'G', 'L', 'Y', 'P', 'H', 'S'};
+const uint32_t VERSION = 1;
+// Printable ASCII, ' ' to '~'
+const int FIRST = 32;
+const int COUNT = 95;
+// Glyphs are packed in rows this wide, with a pixel between them
+const int ATLAS_WIDTH = 1024;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t glyphSize;
+    uint64_t fontHash;
+    int32_t ptSize;
+    int32_t height;
+    int32_t ascent;
+    int32_t lineSkip;
+    uint32_t first;
+    uint32_t count;
+    uint32_t atlasWidth;
+    uint32_t atlasHeight;
+    uint64_t glyphsOffset;
+    uint64_t kerningOffset;
+    uint64_t pixelsOffset;
+};
+
+struct GlyphRecord {
+    int16_t x, y, w, h;   // in the atlas
+    int16_t advance;
+    int16_t reserved;
+};
+
+double msSince(Uint64 start) {
+    return static_cast<double>(SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+// FNV-1a over the whole file, eight bytes a step (a font is most of a
+// megabyte and this runs every startup); 0 if it can't be read.
+uint64_t hashFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return 0;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return 0;
+    const unsigned char* bytes = static_cast<const unsigned char*>(map);
+    uint64_t h = 14695981039346656037ULL ^ size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, 8);
+        h ^= word;
+        h *= 1099511628211ULL;
+        h ^= h >> 29;
+    }
+    for (; i < size; ++i) {
+        h ^= bytes[i];
+        h *= 1099511628211ULL;
+    }
+    ::munmap(map, size);
+    return h ? h : 1;
+}
+
+// Like mkdir -p; true if dir exists afterwards.
+bool makeDirs(const std::string& dir) {
+    for (size_t slash = dir.find('/', 1); ; slash = dir.find('/', slash + 1)) {
+        std::string prefix = dir.substr(0, slash);
+        if (::mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) return false;
+        if (slash == std::string::npos) return true;
+    }
+}
+
+std::string cacheFile(const std::string& dir, uint64_t hash, int ptSize) {
+    char name[64];
+    std::snprintf(name, sizeof name, "/%016llx-%d.glyphs", static_cast<unsigned long long>(hash), ptSize);
+    return dir + name;
+}
+
+const Header& headerOf(const char* base) {
+    return *reinterpret_cast<const Header*>(base);
+}
+
+const GlyphRecord& glyphOf(const char* base, int c) {
+    const Header& h = headerOf(base);
+    return reinterpret_cast<const GlyphRecord*>(base + h.glyphsOffset)[c - FIRST];
+}
+
+int kerningOf(const char* base, int left, int right) {
+    const Header& h = headerOf(base);
+    return reinterpret_cast<const int8_t*>(base + h.kerningOffset)[(left - FIRST) * COUNT + (right - FIRST)];
+}
+
+// The next glyph to draw from a UTF-8 string, advancing p past it.
+int nextGlyph(const char*& p) {
+    unsigned char c = static_cast<unsigned char>(*p++);
+    if (c >= FIRST && c < FIRST + COUNT) return c;
+    if (c >= 0x80) {
+        while ((static_cast<unsigned char>(*p) & 0xC0) == 0x80) ++p;
+    }
+    return '?';
+}
+
+}
+
+FontCache::FontCache(SDL_Renderer* renderer)
+    : renderer_(renderer), texture_(nullptr), font_(nullptr), ptSize_(0), base_(nullptr), map_(nullptr),
+      mappedSize_(0) {
+    std::memset(&stats_, 0, sizeof(stats_));
+}
+
+FontCache::~FontCache() {
+    close();
+}
+
+bool FontCache::open(const std::string& fontPath, int ptSize) {
+    close();
+    path_ = fontPath;
+    ptSize_ = ptSize;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    uint64_t hash = hashFile(fontPath);
+    stats_.hashMs = msSince(start);
+    if (hash == 0) {
+        std::cerr << "FontCache: cannot read " << fontPath << "\n";
+        return false;
+    }
+
+    start = SDL_GetPerformanceCounter();
+    std::string dir = cacheDir();
+    std::string path = dir.empty() ? std::string() : cacheFile(dir, hash, ptSize);
+    stats_.fromCache = !path.empty() && mapCache(path, hash);
+    if (!stats_.fromCache) {
+        if (!bake(hash)) return false;
+        if (!path.empty()) {
+            // Through a file of our own, so two games baking at once don't mix
+            std::string tmpPath = path + "." + std::to_string(::getpid()) + ".tmp";
+            std::FILE* out = makeDirs(dir) ? std::fopen(tmpPath.c_str(), "wb") : nullptr;
+            bool ok = out && std::fwrite(baked_.data(), 1, baked_.size(), out) == baked_.size();
+            ok = out && std::fclose(out) == 0 && ok;
+            if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+                std::cerr << "FontCache: writing " << path << " failed: " << std::strerror(errno) << "\n";
+                ::unlink(tmpPath.c_str());
+            }
+        }
+    }
+    stats_.cacheBytes = map_ ? mappedSize_ : baked_.size();
+    if (!upload()) {
+        close();
+        return false;
+    }
+    stats_.loadMs = msSince(start);
+    return true;
+}
+
+void FontCache::close() {
+    if (texture_) SDL_DestroyTexture(texture_);
+    texture_ = nullptr;
+    if (font_) TTF_CloseFont(font_);
+    font_ = nullptr;
+    if (map_) ::munmap(map_, mappedSize_);
+    map_ = nullptr;
+    mappedSize_ = 0;
+    std::vector<char>().swap(baked_);
+    base_ = nullptr;
+}
+
+bool FontCache::mapCache(const std::string& path, uint64_t hash) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* map = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return false;
+
+    const char* bytes = static_cast<const char*>(map);
+    const Header& h = headerOf(bytes);
+    // The offsets come from the file: compare them by differences, never by
+    // adding to them, so a huge offset can't wrap past a check
+    uint64_t pixels = static_cast<uint64_t>(h.atlasWidth) * h.atlasHeight * 4;
+    bool valid = std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) == 0 && h.version == VERSION &&
+                 h.glyphSize == sizeof(GlyphRecord) && h.fontHash == hash && h.ptSize == ptSize_ &&
+                 h.first == FIRST && h.count == COUNT && h.height > 0 && h.atlasWidth > 0 && h.atlasHeight > 0 &&
+                 h.atlasWidth <= 16384 && h.atlasHeight <= 16384 && h.glyphsOffset == sizeof(Header) &&
+                 h.pixelsOffset <= size && pixels <= size - h.pixelsOffset && h.pixelsOffset % 4 == 0 &&
+                 h.kerningOffset <= h.pixelsOffset && h.pixelsOffset - h.kerningOffset >= COUNT * COUNT &&
+                 h.glyphsOffset <= h.kerningOffset &&
+                 h.kerningOffset - h.glyphsOffset >= COUNT * sizeof(GlyphRecord);
+    // Check every glyph once so drawing never has to
+    for (int c = FIRST; valid && c < FIRST + COUNT; ++c) {
+        const GlyphRecord& g = glyphOf(bytes, c);
+        valid = g.x >= 0 && g.y >= 0 && g.w >= 0 && g.h >= 0 && g.x + g.w <= static_cast<int>(h.atlasWidth) &&
+                g.y + g.h <= static_cast<int>(h.atlasHeight);
+    }
+    if (!valid) {
+        std::cerr << "FontCache: " << path << " is stale or damaged, baking again\n";
+        ::munmap(map, size);
+        return false;
+    }
+    map_ = map;
+    mappedSize_ = size;
+    base_ = bytes;
+    return true;
+}
+
+bool FontCache::bake(uint64_t hash) {
+    font_ = TTF_OpenFont(path_.c_str(), ptSize_);
+    if (!font_) {
+        std::cerr << "FontCache: TTF_OpenFont " << path_ << ": " << TTF_GetError() << "\n";
+        return false;
+    }
+
+    // Every glyph rendered on its own, a cell as tall as the font with the
+    // glyph sitting on the baseline, as SDL_ttf draws it in a line of text
+    const SDL_Color white = {255, 255, 255, 255};
+    std::vector<SDL_Surface*> cells(COUNT, nullptr);
+    std::vector<GlyphRecord> glyphs(COUNT);
+    int x = 0, y = 0, rowHeight = 0;
+    for (int i = 0; i < COUNT; ++i) {
+        GlyphRecord& g = glyphs[i];
+        std::memset(&g, 0, sizeof(g));
+        int minx, maxx, miny, maxy, advance;
+        if (TTF_GlyphMetrics(font_, static_cast<Uint16>(FIRST + i), &minx, &maxx, &miny, &maxy, &advance) == 0) {
+            g.advance = static_cast<int16_t>(advance);
+        }
+        SDL_Surface* glyph = TTF_RenderGlyph_Blended(font_, static_cast<Uint16>(FIRST + i), white);
+        if (glyph) {
+            cells[i] = SDL_ConvertSurfaceFormat(glyph, SDL_PIXELFORMAT_ARGB8888, 0);
+            SDL_FreeSurface(glyph);
+        }
+        if (!cells[i]) continue;
+        g.w = static_cast<int16_t>(std::min(cells[i]->w, ATLAS_WIDTH));
+        g.h = static_cast<int16_t>(cells[i]->h);
+        if (x + g.w > ATLAS_WIDTH) {
+            x = 0;
+            y += rowHeight + 1;
+            rowHeight = 0;
+        }
+        g.x = static_cast<int16_t>(x);
+        g.y = static_cast<int16_t>(y);
+        x += g.w + 1;
+        rowHeight = std::max(rowHeight, static_cast<int>(g.h));
+    }
+
+    Header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = VERSION;
+    h.glyphSize = sizeof(GlyphRecord);
+    h.fontHash = hash;
+    h.ptSize = ptSize_;
+    h.height = TTF_FontHeight(font_);
+    h.ascent = TTF_FontAscent(font_);
+    h.lineSkip = TTF_FontLineSkip(font_);
+    h.first = FIRST;
+    h.count = COUNT;
+    h.atlasWidth = ATLAS_WIDTH;
+    h.atlasHeight = std::max(1, y + rowHeight);
+    h.glyphsOffset = sizeof(Header);
+    h.kerningOffset = h.glyphsOffset + COUNT * sizeof(GlyphRecord);
+    h.pixelsOffset = (h.kerningOffset + COUNT * COUNT + 3) & ~uint64_t(3);
+
+    baked_.assign(h.pixelsOffset + static_cast<size_t>(h.atlasWidth) * h.atlasHeight * 4, 0);
+    std::memcpy(&baked_[0], &h, sizeof(h));
+    std::memcpy(&baked_[h.glyphsOffset], glyphs.data(), COUNT * sizeof(GlyphRecord));
+    int8_t* kerning = reinterpret_cast<int8_t*>(&baked_[h.kerningOffset]);
+    for (int left = 0; left < COUNT; ++left) {
+        for (int right = 0; right < COUNT; ++right) {
+            int k = TTF_GetFontKerningSizeGlyphs(font_, static_cast<Uint16>(FIRST + left),
+                                                 static_cast<Uint16>(FIRST + right));
+            kerning[left * COUNT + right] = static_cast<int8_t>(std::max(-128, std::min(127, k)));
+        }
+    }
+    char* pixels = &baked_[h.pixelsOffset];
+    for (int i = 0; i < COUNT; ++i) {
+        SDL_Surface* cell = cells[i];
+        if (!cell) continue;
+        const GlyphRecord& g = glyphs[i];
+        SDL_LockSurface(cell);
+        for (int row = 0; row < g.h; ++row) {
+            std::memcpy(pixels + (static_cast<size_t>(g.y + row) * h.atlasWidth + g.x) * 4,
+                        static_cast<const char*>(cell->pixels) + row * cell->pitch, g.w * 4);
+        }
+        SDL_UnlockSurface(cell);
+        SDL_FreeSurface(cell);
+    }
+    base_ = baked_.data();
+    return true;
+}
+
+bool FontCache::upload() {
+    const Header& h = headerOf(base_);
+    texture_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, h.atlasWidth,
+                                 h.atlasHeight);
+    if (!texture_ || SDL_UpdateTexture(texture_, NULL, base_ + h.pixelsOffset, h.atlasWidth * 4) != 0) {
+        std::cerr << "FontCache: glyph texture for " << path_ << ": " << SDL_GetError() << "\n";
+        return false;
+    }
+    SDL_SetTextureBlendMode(texture_, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+SDL_Rect FontCache::draw(const char* text, SDL_Color color, int x, int y) const {
+    SDL_Rect r = measure(text);
+    r.x = x;
+    r.y = y;
+    if (!texture_) return r;
+    SDL_SetTextureColorMod(texture_, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(texture_, color.a);
+    int pen = x, previous = 0;
+    for (const char* p = text; *p;) {
+        int c = nextGlyph(p);
+        if (previous) pen += kerningOf(base_, previous, c);
+        const GlyphRecord& g = glyphOf(base_, c);
+        SDL_Rect src = {g.x, g.y, g.w, g.h};
+        SDL_Rect dst = {pen, y, g.w, g.h};
+        if (g.w > 0) SDL_RenderCopy(renderer_, texture_, &src, &dst);
+        pen += g.advance;
+        previous = c;
+    }
+    return r;
+}
+
+SDL_Rect FontCache::draw(const std::string& text, SDL_Color color, int x, int y) const {
+    return draw(text.c_str(), color, x, y);
+}
+
+SDL_Rect FontCache::measure(const char* text) const {
+    SDL_Rect r = {0, 0, 0, height()};
+    if (!base_) return r;
+    int pen = 0, previous = 0;
+    for (const char* p = text; *p;) {
+        int c = nextGlyph(p);
+        if (previous) pen += kerningOf(base_, previous, c);
+        const GlyphRecord& g = glyphOf(base_, c);
+        // A glyph can reach past its advance (italics), so the last one's cell counts
+        r.w = std::max(r.w, pen + g.w);
+        pen += g.advance;
+        previous = c;
+    }
+    r.w = std::max(r.w, pen);
+    return r;
+}
+
+int FontCache::height() const {
+    return base_ ? headerOf(base_).height : 0;
+}
+
+int FontCache::lineSkip() const {
+    return base_ ? headerOf(base_).lineSkip : 0;
+}
+
+TTF_Font* FontCache::font() {
+    if (!font_ && !path_.empty()) {
+        font_ = TTF_OpenFont(path_.c_str(), ptSize_);
+        if (!font_) std::cerr << "FontCache: TTF_OpenFont " << path_ << ": " << TTF_GetError() << "\n";
+    }
+    return font_;
+}
+
+void FontCache::printReport(std::ostream& out) const {
+    char line[256];
+    std::snprintf(line, sizeof line, "Font %s %d pt: %.2f ms (hash %.2f ms), %s, %zu KB\n", path_.c_str(), ptSize_,
+                  stats_.hashMs + stats_.loadMs, stats_.hashMs,
+                  stats_.fromCache ? "mapped from the glyph cache" : "rasterized and cached", stats_.cacheBytes / 1024);
+    out << line;
+}
+
+std::string FontCache::cacheDir() {
+    if (const char* env = std::getenv("FONT_CACHE_DIR")) return env;
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME")) {
+        if (*xdg) return std::string(xdg) + "/escaperoom/fonts";
+    }
+    if (const char* home = std::getenv("HOME")) {
+        if (*home) return std::string(home) + "/.cache/escaperoom/fonts";
+    }
+    return std::string();
+}
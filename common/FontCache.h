@@ -0,0 +1,96 @@
+#ifndef FONTCACHE_H
+#define FONTCACHE_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// One font at one size, drawn from its printable ASCII glyphs baked into a
+// single texture. The bake is cached on disk, keyed by a hash of the font
+// file's bytes and the point size, so the copies of the same TTF in
+// different game directories share one entry.
+//
+// The first run opens the font with SDL_ttf, rasterizes every glyph and
+// writes the cache through a temporary file renamed into place. Later runs
+// mmap the cache and upload its pixels straight into a texture: no
+// TTF_OpenFont, no FreeType rasterizing, before the first frame.
+//
+// Cache file (host byte order), in $FONT_CACHE_DIR (set but empty turns the
+// cache off), else $XDG_CACHE_HOME/escaperoom/fonts, else
+// ~/.cache/escaperoom/fonts:
+//   Header    magic, font hash and size, metrics, section offsets
+//   Glyphs    count x 12 bytes {atlas x, y, w, h, advance}
+//   Kerning   count x count signed bytes, [left * count + right]
+//   Pixels    atlas width x height ARGB8888, white with coverage in alpha
+//
+// Text is laid out glyph by glyph with the font's kerning, as SDL_ttf does
+// it. Bytes outside printable ASCII draw as '?' (one per UTF-8 sequence).
+class FontCache {
+public:
+    struct Stats {
+        bool fromCache;    // mapped an existing cache, or baked and wrote one
+        double hashMs;     // reading and hashing the font file
+        double loadMs;     // mapping or baking, and the texture upload
+        size_t cacheBytes;
+    };
+
+    explicit FontCache(SDL_Renderer* renderer);
+    ~FontCache();
+
+    // False (and says why on stderr) if the font can't be opened. A cache
+    // that can't be read or written is only reported; the font is baked.
+    bool open(const std::string& fontPath, int ptSize);
+    void close();
+    bool isOpen() const { return texture_ != nullptr; }
+
+    // Top left at x, y; returns where the text went. color.a is the text's
+    // opacity, so give it one.
+    SDL_Rect draw(const char* text, SDL_Color color, int x, int y) const;
+    SDL_Rect draw(const std::string& text, SDL_Color color, int x, int y) const;
+    // The size draw() would cover, at 0, 0.
+    SDL_Rect measure(const char* text) const;
+
+    int height() const;
+    int lineSkip() const;
+
+    // The font itself, for code that still renders with SDL_ttf (text
+    // fields, the score panel). Opened on first call when the glyphs came
+    // from the cache; nullptr if it can't be.
+    TTF_Font* font();
+
+    const Stats& stats() const { return stats_; }
+    // One line: which font, where its glyphs came from and how long it took.
+    void printReport(std::ostream& out) const;
+
+    // Empty if there is nowhere to cache (no HOME).
+    static std::string cacheDir();
+
+private:
+    FontCache(const FontCache&);
+    FontCache& operator=(const FontCache&);
+
+    bool mapCache(const std::string& path, uint64_t hash);
+    bool bake(uint64_t hash);
+    bool upload();
+
+    SDL_Renderer* renderer_;
+    SDL_Texture* texture_;
+    TTF_Font* font_;
+    std::string path_;
+    int ptSize_;
+
+    // Header, glyphs, kerning and pixels: either the mapped cache file or
+    // the bake held in memory.
+    const char* base_;
+    void* map_;
+    size_t mappedSize_;
+    std::vector<char> baked_;
+
+    Stats stats_;
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "FrameArena.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+FrameArena::FrameArena(size_t capacity)
+    : base_(static_cast<char*>(std::malloc(capacity))), capacity_(base_ ? capacity : 0), used_(0) {
+    Counters c = {0, 0, 0, 0, 0, base_ ? 1u : 0u};
+    counters_ = c;
+}
+
+FrameArena::~FrameArena() {
+    std::free(base_);
+}
+
+void* FrameArena::allocate(size_t bytes, size_t align) {
+    uintptr_t at = reinterpret_cast<uintptr_t>(base_) + used_;
+    size_t padding = (align - at % align) % align;
+    if (bytes + padding > capacity_ - used_) {
+        ++counters_.overflows;
+        return nullptr;
+    }
+    used_ += padding + bytes;
+    ++counters_.allocations;
+    counters_.bytes = used_;
+    if (used_ > counters_.peakBytes) counters_.peakBytes = used_;
+    return base_ + used_ - bytes;
+}
+
+void FrameArena::reset() {
+    used_ = 0;
+    ++counters_.frames;
+    counters_.allocations = 0;
+    counters_.bytes = 0;
+}
+
+namespace {
+
+// Where a FrameText writes when its arena had no room: always "".
+char noRoom[1];
+
+}
+
+FrameText::FrameText(FrameArena& arena, size_t capacity)
+    : text_(static_cast<char*>(arena.allocate(capacity + 1, 1))), capacity_(capacity), size_(0),
+      truncated_(false) {
+    if (!text_) {
+        text_ = noRoom;
+        capacity_ = 0;
+        truncated_ = true;
+    }
+    text_[0] = '\0';
+}
+
+void FrameText::clear() {
+    size_ = 0;
+    text_[0] = '\0';
+    truncated_ = text_ == noRoom;
+}
+
+FrameText& FrameText::append(const char* s, size_t n) {
+    if (n > capacity_ - size_) {
+        n = capacity_ - size_;
+        truncated_ = true;
+    }
+    std::memcpy(text_ + size_, s, n);
+    size_ += n;
+    text_[size_] = '\0';
+    return *this;
+}
+
+FrameText& FrameText::appendf(const char* fmt, va_list args) {
+    // vsnprintf writes straight into the rest of the buffer and says how
+    // much it wanted
+    int wanted = std::vsnprintf(text_ + size_, capacity_ - size_ + 1, fmt, args);
+    if (wanted < 0) return *this;
+    if (static_cast<size_t>(wanted) > capacity_ - size_) {
+        size_ = capacity_;
+        truncated_ = true;
+    } else {
+        size_ += wanted;
+    }
+    return *this;
+}
+
+FrameText& FrameText::format(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    appendf(fmt, args);
+    va_end(args);
+    return *this;
+}
+
+FrameText& FrameText::operator<<(const char* s) { return append(s, std::strlen(s)); }
+FrameText& FrameText::operator<<(const std::string& s) { return append(s.data(), s.size()); }
+FrameText& FrameText::operator<<(char c) { return append(&c, 1); }
+FrameText& FrameText::operator<<(int v) { return format("%d", v); }
+FrameText& FrameText::operator<<(long v) { return format("%ld", v); }
+FrameText& FrameText::operator<<(long long v) { return format("%lld", v); }
+FrameText& FrameText::operator<<(unsigned v) { return format("%u", v); }
+FrameText& FrameText::operator<<(unsigned long v) { return format("%lu", v); }
+FrameText& FrameText::operator<<(double v) { return format("%g", v); }
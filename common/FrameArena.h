@@ -0,0 +1,92 @@
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include <cstdarg>
+#include <cstddef>
+#include <string>
+
+// Memory for things that only live until the end of a frame (the text of a
+// score or a timer, mostly), handed out by bumping an offset into one block
+// that is allocated up front. reset() at the end of the frame takes it all
+// back at once; nothing is freed one by one and nothing is destroyed, so
+// only put trivially destructible things in it.
+//
+// When a frame asks for more than is left, allocate() returns nullptr and
+// counts an overflow instead of going to the heap, so in steady state a
+// frame never calls malloc. The counters say how close a frame came: size
+// the arena from peakBytes and keep overflows at 0.
+class FrameArena {
+public:
+    struct Counters {
+        size_t frames;        // reset() calls
+        size_t allocations;   // this frame
+        size_t bytes;         // this frame, with alignment padding
+        size_t peakBytes;     // most any frame has used
+        size_t overflows;     // requests that didn't fit, ever
+        size_t heapBlocks;    // mallocs the arena has made, ever (1)
+    };
+
+    explicit FrameArena(size_t capacity = 16 * 1024);
+    ~FrameArena();
+
+    // bytes aligned to align (a power of two), or nullptr if they don't fit.
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t));
+    // End of frame: everything allocated since the last reset is gone.
+    void reset();
+
+    size_t capacity() const { return capacity_; }
+    size_t used() const { return used_; }
+    const Counters& counters() const { return counters_; }
+
+private:
+    FrameArena(const FrameArena&);
+    FrameArena& operator=(const FrameArena&);
+
+    char* base_;
+    size_t capacity_;
+    size_t used_;
+    Counters counters_;
+};
+
+// Text built in a frame arena, for drawing this frame:
+//
+//     FrameText score(arena);
+//     score << "Score: " << frame.score;
+//     renderText(renderer, font, score.c_str(), white, 10, 10);
+//
+// Its capacity is taken from the arena when it is made and never grows;
+// text past it is cut off and truncated() says so. Always null-terminated.
+// Valid until the arena is reset.
+class FrameText {
+public:
+    FrameText(FrameArena& arena, size_t capacity = 64);
+
+    FrameText& operator<<(const char* s);
+    FrameText& operator<<(const std::string& s);
+    FrameText& operator<<(char c);
+    FrameText& operator<<(int v);
+    FrameText& operator<<(long v);
+    FrameText& operator<<(long long v);
+    FrameText& operator<<(unsigned v);
+    FrameText& operator<<(unsigned long v);
+    FrameText& operator<<(double v);
+    // printf-style, appended.
+    FrameText& format(const char* fmt, ...);
+
+    const char* c_str() const { return text_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    bool truncated() const { return truncated_; }
+    void clear();
+
+private:
+    FrameText& append(const char* s, size_t n);
+    FrameText& appendf(const char* fmt, va_list args);
+
+    char* text_;
+    size_t capacity_;   // without the terminator
+    size_t size_;
+    bool truncated_;
+};
+
+#endif
@@ -0,0 +1,129 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+const size_t HISTORY = 120;
+// Adaptive vsync decides once per this many frames.
+const int VSYNC_WINDOW = 60;
+// Longest the pacer will spin at the end of a wait, in seconds.
+const double MAX_SPIN = 0.002;
+
+double seconds(FramePacer::Clock::duration d) {
+    return std::chrono::duration<double>(d).count();
+}
+
+}
+
+FramePacer::FramePacer(double targetFps)
+    : fps_(0), period_(0), maxDelta_(0.1f), spin_(true), started_(false),
+      sleepMean_(0.0005), sleepVar_(0), sleepEstimate_(0.001),
+      vsync_(false), windowFrames_(0), missed_(0), tight_(0),
+      intervals_(HISTORY, 0.0f), next_(0) {
+    setTargetFps(targetFps);
+}
+
+void FramePacer::setTargetFps(double fps) {
+    fps_ = std::max(0.0, fps);
+    period_ = fps_ > 0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps_))
+                       : Clock::duration::zero();
+}
+
+void FramePacer::useAdaptiveVsync(const std::function<void(bool)>& setVsync) {
+    setVsync_ = setVsync;
+    vsync_ = true;
+    windowFrames_ = missed_ = tight_ = 0;
+    if (setVsync_) setVsync_(true);
+}
+
+void FramePacer::waitUntil(Clock::time_point deadline) {
+    Clock::time_point now = Clock::now();
+    if (!spin_) {
+        if (deadline > now) std::this_thread::sleep_for(deadline - now);
+        return;
+    }
+    // One sleep, not many short ones: every sleep is another chance for
+    // the scheduler to wake us very late.
+    while (seconds(deadline - now) > sleepEstimate_) {
+        Clock::duration request = deadline - now - std::chrono::duration_cast<Clock::duration>(
+                                                       std::chrono::duration<double>(sleepEstimate_));
+        std::this_thread::sleep_for(request);
+        Clock::time_point woke = Clock::now();
+        // Exponentially weighted, so the estimate follows the machine's load.
+        double late = seconds(woke - now - request), delta = late - sleepMean_;
+        sleepMean_ += 0.05 * delta;
+        sleepVar_ = 0.95 * (sleepVar_ + 0.05 * delta * delta);
+        // A rare very late wakeup shouldn't have us spinning for milliseconds
+        // on every frame afterwards.
+        sleepEstimate_ = std::min(sleepMean_ + 2 * std::sqrt(sleepVar_), MAX_SPIN);
+        now = woke;
+    }
+    while (Clock::now() < deadline) {
+    }
+}
+
+void FramePacer::adaptVsync(double workSeconds, double frameSeconds) {
+    double period = seconds(period_);
+    if (!setVsync_ || period <= 0) return;
+    // With vsync on the loop time includes waiting for the refresh, so a
+    // miss shows up as an interval of two refreshes. With it off the pacer
+    // knows how long the frame's own work took.
+    if (frameSeconds > 1.5 * period) ++missed_;
+    if (workSeconds < 0.75 * period) ++tight_;
+    if (++windowFrames_ < VSYNC_WINDOW) return;
+
+    if (vsync_ && missed_ > VSYNC_WINDOW / 4) {
+        vsync_ = false;
+        setVsync_(false);
+    } else if (!vsync_ && tight_ == VSYNC_WINDOW) {
+        vsync_ = true;
+        setVsync_(true);
+    }
+    windowFrames_ = missed_ = tight_ = 0;
+}
+
+float FramePacer::tick() {
+    Clock::time_point workDone = Clock::now();
+    if (!started_) {
+        started_ = true;
+        last_ = deadline_ = workDone;
+        return 0.0f;
+    }
+
+    if (period_ > Clock::duration::zero()) {
+        // With vsync on, presenting already waited for the refresh; the
+        // pacer only caps the loop at twice the rate in case the driver
+        // ignored the request.
+        deadline_ += vsync_ ? period_ / 2 : period_;
+        // More than a frame behind: start over from now rather than
+        // rushing through frames to catch up.
+        if (deadline_ < workDone - period_) deadline_ = workDone;
+        waitUntil(deadline_);
+        if (vsync_) deadline_ = Clock::now();
+    }
+
+    Clock::time_point now = Clock::now();
+    double frame = seconds(now - last_);
+    adaptVsync(seconds(workDone - last_), frame);
+    last_ = now;
+    intervals_[next_ % HISTORY] = static_cast<float>(frame);
+    ++next_;
+    return std::min(static_cast<float>(frame), maxDelta_);
+}
+
+FramePacer::Stats FramePacer::stats() const {
+    Stats s = {std::min(next_, HISTORY), 0, 0, 0};
+    if (s.frames == 0) return s;
+    double sum = 0, sumSq = 0;
+    for (size_t i = 0; i < s.frames; ++i) {
+        double ms = intervals_[i] * 1000.0;
+        sum += ms;
+        sumSq += ms * ms;
+        s.worstMs = std::max(s.worstMs, ms);
+    }
+    s.meanMs = sum / s.frames;
+    s.jitterMs = std::sqrt(std::max(0.0, sumSq / s.frames - s.meanMs * s.meanMs));
+    return s;
+}
@@ -0,0 +1,80 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// Holds a game loop to a target frame rate and hands back the time each
+// frame took, so movement can be written per second instead of per frame.
+// It doesn't depend on any window library; call tick() once per frame,
+// right after presenting.
+//
+// Waiting is sleep-then-spin: sleep until a little before the deadline,
+// by as much as the OS has lately been waking up late, then spin the last
+// fraction of a millisecond. Sleeping alone would wake up late by however
+// coarse the scheduler is; spinning alone burns a whole core.
+//
+// With adaptive vsync the pacer also switches the display's vsync: on while
+// frames fit in a refresh, off while they keep missing it (with vsync a
+// frame that misses waits for the next refresh, halving the rate), and on
+// again once they fit with room to spare.
+class FramePacer {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Stats {
+        size_t frames;     // intervals measured (up to the last 120)
+        double meanMs;
+        double jitterMs;   // standard deviation of the intervals
+        double worstMs;
+    };
+
+    explicit FramePacer(double targetFps = 60.0);
+
+    // 0 for no limit.
+    void setTargetFps(double fps);
+    double targetFps() const { return fps_; }
+    // tick() never reports more than this, so a stalled frame (a window
+    // being dragged) doesn't move everything a long way at once.
+    void setMaxDelta(float seconds) { maxDelta_ = seconds; }
+    // Off: sleep the whole wait and accept waking up late.
+    void setSpin(bool spin) { spin_ = spin; }
+
+    // setVsync is called right away with true, then whenever the pacer
+    // decides to switch.
+    void useAdaptiveVsync(const std::function<void(bool)>& setVsync);
+    bool vsyncOn() const { return vsync_; }
+
+    // Waits out the rest of the frame; returns seconds since the last tick().
+    float tick();
+
+    Stats stats() const;
+    // How early the pacer currently stops sleeping and starts spinning.
+    double sleepEstimateMs() const { return sleepEstimate_ * 1000.0; }
+
+private:
+    void waitUntil(Clock::time_point deadline);
+    void adaptVsync(double workSeconds, double frameSeconds);
+
+    double fps_;
+    Clock::duration period_;
+    float maxDelta_;
+    bool spin_;
+    Clock::time_point last_;
+    Clock::time_point deadline_;
+    bool started_;
+
+    // Running mean and variance of how late sleeps wake up.
+    double sleepMean_, sleepVar_, sleepEstimate_;
+
+    std::function<void(bool)> setVsync_;
+    bool vsync_;
+    int windowFrames_, missed_, tight_;
+
+    std::vector<float> intervals_;   // ring of the last frame intervals
+    size_t next_;
+};
+
+#endif
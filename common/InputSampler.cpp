@@ -0,0 +1,125 @@
+#include "InputSampler.h"
+#include "AllocTracker.h"
+#include <algorithm>
+
+namespace {
+
+// On top of the measured frame time: sleeps wake up late, and a frame can
+// take a little longer than the ones before it.
+const double MARGIN_MS = 1.5;
+// Per frame; a slow frame raises the estimate at once and lets go slowly.
+const double FRAME_DECAY = 0.98;
+
+}
+
+InputSampler::InputSampler() : presses_(0), lastSample_(0), frameMs_(0.0) {
+    SDL_AddEventWatch(&InputSampler::watch, this);
+}
+
+InputSampler::~InputSampler() {
+    SDL_DelEventWatch(&InputSampler::watch, this);
+}
+
+int InputSampler::watch(void* self, SDL_Event* e) {
+    if (e->type == SDL_KEYDOWN) {
+        InputSampler* sampler = static_cast<InputSampler*>(self);
+        std::lock_guard<std::mutex> lock(sampler->stampMutex_);
+        Stamp s = {e->key.timestamp, e->key.keysym.scancode, now()};
+        sampler->stamps_.push_back(s);
+    }
+    return 0;
+}
+
+void InputSampler::track(SDL_Keycode key) {
+    tracked_.push_back(key);
+}
+
+bool InputSampler::arrivalOf(const SDL_KeyboardEvent& e, Uint64& arrived) {
+    std::lock_guard<std::mutex> lock(stampMutex_);
+    // Events leave the queue in the order they went in, so a stamp older
+    // than e belongs to a key-down that was flushed or dropped.
+    while (!stamps_.empty() && !SDL_TICKS_PASSED(stamps_.front().timestamp, e.timestamp)) {
+        stamps_.pop_front();
+    }
+    for (std::deque<Stamp>::iterator s = stamps_.begin(); s != stamps_.end(); ++s) {
+        if (s->timestamp != e.timestamp) break;
+        if (s->scancode == e.keysym.scancode) {
+            arrived = s->arrived;
+            stamps_.erase(s);
+            return true;
+        }
+    }
+    return false;
+}
+
+double InputSampler::ms(Uint64 from, Uint64 to) {
+    return static_cast<double>(static_cast<Sint64>(to - from)) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+bool InputSampler::sample() {
+    ALLOC_TAG("input");
+    events_.clear();
+    arrivals_.clear();
+    lastSample_ = now();
+    bool open = true;
+    SDL_Event e;
+    while (SDL_PollEvent(&e)) {
+        // A key-down queued before the watch was added has no stamp
+        Uint64 arrived = lastSample_;
+        if (e.type == SDL_KEYDOWN) arrivalOf(e.key, arrived);
+        if (e.type == SDL_QUIT) open = false;
+        if (e.type == SDL_KEYDOWN && !e.key.repeat &&
+            std::find(tracked_.begin(), tracked_.end(), e.key.keysym.sym) != tracked_.end()) {
+            onTheWay_.push_back({++presses_, arrived});
+        }
+        events_.push_back(e);
+        arrivals_.push_back(arrived);
+    }
+    return open;
+}
+
+bool InputSampler::sampleBefore(Uint64 deadline) {
+    double spare = ms(now(), deadline) - frameMs_ - MARGIN_MS;
+    if (spare >= 1.0) SDL_Delay(static_cast<Uint32>(spare));
+    return sample();
+}
+
+int InputSampler::latchAxis(SDL_Scancode negative, SDL_Scancode positive) {
+    SDL_PumpEvents();
+    const Uint8* keys = SDL_GetKeyboardState(NULL);
+    return (keys[positive] ? 1 : 0) - (keys[negative] ? 1 : 0);
+}
+
+void InputSampler::readyToPresent() {
+    frameMs_ = std::max(ms(lastSample_, now()), frameMs_ * FRAME_DECAY);
+}
+
+void InputSampler::presented(Uint32 shownPress) {
+    Uint64 t = now();
+
+    size_t done = 0;
+    while (done < onTheWay_.size() && onTheWay_[done].number <= shownPress) {
+        samples_.push_back(ms(onTheWay_[done].arrived, t));
+        ++done;
+    }
+    onTheWay_.erase(onTheWay_.begin(), onTheWay_.begin() + done);
+}
+
+InputSampler::Latency InputSampler::latency() const {
+    Latency l = {samples_.size(), 0, 0, 0, 0, 0};
+    if (samples_.empty()) return l;
+    std::vector<double> sorted = samples_;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0;
+    for (double v : sorted) sum += v;
+    l.meanMs = sum / sorted.size();
+    l.medianMs = sorted[sorted.size() / 2];
+    l.p95Ms = sorted[sorted.size() * 95 / 100];
+    l.p99Ms = sorted[sorted.size() * 99 / 100];
+    l.worstMs = sorted.back();
+    return l;
+}
+
+void InputSampler::resetLatency() {
+    samples_.clear();
+}
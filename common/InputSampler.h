@@ -0,0 +1,106 @@
+#ifndef INPUTSAMPLER_H
+#define INPUTSAMPLER_H
+
+#include <SDL2/SDL.h>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// Reads SDL input as late in a frame as the frame allows, and measures how
+// long a key press takes to reach the screen.
+//
+// Every key-down is stamped with the performance counter the moment SDL
+// queues it (an event watch, so it is the arrival time, not the time a
+// busy loop got round to polling). Presses of tracked keys are numbered;
+// once a present returns, presented() is told the newest press the frame
+// showed and each press up to it becomes a latency sample.
+//
+// Late sampling: sampleBefore(deadline) sleeps first and takes the events
+// only when just enough time is left to simulate, draw and present by the
+// deadline, instead of taking them and then sleeping a frame away. It
+// learns how much time that needs from readyToPresent() on the frames
+// before (not from presented(), which would count vsync's wait too).
+//
+// Late latch: latchAxis() reads the keyboard right now, for drawing, so a
+// held movement key can be shown before the simulation has run with it.
+class InputSampler {
+public:
+    struct Latency {
+        size_t samples;
+        double meanMs, medianMs, p95Ms, p99Ms, worstMs;
+    };
+
+    InputSampler();
+    ~InputSampler();
+
+    // Presses (not repeats) of key are numbered and timed to the screen.
+    void track(SDL_Keycode key);
+
+    // Takes every waiting event; false once the window has been closed.
+    bool sample();
+    // Sleeps until the time left before deadline (a performance counter
+    // value) is what a frame has lately needed from sampling to present,
+    // then samples.
+    bool sampleBefore(Uint64 deadline);
+
+    // What the last sample took, in order, and when each event arrived.
+    const std::vector<SDL_Event>& events() const { return events_; }
+    Uint64 arrival(size_t i) const { return arrivals_[i]; }
+    // As of the last sample.
+    bool held(SDL_Scancode key) const { return SDL_GetKeyboardState(NULL)[key] != 0; }
+
+    // -1, 0 or +1 from two keys as they are now. Leaves the events queued
+    // for the next sample.
+    int latchAxis(SDL_Scancode negative, SDL_Scancode positive);
+
+    // Tracked presses taken so far. A frame simulated from the input as
+    // sampled now shows every press up to this number.
+    Uint32 presses() const { return presses_; }
+    // Right before SDL_RenderPresent, with the frame drawn.
+    void readyToPresent();
+    // Right after it returns, with the newest press the frame showed.
+    void presented(Uint32 shownPress);
+
+    Latency latency() const;
+    void resetLatency();
+
+    static Uint64 now() { return SDL_GetPerformanceCounter(); }
+    static double ms(Uint64 from, Uint64 to);
+
+private:
+    struct Press {
+        Uint32 number;
+        Uint64 arrived;
+    };
+    // A key-down as the watch saw it, told apart by SDL's own timestamp
+    // and the key, since other code may flush events before we poll them.
+    struct Stamp {
+        Uint32 timestamp;
+        SDL_Scancode scancode;
+        Uint64 arrived;
+    };
+
+    InputSampler(const InputSampler&);
+    InputSampler& operator=(const InputSampler&);
+
+    static int watch(void* self, SDL_Event* e);
+    // When the key-down e was queued, or false if the watch never saw it.
+    bool arrivalOf(const SDL_KeyboardEvent& e, Uint64& arrived);
+
+    std::vector<SDL_Keycode> tracked_;
+    std::vector<SDL_Event> events_;
+    std::vector<Uint64> arrivals_;
+
+    // Filled by the watch on whichever thread queued the event
+    std::mutex stampMutex_;
+    std::deque<Stamp> stamps_;
+
+    Uint32 presses_;
+    std::vector<Press> onTheWay_;   // taken, not yet presented
+    std::vector<double> samples_;
+
+    Uint64 lastSample_;
+    double frameMs_;   // sampling to present, slowly decaying worst case
+};
+
+#endif
@@ -0,0 +1,174 @@
+#include "JobSystem.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+// Which system's queue the running thread owns, so jobs a job makes ready
+// go on the queue of the thread that will likely run them next.
+thread_local const JobSystem* currentSystem = nullptr;
+thread_local int currentQueue = 0;
+
+}
+
+const JobSystem::Job JobSystem::NONE;
+
+JobSystem::JobSystem(int threads) : pending_(0), queued_(0), stop_(false) {
+    if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 0; i < threads; ++i) {
+        queues_.emplace_back(new Queue());
+        queues_.back()->stats = ThreadStats{0.0, 0, 0};
+    }
+    for (int i = 1; i < threads; ++i) workers_.emplace_back(&JobSystem::workerLoop, this, i);
+}
+
+JobSystem::~JobSystem() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& t : workers_) t.join();
+}
+
+JobSystem::Job JobSystem::add(std::function<void()> work, const std::vector<Job>& after) {
+    Record* job;
+    Job id;
+    {
+        std::lock_guard<std::mutex> lock(graphMutex_);
+        records_.emplace_back();
+        job = &records_.back();
+        id = static_cast<Job>(records_.size() - 1);
+        job->work = std::move(work);
+        job->waiting = 0;
+        job->done = false;
+        for (Job before : after) {
+            if (before < 0 || before >= id) continue;
+            Record& r = records_[before];
+            if (r.done) continue;
+            r.dependents.push_back(job);
+            ++job->waiting;
+        }
+        // Counted before it can run, so wait() can't see zero in between
+        pending_.fetch_add(1);
+        if (job->waiting > 0) return id;
+    }
+    push(job);
+    return id;
+}
+
+JobSystem::Job JobSystem::parallelFor(int count, int grain, std::function<void(int, int)> body,
+                                      const std::vector<Job>& after) {
+    grain = std::max(grain, 1);
+    std::shared_ptr<std::function<void(int, int)>> shared(new std::function<void(int, int)>(std::move(body)));
+    std::vector<Job> chunks;
+    for (int begin = 0; begin < count; begin += grain) {
+        int end = std::min(count, begin + grain);
+        chunks.push_back(add([shared, begin, end] { (*shared)(begin, end); }, after));
+    }
+    // With nothing to do it still has to wait for after
+    return add([] {}, chunks.empty() ? after : chunks);
+}
+
+void JobSystem::push(Record* job) {
+    int q = currentSystem == this ? currentQueue : 0;
+    {
+        std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+        queues_[q]->jobs.push_back(job);
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        queued_.fetch_add(1);
+    }
+    wake_.notify_all();
+}
+
+bool JobSystem::runOne(int self) {
+    Record* job = nullptr;
+    bool stolen = false;
+    {
+        Queue& own = *queues_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+        }
+    }
+    for (int i = 1; !job && i < threads(); ++i) {
+        Queue& victim = *queues_[(self + i) % threads()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            stolen = true;
+        }
+    }
+    if (!job) return false;
+    queued_.fetch_sub(1);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    job->work();
+    ThreadStats& stats = queues_[self]->stats;
+    stats.busyMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    ++stats.jobs;
+    if (stolen) ++stats.stolen;
+
+    finish(job);
+    return true;
+}
+
+void JobSystem::finish(Record* job) {
+    std::vector<Record*> ready;
+    {
+        std::lock_guard<std::mutex> lock(graphMutex_);
+        job->done = true;
+        for (Record* d : job->dependents) {
+            if (--d->waiting == 0) ready.push_back(d);
+        }
+    }
+    for (Record* d : ready) push(d);
+    // Last, so wait() only returns once nothing touches the records
+    if (pending_.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        wake_.notify_all();
+    }
+}
+
+void JobSystem::workerLoop(int self) {
+    currentSystem = this;
+    currentQueue = self;
+    for (;;) {
+        if (runOne(self)) continue;
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this] { return stop_ || queued_.load() > 0; });
+        if (stop_) return;
+    }
+}
+
+void JobSystem::wait() {
+    const JobSystem* outerSystem = currentSystem;
+    int outerQueue = currentQueue;
+    currentSystem = this;
+    currentQueue = 0;
+    while (pending_.load() > 0) {
+        if (runOne(0)) continue;
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this] { return queued_.load() > 0 || pending_.load() == 0; });
+    }
+    currentSystem = outerSystem;
+    currentQueue = outerQueue;
+
+    std::lock_guard<std::mutex> lock(graphMutex_);
+    records_.clear();
+}
+
+std::vector<JobSystem::ThreadStats> JobSystem::stats() const {
+    std::vector<ThreadStats> out;
+    for (const std::unique_ptr<Queue>& q : queues_) out.push_back(q->stats);
+    return out;
+}
+
+void JobSystem::resetStats() {
+    for (std::unique_ptr<Queue>& q : queues_) q->stats = ThreadStats{0.0, 0, 0};
+}
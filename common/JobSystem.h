@@ -0,0 +1,106 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs a frame's work as a graph of jobs on a fixed set of threads.
+//
+// A job runs once every job it was added after has finished, so a frame's
+// update is written as its stages and what each needs: move everything,
+// then test collisions, then remove what died. Jobs that don't depend on
+// each other run side by side.
+//
+// Each thread has its own queue. A thread takes its newest job first (what
+// it just made ready is still in its cache) and, with nothing left, steals
+// the oldest job from another thread's queue. Idle workers sleep.
+//
+// The thread that creates the system adds jobs and calls wait(), which runs
+// jobs on it too until all of them have finished. With one thread there
+// are no workers and everything runs inside wait(), in dependency order.
+//
+// Results are the same whatever the thread count as long as jobs that can
+// run at the same time write to different data; parallelFor() chunks are
+// cut the same way for any number of threads, so a chunk can keep a result
+// of its own and the caller combines them in chunk order.
+class JobSystem {
+public:
+    // Valid until the next wait() returns.
+    typedef int Job;
+    static const Job NONE = -1;
+
+    struct ThreadStats {
+        double busyMs;   // running jobs since resetStats()
+        long jobs;
+        long stolen;     // of those, taken from another thread's queue
+    };
+
+    // threads counts the one calling wait(); 0 for one per core.
+    explicit JobSystem(int threads = 0);
+    ~JobSystem();
+
+    int threads() const { return static_cast<int>(queues_.size()); }
+
+    // Adds a job that runs once the jobs in after (NONE entries ignored)
+    // have finished.
+    Job add(std::function<void()> work, const std::vector<Job>& after = std::vector<Job>());
+    Job add(std::function<void()> work, Job after) { return add(std::move(work), std::vector<Job>(1, after)); }
+
+    // body(begin, end) over [0, count) in chunks of grain, after after.
+    // Returns a job that finishes when every chunk has.
+    Job parallelFor(int count, int grain, std::function<void(int begin, int end)> body,
+                    const std::vector<Job>& after = std::vector<Job>());
+    Job parallelFor(int count, int grain, std::function<void(int begin, int end)> body, Job after) {
+        return parallelFor(count, grain, std::move(body), std::vector<Job>(1, after));
+    }
+
+    // Runs jobs on this thread until every job added has finished.
+    void wait();
+
+    // One entry per thread; the calling thread is the first.
+    std::vector<ThreadStats> stats() const;
+    void resetStats();
+
+private:
+    struct Record {
+        std::function<void()> work;
+        int waiting;   // jobs it is added after that haven't finished
+        bool done;
+        std::vector<Record*> dependents;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Record*> jobs;
+        ThreadStats stats;
+    };
+
+    JobSystem(const JobSystem&);
+    JobSystem& operator=(const JobSystem&);
+
+    void workerLoop(int self);
+    bool runOne(int self);
+    void push(Record* job);
+    void finish(Record* job);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex graphMutex_;
+    std::deque<Record> records_;   // addresses stay put as it grows
+    std::atomic<int> pending_;     // added and not finished
+
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    std::atomic<int> queued_;      // in some queue, not yet taken
+    bool stop_;
+};
+
+#endif
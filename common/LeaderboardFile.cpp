@@ -0,0 +1,219 @@
+#include "LeaderboardFile.h"
+#include "ChecksumFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char MAGIC[8] = {'E', 'R', 'L', 'B', 'O', 'A', 'R', 'D'};
+const uint32_t VERSION = 1;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t count;
+    uint64_t recordsOffset;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+    uint64_t indexOffset;
+    uint32_t bodyCrc;
+    uint32_t reserved;
+};
+
+}
+
+LeaderboardFile::LeaderboardFile()
+    : base_(nullptr), mappedSize_(0), count_(0), records_(nullptr), names_(nullptr),
+      namesSize_(0), nameIndex_(nullptr) {}
+
+LeaderboardFile::~LeaderboardFile() {
+    close();
+}
+
+bool LeaderboardFile::open(const std::string& path, bool verify) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        std::cerr << "LeaderboardFile: " << path << " is too short\n";
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* map = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        std::cerr << "LeaderboardFile: cannot map " << path << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    Header h;
+    std::memcpy(&h, map, sizeof(h));
+    const char* bytes = static_cast<const char*>(map);
+    bool valid = std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                 h.version == VERSION && h.recordSize == sizeof(Record) &&
+                 h.recordsOffset == sizeof(Header) &&
+                 h.count <= (size - sizeof(Header)) / sizeof(Record) &&
+                 h.namesOffset >= h.recordsOffset + h.count * sizeof(Record) &&
+                 h.namesOffset <= size && h.namesSize <= size - h.namesOffset &&
+                 h.indexOffset >= h.namesOffset + h.namesSize && h.indexOffset % 4 == 0 &&
+                 h.indexOffset <= size && h.count <= (size - h.indexOffset) / sizeof(uint32_t);
+    if (valid && verify) {
+        valid = ChecksumFile::checksum(bytes + sizeof(Header), size - sizeof(Header)) == h.bodyCrc;
+    }
+    if (!valid) {
+        std::cerr << "LeaderboardFile: " << path << " is not a valid leaderboard\n";
+        ::munmap(map, size);
+        return false;
+    }
+
+    base_ = map;
+    mappedSize_ = size;
+    count_ = static_cast<size_t>(h.count);
+    records_ = reinterpret_cast<const Record*>(bytes + h.recordsOffset);
+    names_ = bytes + h.namesOffset;
+    namesSize_ = static_cast<size_t>(h.namesSize);
+    nameIndex_ = reinterpret_cast<const uint32_t*>(bytes + h.indexOffset);
+    // Rank scans walk the records front to back.
+    ::madvise(map, size, MADV_WILLNEED);
+    return true;
+}
+
+void LeaderboardFile::close() {
+    if (base_) ::munmap(base_, mappedSize_);
+    base_ = nullptr;
+    mappedSize_ = 0;
+    count_ = 0;
+    records_ = nullptr;
+    names_ = nullptr;
+    namesSize_ = 0;
+    nameIndex_ = nullptr;
+}
+
+long long LeaderboardFile::scoreAt(size_t rank) const {
+    return records_[rank - 1].score;
+}
+
+std::string LeaderboardFile::nameAt(size_t rank) const {
+    const Record& r = records_[rank - 1];
+    if (static_cast<size_t>(r.nameOffset) + r.nameLength > namesSize_) return std::string();
+    return std::string(nameData(r), r.nameLength);
+}
+
+std::vector<ScoreEntry> LeaderboardFile::range(size_t first, size_t count) const {
+    std::vector<ScoreEntry> out;
+    if (first == 0 || first > count_) return out;
+    size_t last = std::min(count_, first + count - 1);
+    out.reserve(last - first + 1);
+    for (size_t rank = first; rank <= last; ++rank) {
+        out.push_back(ScoreEntry{nameAt(rank), scoreAt(rank)});
+    }
+    return out;
+}
+
+size_t LeaderboardFile::rank(const std::string& name) const {
+    size_t lo = 0, hi = count_;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        uint32_t rec = nameIndex_[mid];
+        if (rec >= count_) return 0;
+        const Record& r = records_[rec];
+        if (static_cast<size_t>(r.nameOffset) + r.nameLength > namesSize_) return 0;
+
+        size_t n = std::min(name.size(), static_cast<size_t>(r.nameLength));
+        int cmp = std::memcmp(nameData(r), name.data(), n);
+        if (cmp == 0) {
+            if (r.nameLength == name.size()) return rec + 1;
+            cmp = r.nameLength < name.size() ? -1 : 1;
+        }
+        if (cmp < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return 0;
+}
+
+bool LeaderboardFile::lookup(const std::string& name, long long& score) const {
+    size_t r = rank(name);
+    if (r == 0) return false;
+    score = scoreAt(r);
+    return true;
+}
+
+void LeaderboardFile::sortByRank(std::vector<ScoreEntry>& entries) {
+    std::sort(entries.begin(), entries.end(), &LeaderboardFile::ranksBefore);
+}
+
+bool LeaderboardFile::write(const std::string& path, const std::vector<ScoreEntry>& entries) {
+    uint64_t namesSize = 0;
+    for (const ScoreEntry& e : entries) namesSize += e.name.size();
+    if (namesSize > UINT32_MAX || entries.size() > UINT32_MAX) {
+        std::cerr << "LeaderboardFile: too many names for " << path << "\n";
+        return false;
+    }
+
+    // Record numbers sorted by name so rank(name) can binary search.
+    std::vector<uint32_t> byName(entries.size());
+    for (size_t i = 0; i < byName.size(); ++i) byName[i] = static_cast<uint32_t>(i);
+    std::sort(byName.begin(), byName.end(), [&entries](uint32_t a, uint32_t b) {
+        return entries[a].name < entries[b].name;
+    });
+
+    Header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = VERSION;
+    h.recordSize = sizeof(Record);
+    h.count = entries.size();
+    h.recordsOffset = sizeof(Header);
+    h.namesOffset = h.recordsOffset + h.count * sizeof(Record);
+    h.namesSize = namesSize;
+    h.indexOffset = ChecksumFile::align8(h.namesOffset + namesSize);
+
+    ChecksumFile body;
+    if (!body.create(path, &h, sizeof(h))) {
+        std::cerr << "LeaderboardFile: writing " << path << " failed: " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    uint32_t nameOffset = 0;
+    for (const ScoreEntry& e : entries) {
+        Record r = {e.score, nameOffset, static_cast<uint32_t>(e.name.size())};
+        body.put(&r, sizeof(r));
+        nameOffset += r.nameLength;
+    }
+    for (const ScoreEntry& e : entries) body.put(e.name.data(), e.name.size());
+    body.padTo(h.indexOffset);
+    body.put(byName.data(), byName.size() * sizeof(uint32_t));
+
+    h.bodyCrc = body.bodyCrc();
+    if (!body.commit(&h)) {
+        std::cerr << "LeaderboardFile: writing " << path << " failed: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool LeaderboardFile::parseTextLine(const std::string& raw, std::string& name, long long& score) {
+    size_t last = raw.find_last_not_of(" \t\r");
+    if (last == std::string::npos) return false;
+    std::string line = raw.substr(0, last + 1);
+    size_t cut = line.find_last_of(" \t");
+    if (cut == std::string::npos) return false;
+    size_t nameEnd = line.find_last_not_of(" \t", cut);
+    if (nameEnd == std::string::npos) return false;
+    char* end = nullptr;
+    score = std::strtoll(line.c_str() + cut + 1, &end, 10);
+    if (end == line.c_str() + cut + 1) return false;
+    name = line.substr(0, nameEnd + 1);
+    return true;
+}
@@ -0,0 +1,80 @@
+#ifndef LEADERBOARDFILE_H
+#define LEADERBOARDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ScoreEntry {
+    std::string name;
+    long long score;
+};
+
+// Read-only binary leaderboard that is mmap'ed and queried in place.
+//
+// Sections after the header (framing and checksum as in ChecksumFile.h):
+//   Records   count x 16 bytes {score, nameOffset, nameLength}, in rank order
+//   Names     every player name once, back to back, no terminators
+//   NameIndex count x u32 record numbers sorted by name, for rank lookups
+//
+// Opening the file only validates the header, so access by rank is O(1) and
+// a lookup by name is a binary search, regardless of how many players there
+// are. Nothing is parsed or copied up front.
+class LeaderboardFile {
+public:
+    LeaderboardFile();
+    ~LeaderboardFile();
+
+    // With verify set the whole body is checksummed before returning.
+    bool open(const std::string& path, bool verify = false);
+    void close();
+    bool isOpen() const { return base_ != nullptr; }
+
+    size_t size() const { return count_; }
+    // rank is 1-based and must be in [1, size()].
+    long long scoreAt(size_t rank) const;
+    std::string nameAt(size_t rank) const;
+    std::vector<ScoreEntry> range(size_t first, size_t count) const;
+    std::vector<ScoreEntry> top(size_t k) const { return range(1, k); }
+
+    // 1-based rank, or 0 if the player is not in the file.
+    size_t rank(const std::string& name) const;
+    bool lookup(const std::string& name, long long& score) const;
+
+    // Writes entries (already in rank order, names unique) to path through
+    // ChecksumFile.
+    static bool write(const std::string& path, const std::vector<ScoreEntry>& entries);
+
+    // Leaderboard order: higher score first, ties by name.
+    static bool ranksBefore(const ScoreEntry& a, const ScoreEntry& b) {
+        return a.score != b.score ? a.score > b.score : a.name < b.name;
+    }
+    static void sortByRank(std::vector<ScoreEntry>& entries);
+
+    // Parses one "name score" line of the old highscores.txt format. The
+    // score is the last field, so names may contain spaces.
+    static bool parseTextLine(const std::string& line, std::string& name, long long& score);
+
+private:
+    struct Record {
+        int64_t score;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+    };
+
+    LeaderboardFile(const LeaderboardFile&);
+    LeaderboardFile& operator=(const LeaderboardFile&);
+
+    const char* nameData(const Record& r) const { return names_ + r.nameOffset; }
+
+    void* base_;
+    size_t mappedSize_;
+    size_t count_;
+    const Record* records_;
+    const char* names_;
+    size_t namesSize_;
+    const uint32_t* nameIndex_;
+};
+
+#endif
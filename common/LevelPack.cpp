@@ -0,0 +1,358 @@
+#include "LevelPack.h"
+#include "ChecksumFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace {
+
+const char MAGIC[8] = {'E', 'R', 'L', 'E', 'V', 'E', 'L', 'S'};
+const uint32_t VERSION = 1;
+const uint32_t TEXT = 0, NUMBERS = 1;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t levelSize;
+    uint32_t fieldSize;
+    uint32_t reserved;
+    uint64_t levelCount;
+    uint64_t fieldCount;
+    uint64_t numberCount;
+    uint64_t levelsOffset;
+    uint64_t fieldsOffset;
+    uint64_t numbersOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+    uint64_t indexOffset;
+    uint32_t bodyCrc;
+    uint32_t reserved2;
+};
+
+// Every distinct string is stored once.
+struct StringPool {
+    std::string bytes;
+    std::unordered_map<std::string, uint32_t> seen;
+
+    uint32_t add(const std::string& s) {
+        auto it = seen.find(s);
+        if (it != seen.end()) return it->second;
+        uint32_t offset = static_cast<uint32_t>(bytes.size());
+        bytes += s;
+        seen[s] = offset;
+        return offset;
+    }
+};
+
+bool inside(uint64_t offset, uint64_t length, uint64_t size) {
+    return offset <= size && length <= size - offset;
+}
+
+long long mtimeOf(const struct stat& st) {
+    return static_cast<long long>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+}
+
+}
+
+LevelPack::LevelPack()
+    : base_(nullptr), mappedSize_(0), mtimeNs_(0), inode_(0), levelCount_(0), levels_(nullptr),
+      fields_(nullptr), numbers_(nullptr), strings_(nullptr), nameIndex_(nullptr) {}
+
+LevelPack::~LevelPack() {
+    close();
+}
+
+bool LevelPack::open(const std::string& path, bool verify) {
+    close();
+    path_ = path;
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        std::cerr << "LevelPack: " << path << " is too short\n";
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* map = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        std::cerr << "LevelPack: cannot map " << path << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+    // Remembered even if the file turns out invalid, so a broken pack is
+    // reported once rather than on every reloadIfChanged().
+    mtimeNs_ = mtimeOf(st);
+    inode_ = static_cast<unsigned long long>(st.st_ino);
+
+    Header h;
+    std::memcpy(&h, map, sizeof(h));
+    const char* bytes = static_cast<const char*>(map);
+    bool valid = std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                 h.version == VERSION && h.levelSize == sizeof(LevelRecord) &&
+                 h.fieldSize == sizeof(FieldRecord) && h.levelsOffset == sizeof(Header) &&
+                 h.levelCount <= (size - sizeof(Header)) / sizeof(LevelRecord) &&
+                 h.fieldsOffset >= h.levelsOffset + h.levelCount * sizeof(LevelRecord) &&
+                 h.fieldsOffset % 8 == 0 && h.fieldsOffset <= size &&
+                 h.fieldCount <= (size - h.fieldsOffset) / sizeof(FieldRecord) &&
+                 h.numbersOffset >= h.fieldsOffset + h.fieldCount * sizeof(FieldRecord) &&
+                 h.numbersOffset % 8 == 0 && h.numbersOffset <= size &&
+                 h.numberCount <= (size - h.numbersOffset) / sizeof(double) &&
+                 h.stringsOffset >= h.numbersOffset + h.numberCount * sizeof(double) &&
+                 inside(h.stringsOffset, h.stringsSize, size) &&
+                 h.indexOffset >= h.stringsOffset + h.stringsSize && h.indexOffset % 4 == 0 &&
+                 h.indexOffset <= size && h.levelCount <= (size - h.indexOffset) / sizeof(uint32_t);
+
+    // Check every record once so the accessors never have to.
+    const LevelRecord* levels = reinterpret_cast<const LevelRecord*>(bytes + h.levelsOffset);
+    const FieldRecord* fields = reinterpret_cast<const FieldRecord*>(bytes + h.fieldsOffset);
+    const uint32_t* index = reinterpret_cast<const uint32_t*>(bytes + h.indexOffset);
+    for (uint64_t i = 0; valid && i < h.levelCount; ++i) {
+        const LevelRecord& l = levels[i];
+        valid = inside(l.nameOffset, l.nameLength, h.stringsSize) &&
+                inside(l.kindOffset, l.kindLength, h.stringsSize) &&
+                inside(l.firstField, l.fieldCount, h.fieldCount) && index[i] < h.levelCount;
+    }
+    for (uint64_t i = 0; valid && i < h.fieldCount; ++i) {
+        const FieldRecord& f = fields[i];
+        valid = inside(f.keyOffset, f.keyLength, h.stringsSize) &&
+                (f.type == TEXT ? inside(f.valueOffset, f.valueCount, h.stringsSize)
+                                : f.type == NUMBERS && inside(f.valueOffset, f.valueCount, h.numberCount));
+    }
+    if (valid && verify) {
+        valid = ChecksumFile::checksum(bytes + sizeof(Header), size - sizeof(Header)) == h.bodyCrc;
+    }
+    if (!valid) {
+        std::cerr << "LevelPack: " << path << " is not a valid level pack\n";
+        ::munmap(map, size);
+        return false;
+    }
+
+    base_ = map;
+    mappedSize_ = size;
+    levelCount_ = static_cast<size_t>(h.levelCount);
+    levels_ = levels;
+    fields_ = fields;
+    numbers_ = reinterpret_cast<const double*>(bytes + h.numbersOffset);
+    strings_ = bytes + h.stringsOffset;
+    nameIndex_ = index;
+    return true;
+}
+
+void LevelPack::close() {
+    if (base_) ::munmap(base_, mappedSize_);
+    base_ = nullptr;
+    mappedSize_ = 0;
+    levelCount_ = 0;
+    levels_ = nullptr;
+    fields_ = nullptr;
+    numbers_ = nullptr;
+    strings_ = nullptr;
+    nameIndex_ = nullptr;
+}
+
+void LevelPack::swap(LevelPack& other) {
+    std::swap(base_, other.base_);
+    std::swap(mappedSize_, other.mappedSize_);
+    std::swap(path_, other.path_);
+    std::swap(mtimeNs_, other.mtimeNs_);
+    std::swap(inode_, other.inode_);
+    std::swap(levelCount_, other.levelCount_);
+    std::swap(levels_, other.levels_);
+    std::swap(fields_, other.fields_);
+    std::swap(numbers_, other.numbers_);
+    std::swap(strings_, other.strings_);
+    std::swap(nameIndex_, other.nameIndex_);
+}
+
+bool LevelPack::reloadIfChanged() {
+    if (path_.empty()) return false;
+    struct stat st;
+    if (::stat(path_.c_str(), &st) != 0) return false;
+    if (mtimeOf(st) == mtimeNs_ && static_cast<unsigned long long>(st.st_ino) == inode_) return false;
+
+    LevelPack fresh;
+    bool ok = fresh.open(path_);
+    if (!ok) {
+        // Keep playing the old pack, but don't retry until the file changes again.
+        mtimeNs_ = fresh.mtimeNs_;
+        inode_ = fresh.inode_;
+        return false;
+    }
+    swap(fresh);
+    return true;
+}
+
+std::string LevelPack::name(size_t level) const {
+    const LevelRecord& l = levels_[level];
+    return std::string(strings_ + l.nameOffset, l.nameLength);
+}
+
+std::string LevelPack::kind(size_t level) const {
+    const LevelRecord& l = levels_[level];
+    return std::string(strings_ + l.kindOffset, l.kindLength);
+}
+
+bool LevelPack::equals(uint32_t offset, uint32_t length, const std::string& s) const {
+    return length == s.size() && std::memcmp(strings_ + offset, s.data(), length) == 0;
+}
+
+bool LevelPack::isKind(size_t level, const std::string& kind) const {
+    return equals(levels_[level].kindOffset, levels_[level].kindLength, kind);
+}
+
+int LevelPack::find(const std::string& name) const {
+    size_t lo = 0, hi = levelCount_;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        const LevelRecord& l = levels_[nameIndex_[mid]];
+        size_t n = std::min(name.size(), static_cast<size_t>(l.nameLength));
+        int cmp = std::memcmp(strings_ + l.nameOffset, name.data(), n);
+        if (cmp == 0) {
+            if (l.nameLength == name.size()) return static_cast<int>(nameIndex_[mid]);
+            cmp = l.nameLength < name.size() ? -1 : 1;
+        }
+        if (cmp < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return -1;
+}
+
+std::vector<size_t> LevelPack::levelsOfKind(const std::string& kind) const {
+    std::vector<size_t> out;
+    for (size_t i = 0; i < levelCount_; ++i) {
+        if (isKind(i, kind)) out.push_back(i);
+    }
+    return out;
+}
+
+// Levels have a handful of fields, so a scan beats any index.
+const LevelPack::FieldRecord* LevelPack::field(size_t level, const std::string& key) const {
+    const LevelRecord& l = levels_[level];
+    for (uint32_t i = 0; i < l.fieldCount; ++i) {
+        const FieldRecord& f = fields_[l.firstField + i];
+        if (equals(f.keyOffset, f.keyLength, key)) return &f;
+    }
+    return nullptr;
+}
+
+std::string LevelPack::text(size_t level, const std::string& key, const std::string& fallback) const {
+    const FieldRecord* f = field(level, key);
+    if (!f || f->type != TEXT) return fallback;
+    return std::string(strings_ + f->valueOffset, f->valueCount);
+}
+
+const double* LevelPack::numbers(size_t level, const std::string& key, size_t& count) const {
+    const FieldRecord* f = field(level, key);
+    if (!f || f->type != NUMBERS) {
+        count = 0;
+        return nullptr;
+    }
+    count = f->valueCount;
+    return numbers_ + f->valueOffset;
+}
+
+double LevelPack::number(size_t level, const std::string& key, size_t i, double fallback) const {
+    size_t count = 0;
+    const double* values = numbers(level, key, count);
+    return i < count ? values[i] : fallback;
+}
+
+bool LevelPack::write(const std::string& path, const std::vector<LevelDef>& levels) {
+    StringPool strings;
+    std::vector<LevelRecord> levelRecords;
+    std::vector<FieldRecord> fieldRecords;
+    std::vector<double> numbers;
+    levelRecords.reserve(levels.size());
+
+    for (const LevelDef& def : levels) {
+        LevelRecord l;
+        l.nameOffset = strings.add(def.name);
+        l.nameLength = static_cast<uint32_t>(def.name.size());
+        l.kindOffset = strings.add(def.kind);
+        l.kindLength = static_cast<uint32_t>(def.kind.size());
+        l.firstField = static_cast<uint32_t>(fieldRecords.size());
+        l.fieldCount = static_cast<uint32_t>(def.fields.size());
+        levelRecords.push_back(l);
+
+        for (const LevelField& field : def.fields) {
+            FieldRecord f;
+            std::memset(&f, 0, sizeof(f));
+            f.keyOffset = strings.add(field.key);
+            f.keyLength = static_cast<uint32_t>(field.key.size());
+            if (field.isText) {
+                f.type = TEXT;
+                f.valueOffset = strings.add(field.text);
+                f.valueCount = static_cast<uint32_t>(field.text.size());
+            } else {
+                f.type = NUMBERS;
+                f.valueOffset = static_cast<uint32_t>(numbers.size());
+                f.valueCount = static_cast<uint32_t>(field.numbers.size());
+                numbers.insert(numbers.end(), field.numbers.begin(), field.numbers.end());
+            }
+            fieldRecords.push_back(f);
+        }
+    }
+    if (strings.bytes.size() > UINT32_MAX || numbers.size() > UINT32_MAX ||
+        fieldRecords.size() > UINT32_MAX || levels.size() > UINT32_MAX) {
+        std::cerr << "LevelPack: too many levels for " << path << "\n";
+        return false;
+    }
+
+    // Level numbers sorted by name so find() can binary search.
+    std::vector<uint32_t> byName(levels.size());
+    for (size_t i = 0; i < byName.size(); ++i) byName[i] = static_cast<uint32_t>(i);
+    std::sort(byName.begin(), byName.end(), [&levels](uint32_t a, uint32_t b) {
+        return levels[a].name < levels[b].name;
+    });
+
+    Header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = VERSION;
+    h.levelSize = sizeof(LevelRecord);
+    h.fieldSize = sizeof(FieldRecord);
+    h.levelCount = levelRecords.size();
+    h.fieldCount = fieldRecords.size();
+    h.numberCount = numbers.size();
+    h.levelsOffset = sizeof(Header);
+    h.fieldsOffset = ChecksumFile::align8(h.levelsOffset + h.levelCount * sizeof(LevelRecord));
+    h.numbersOffset = ChecksumFile::align8(h.fieldsOffset + h.fieldCount * sizeof(FieldRecord));
+    h.stringsOffset = h.numbersOffset + h.numberCount * sizeof(double);
+    h.stringsSize = strings.bytes.size();
+    h.indexOffset = ChecksumFile::align8(h.stringsOffset + h.stringsSize);
+
+    ChecksumFile body;
+    if (!body.create(path, &h, sizeof(h))) {
+        std::cerr << "LevelPack: writing " << path << " failed: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    body.put(levelRecords.data(), levelRecords.size() * sizeof(LevelRecord));
+    body.padTo(h.fieldsOffset);
+    body.put(fieldRecords.data(), fieldRecords.size() * sizeof(FieldRecord));
+    body.padTo(h.numbersOffset);
+    body.put(numbers.data(), numbers.size() * sizeof(double));
+    body.put(strings.bytes.data(), strings.bytes.size());
+    body.padTo(h.indexOffset);
+    body.put(byName.data(), byName.size() * sizeof(uint32_t));
+
+    h.bodyCrc = body.bodyCrc();
+    if (!body.commit(&h)) {
+        std::cerr << "LevelPack: writing " << path << " failed: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    return true;
+}
+
+std::string LevelPack::defaultPath(const std::string& fallback) {
+    if (const char* env = std::getenv("LEVEL_PACK")) return env;
+    return fallback;
+}
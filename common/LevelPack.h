@@ -0,0 +1,114 @@
+#ifndef LEVELPACK_H
+#define LEVELPACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One named value of a level: either a text string or a list of numbers.
+struct LevelField {
+    std::string key;
+    bool isText;
+    std::string text;
+    std::vector<double> numbers;
+};
+
+struct LevelDef {
+    std::string name;
+    std::string kind;
+    std::vector<LevelField> fields;
+};
+
+// Read-only pack of puzzle levels that is mmap'ed and read in place.
+//
+// Sections after the header (framing and checksum as in ChecksumFile.h):
+//   Levels    count x 24 bytes {name, kind, first field, field count}
+//   Fields    24 bytes each {key, type, value offset, value count}
+//   Numbers   every numeric value as a double, back to back
+//   Strings   names, kinds, keys and texts once each, no terminators
+//   NameIndex count x u32 level numbers sorted by name
+//
+// open() checks every level and field record against the section bounds
+// once, so the accessors below index straight into the mapping. Nothing is
+// parsed or copied: numbers() returns a pointer into the file.
+//
+// The pack is written by levels/levelc from text sources. write() replaces
+// the file by renaming a new one over it, so a game that has the old pack
+// mapped keeps reading it until reloadIfChanged() notices the new one.
+class LevelPack {
+public:
+    LevelPack();
+    ~LevelPack();
+
+    // With verify set the whole body is checksummed before returning.
+    bool open(const std::string& path, bool verify = false);
+    void close();
+    bool isOpen() const { return base_ != nullptr; }
+    const std::string& path() const { return path_; }
+
+    // Reopens the pack if the file at path() was replaced or modified since
+    // it was opened, and returns true if it was. Pointers and strings taken
+    // from the old pack must be fetched again. A new file that fails to
+    // open is reported and the old pack stays in place.
+    bool reloadIfChanged();
+
+    size_t size() const { return levelCount_; }
+    std::string name(size_t level) const;
+    std::string kind(size_t level) const;
+    bool isKind(size_t level, const std::string& kind) const;
+    // Level number, or -1 if no level has that name.
+    int find(const std::string& name) const;
+    // Level numbers of that kind, in file order.
+    std::vector<size_t> levelsOfKind(const std::string& kind) const;
+
+    bool has(size_t level, const std::string& key) const { return field(level, key) != nullptr; }
+    // The field's text, or fallback if it is missing or numeric.
+    std::string text(size_t level, const std::string& key, const std::string& fallback = std::string()) const;
+    // The field's numbers, or nullptr (and count 0) if it is missing or text.
+    const double* numbers(size_t level, const std::string& key, size_t& count) const;
+    double number(size_t level, const std::string& key, size_t i = 0, double fallback = 0.0) const;
+
+    // Writes levels (names unique, keys unique within a level) to path
+    // through ChecksumFile.
+    static bool write(const std::string& path, const std::vector<LevelDef>& levels);
+
+    // LEVEL_PACK from the environment if set, otherwise fallback.
+    static std::string defaultPath(const std::string& fallback);
+
+private:
+    struct LevelRecord {
+        uint32_t nameOffset, nameLength;
+        uint32_t kindOffset, kindLength;
+        uint32_t firstField, fieldCount;
+    };
+    struct FieldRecord {
+        uint32_t keyOffset, keyLength;
+        uint32_t type;        // 0 text, 1 numbers
+        uint32_t valueOffset; // into strings for text, into numbers otherwise
+        uint32_t valueCount;  // bytes of text or count of numbers
+        uint32_t reserved;
+    };
+
+    LevelPack(const LevelPack&);
+    LevelPack& operator=(const LevelPack&);
+
+    void swap(LevelPack& other);
+    bool equals(uint32_t offset, uint32_t length, const std::string& s) const;
+    const FieldRecord* field(size_t level, const std::string& key) const;
+
+    void* base_;
+    size_t mappedSize_;
+    std::string path_;
+    long long mtimeNs_;
+    unsigned long long inode_;
+
+    size_t levelCount_;
+    const LevelRecord* levels_;
+    const FieldRecord* fields_;
+    const double* numbers_;
+    const char* strings_;
+    const uint32_t* nameIndex_;
+};
+
+#endif
@@ -0,0 +1,201 @@
+#include "ScoreClient.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// A stuck daemon should cost a game a short pause, not a freeze.
+const int IO_TIMEOUT_MS = 500;
+
+std::string oneLine(const std::string& name) {
+    std::string clean = name;
+    for (char& c : clean) {
+        if (c == '\n' || c == '\r') c = ' ';
+    }
+    return clean;
+}
+
+// Parses "<score> <name>".
+bool parseEntry(const std::string& line, ScoreEntry& e) {
+    char* end = nullptr;
+    e.score = std::strtoll(line.c_str(), &end, 10);
+    if (end == line.c_str() || *end != ' ') return false;
+    e.name = std::string(end + 1);
+    return true;
+}
+
+}
+
+std::string ScoreClient::defaultSocketPath() {
+    if (const char* env = std::getenv("ESCAPEROOM_SCORED")) return env;
+    if (const char* run = std::getenv("XDG_RUNTIME_DIR")) return std::string(run) + "/escaperoom-scored.sock";
+    return "/tmp/escaperoom-scored-" + std::to_string(static_cast<unsigned long>(::getuid())) + ".sock";
+}
+
+ScoreClient::ScoreClient(const std::string& fallbackBase, const std::string& socketPath)
+    : socketPath_(socketPath), fallbackBase_(fallbackBase), fd_(-1), local_(nullptr) {}
+
+ScoreClient::~ScoreClient() {
+    disconnect();
+    delete local_;
+}
+
+bool ScoreClient::connectDaemon() {
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socketPath_.size() >= sizeof(addr.sun_path)) return false;
+    std::memcpy(addr.sun_path, socketPath_.c_str(), socketPath_.size() + 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    timeval tv = {IO_TIMEOUT_MS / 1000, (IO_TIMEOUT_MS % 1000) * 1000};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+    fd_ = fd;
+    inbuf_.clear();
+    return true;
+}
+
+void ScoreClient::disconnect() {
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+    inbuf_.clear();
+}
+
+bool ScoreClient::ensureBackend() {
+    if (fd_ >= 0 || local_) return true;
+    if (connectDaemon()) return true;
+    if (fallbackBase_.empty()) return false;
+
+    local_ = new ScoreStore(fallbackBase_);
+    if (!local_->open()) {
+        delete local_;
+        local_ = nullptr;
+        return false;
+    }
+    std::cerr << "ScoreClient: score daemon not running, using " << fallbackBase_ << " directly\n";
+    return true;
+}
+
+bool ScoreClient::readLine(std::string& line) {
+    for (;;) {
+        size_t nl = inbuf_.find('\n');
+        if (nl != std::string::npos) {
+            line = inbuf_.substr(0, nl);
+            inbuf_.erase(0, nl + 1);
+            return true;
+        }
+        char buf[4096];
+        ssize_t n = ::recv(fd_, buf, sizeof(buf), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        inbuf_.append(buf, static_cast<size_t>(n));
+    }
+}
+
+bool ScoreClient::request(const std::string& line, std::string& reply) {
+    std::string msg = line + "\n";
+    int flags = 0;
+#ifdef MSG_NOSIGNAL
+    flags = MSG_NOSIGNAL;
+#endif
+    const char* p = msg.data();
+    size_t left = msg.size();
+    while (left > 0) {
+        ssize_t n = ::send(fd_, p, left, flags);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            disconnect();
+            return false;
+        }
+        p += n;
+        left -= static_cast<size_t>(n);
+    }
+
+    if (!readLine(reply)) {
+        disconnect();
+        return false;
+    }
+    if (reply.compare(0, 3, "OK ") != 0) {
+        std::cerr << "ScoreClient: " << line.substr(0, line.find(' ')) << ": " << reply << "\n";
+        return false;
+    }
+    reply.erase(0, 3);
+    return true;
+}
+
+bool ScoreClient::readEntries(const std::string& header, std::vector<ScoreEntry>& out) {
+    size_t n = std::strtoull(header.c_str(), nullptr, 10);
+    out.reserve(n);
+    std::string line;
+    for (size_t i = 0; i < n; ++i) {
+        ScoreEntry e;
+        if (!readLine(line) || !parseEntry(line, e)) {
+            disconnect();
+            return false;
+        }
+        out.push_back(e);
+    }
+    return true;
+}
+
+bool ScoreClient::submit(const std::string& name, long long points, long long* total) {
+    if (!ensureBackend()) return false;
+    if (local_) {
+        return local_->addPoints(name, points, total);
+    }
+    std::string reply;
+    if (!request("SUBMIT " + std::to_string(points) + " " + oneLine(name), reply)) return false;
+    if (total) *total = std::strtoll(reply.c_str(), nullptr, 10);
+    return true;
+}
+
+std::vector<ScoreEntry> ScoreClient::range(size_t first, size_t count) {
+    std::vector<ScoreEntry> out;
+    if (!ensureBackend()) return out;
+    if (local_) return local_->ranking().range(first, count);
+
+    std::string reply;
+    if (request("RANGE " + std::to_string(first) + " " + std::to_string(count), reply)) {
+        readEntries(reply, out);
+    }
+    return out;
+}
+
+size_t ScoreClient::rank(const std::string& name, long long* score) {
+    if (!ensureBackend()) return 0;
+    if (local_) {
+        if (score) local_->ranking().lookup(name, *score);
+        return local_->rank(name);
+    }
+    std::string reply;
+    if (!request("RANK " + oneLine(name), reply)) return 0;
+    char* end = nullptr;
+    size_t r = std::strtoull(reply.c_str(), &end, 10);
+    if (score) *score = std::strtoll(end, nullptr, 10);
+    return r;
+}
+
+size_t ScoreClient::size() {
+    if (!ensureBackend()) return 0;
+    if (local_) return local_->size();
+    std::string reply;
+    if (!request("SIZE", reply)) return 0;
+    return std::strtoull(reply.c_str(), nullptr, 10);
+}
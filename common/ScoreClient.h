@@ -0,0 +1,60 @@
+#ifndef SCORECLIENT_H
+#define SCORECLIENT_H
+
+#include "ScoreStore.h"
+#include <string>
+#include <vector>
+
+// Talks to the local score daemon (leaderboard/scored) over a Unix-domain
+// socket, so every game submits to one store instead of each rewriting its
+// own file.
+//
+// If the daemon is not running the client opens <fallbackBase> directly
+// with a ScoreStore, which locks it, so at most one game at a time works
+// without the daemon. An empty fallbackBase disables this.
+//
+// Wire protocol, one request per line:
+//   SUBMIT <points> <name>   -> OK <total>
+//   TOP <k>                  -> OK <n>, then n lines "<score> <name>"
+//   RANGE <first> <count>    -> same as TOP
+//   RANK <name>              -> OK <rank> <score>   (rank 0 if unknown)
+//   SIZE                     -> OK <players>
+// Failures are answered with "ERR <message>".
+class ScoreClient {
+public:
+    explicit ScoreClient(const std::string& fallbackBase = "highscores",
+                         const std::string& socketPath = defaultSocketPath());
+    ~ScoreClient();
+
+    // Adds points to the player's total; total receives the new value.
+    bool submit(const std::string& name, long long points, long long* total = nullptr);
+    std::vector<ScoreEntry> range(size_t first, size_t count);
+    std::vector<ScoreEntry> top(size_t k) { return range(1, k); }
+    // 1-based rank, or 0 if the player is unknown or no store is reachable.
+    size_t rank(const std::string& name, long long* score = nullptr);
+    size_t size();
+
+    bool usingDaemon() const { return fd_ >= 0; }
+
+    // $ESCAPEROOM_SCORED, else a socket in $XDG_RUNTIME_DIR or /tmp.
+    static std::string defaultSocketPath();
+
+private:
+    ScoreClient(const ScoreClient&);
+    ScoreClient& operator=(const ScoreClient&);
+
+    bool ensureBackend();
+    bool connectDaemon();
+    void disconnect();
+    bool request(const std::string& line, std::string& reply);
+    bool readLine(std::string& line);
+    bool readEntries(const std::string& header, std::vector<ScoreEntry>& out);
+
+    std::string socketPath_;
+    std::string fallbackBase_;
+    int fd_;
+    std::string inbuf_;
+    ScoreStore* local_;
+};
+
+#endif
@@ -0,0 +1,469 @@
+#include "ScoreStore.h"
+#include "ChecksumFile.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const size_t MAX_NAME_BYTES = 4096;
+
+bool readWholeFile(const std::string& path, std::string& out) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in) return false;
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    out = ss.str();
+    return true;
+}
+
+bool writeAll(int fd, const void* data, size_t len) {
+    const char* p = static_cast<const char*>(data);
+    while (len > 0) {
+        ssize_t n = ::write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+template <typename T>
+void putRaw(std::string& buf, const T& v) {
+    buf.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+template <typename T>
+bool getRaw(const std::string& buf, size_t& pos, T& v) {
+    if (pos + sizeof(T) > buf.size()) return false;
+    std::memcpy(&v, buf.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+bool fileExists(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0;
+}
+
+// Leaderboard order: higher score first, ties broken by name.
+bool ranksBefore(long long scoreA, const std::string& nameA, long long scoreB, const std::string& nameB) {
+    return scoreA != scoreB ? scoreA > scoreB : nameA < nameB;
+}
+
+}
+
+// ---------------------------------------------------------------------------
+// ScoreRanking
+
+ScoreRanking::ScoreRanking() : head_(allocNode(MAX_LEVEL)), level_(1), tailsValid_(false), rng_(0x9E3779B97F4A7C15ull) {
+    head_->score = 0;
+}
+
+ScoreRanking::~ScoreRanking() {
+    clear();
+    freeNode(head_);
+}
+
+ScoreRanking::Node* ScoreRanking::allocNode(int level) {
+    void* mem = ::operator new(sizeof(Node) + (level - 1) * sizeof(Link));
+    Node* n = new (mem) Node;
+    n->level = level;
+    for (int i = 0; i < level; ++i) n->next[i] = Link{nullptr, 0};
+    return n;
+}
+
+void ScoreRanking::freeNode(Node* node) {
+    node->~Node();
+    ::operator delete(node);
+}
+
+void ScoreRanking::clear() {
+    Node* x = head_->next[0].node;
+    while (x) {
+        Node* next = x->next[0].node;
+        freeNode(x);
+        x = next;
+    }
+    for (int i = 0; i < MAX_LEVEL; ++i) head_->next[i] = Link{nullptr, 0};
+    level_ = 1;
+    index_.clear();
+    tailsValid_ = false;
+}
+
+int ScoreRanking::randomLevel() {
+    // xorshift64; each extra level with probability 1/4
+    int lvl = 1;
+    for (;;) {
+        rng_ ^= rng_ << 13;
+        rng_ ^= rng_ >> 7;
+        rng_ ^= rng_ << 17;
+        if ((rng_ & 3) != 0 || lvl == MAX_LEVEL) break;
+        ++lvl;
+    }
+    return lvl;
+}
+
+ScoreRanking::Node* ScoreRanking::insertNode(const std::string& name, long long score) {
+    Node* update[MAX_LEVEL];
+    size_t rank[MAX_LEVEL];
+
+    Node* x = head_;
+    for (int i = level_ - 1; i >= 0; --i) {
+        rank[i] = (i == level_ - 1) ? 0 : rank[i + 1];
+        while (x->next[i].node && ranksBefore(x->next[i].node->score, x->next[i].node->name, score, name)) {
+            rank[i] += x->next[i].span;
+            x = x->next[i].node;
+        }
+        update[i] = x;
+    }
+
+    int lvl = randomLevel();
+    if (lvl > level_) {
+        for (int i = level_; i < lvl; ++i) {
+            rank[i] = 0;
+            update[i] = head_;
+            head_->next[i].span = index_.size();
+        }
+        level_ = lvl;
+    }
+
+    Node* n = allocNode(lvl);
+    n->name = name;
+    n->score = score;
+    for (int i = 0; i < lvl; ++i) {
+        n->next[i].node = update[i]->next[i].node;
+        update[i]->next[i].node = n;
+        n->next[i].span = update[i]->next[i].span - (rank[0] - rank[i]);
+        update[i]->next[i].span = (rank[0] - rank[i]) + 1;
+    }
+    for (int i = lvl; i < level_; ++i) {
+        update[i]->next[i].span++;
+    }
+    return n;
+}
+
+void ScoreRanking::eraseNode(Node* node) {
+    Node* update[MAX_LEVEL];
+    Node* x = head_;
+    for (int i = level_ - 1; i >= 0; --i) {
+        while (x->next[i].node && ranksBefore(x->next[i].node->score, x->next[i].node->name, node->score, node->name)) {
+            x = x->next[i].node;
+        }
+        update[i] = x;
+    }
+
+    for (int i = 0; i < level_; ++i) {
+        if (update[i]->next[i].node == node) {
+            update[i]->next[i].span += node->next[i].span - 1;
+            update[i]->next[i].node = node->next[i].node;
+        } else {
+            update[i]->next[i].span--;
+        }
+    }
+    while (level_ > 1 && head_->next[level_ - 1].node == nullptr) --level_;
+    freeNode(node);
+}
+
+void ScoreRanking::set(const std::string& name, long long score) {
+    auto it = index_.find(name);
+    if (it != index_.end()) {
+        if (it->second->score == score) return;
+        eraseNode(it->second);
+        index_.erase(it);
+    }
+    Node* n = insertNode(name, score);
+    index_[name] = n;
+    tailsValid_ = false;
+}
+
+bool ScoreRanking::append(const std::string& name, long long score) {
+    if (!tailsValid_) {
+        // The last node on each level is found by running right without
+        // any comparisons.
+        size_t traversed = 0;
+        Node* x = head_;
+        for (int i = MAX_LEVEL - 1; i >= 0; --i) {
+            while (i < level_ && x->next[i].node) {
+                traversed += x->next[i].span;
+                x = x->next[i].node;
+            }
+            tail_[i] = x;
+            tailRank_[i] = traversed;
+        }
+        tailsValid_ = true;
+    }
+
+    Node* last = tail_[0];
+    if (last != head_ && !ranksBefore(last->score, last->name, score, name)) return false;
+    if (index_.count(name)) return false;
+
+    size_t newRank = index_.size() + 1;
+    int lvl = randomLevel();
+    if (lvl > level_) level_ = lvl;
+
+    Node* n = allocNode(lvl);
+    n->name = name;
+    n->score = score;
+    for (int i = 0; i < lvl; ++i) {
+        tail_[i]->next[i] = Link{n, newRank - tailRank_[i]};
+        tail_[i] = n;
+        tailRank_[i] = newRank;
+    }
+    // Links that run off the end count the nodes they skip, as in insertNode().
+    for (int i = lvl; i < level_; ++i) {
+        tail_[i]->next[i].span++;
+    }
+    index_[name] = n;
+    return true;
+}
+
+bool ScoreRanking::remove(const std::string& name) {
+    auto it = index_.find(name);
+    if (it == index_.end()) return false;
+    eraseNode(it->second);
+    index_.erase(it);
+    tailsValid_ = false;
+    return true;
+}
+
+bool ScoreRanking::lookup(const std::string& name, long long& score) const {
+    auto it = index_.find(name);
+    if (it == index_.end()) return false;
+    score = it->second->score;
+    return true;
+}
+
+size_t ScoreRanking::rank(const std::string& name) const {
+    auto it = index_.find(name);
+    if (it == index_.end()) return 0;
+    const Node* target = it->second;
+
+    size_t traversed = 0;
+    const Node* x = head_;
+    for (int i = level_ - 1; i >= 0; --i) {
+        while (x->next[i].node &&
+               (x->next[i].node == target ||
+                ranksBefore(x->next[i].node->score, x->next[i].node->name, target->score, target->name))) {
+            traversed += x->next[i].span;
+            x = x->next[i].node;
+        }
+        if (x == target) return traversed;
+    }
+    return 0;
+}
+
+const ScoreRanking::Node* ScoreRanking::nodeAt(size_t rank) const {
+    size_t traversed = 0;
+    const Node* x = head_;
+    for (int i = level_ - 1; i >= 0; --i) {
+        while (x->next[i].node && traversed + x->next[i].span <= rank) {
+            traversed += x->next[i].span;
+            x = x->next[i].node;
+        }
+        if (traversed == rank) return x;
+    }
+    return nullptr;
+}
+
+std::vector<ScoreEntry> ScoreRanking::range(size_t first, size_t count) const {
+    std::vector<ScoreEntry> out;
+    if (first == 0 || first > size()) return out;
+    const Node* x = nodeAt(first);
+    for (size_t i = 0; x && i < count; ++i, x = x->next[0].node) {
+        out.push_back(ScoreEntry{x->name, x->score});
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// ScoreStore
+
+ScoreStore::ScoreStore(const std::string& basePath)
+    : base_(basePath), lockFd_(-1), logFd_(-1), logRecords_(0), compactThreshold_(4096),
+      autoSync_(true), dirty_(false) {}
+
+ScoreStore::~ScoreStore() {
+    close();
+}
+
+bool ScoreStore::open() {
+    close();
+    ranking_.clear();
+
+    // Only one process may own the files; others should go through scored.
+    lockFd_ = ::open((base_ + ".lock").c_str(), O_RDWR | O_CREAT, 0644);
+    if (lockFd_ < 0 || ::flock(lockFd_, LOCK_EX | LOCK_NB) != 0) {
+        std::cerr << "ScoreStore: " << base_ << " is in use by another process\n";
+        close();
+        return false;
+    }
+
+    bool haveSnap = fileExists(base_ + ".snap");
+    bool haveLog = fileExists(base_ + ".log");
+
+    if ((haveSnap && !loadSnapshot()) || (haveLog && !replayLog())) {
+        close();
+        return false;
+    }
+
+    logFd_ = ::open((base_ + ".log").c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (logFd_ < 0) {
+        std::cerr << "ScoreStore: cannot open " << base_ << ".log: " << std::strerror(errno) << "\n";
+        close();
+        return false;
+    }
+
+    if (!haveSnap && !haveLog && importLegacyText()) {
+        compact();
+    }
+    return true;
+}
+
+void ScoreStore::close() {
+    if (logFd_ >= 0) {
+        if (dirty_) ::fsync(logFd_);
+        ::close(logFd_);
+        logFd_ = -1;
+    }
+    if (lockFd_ >= 0) {
+        ::close(lockFd_);
+        lockFd_ = -1;
+    }
+    dirty_ = false;
+}
+
+bool ScoreStore::loadSnapshot() {
+    LeaderboardFile snap;
+    if (!snap.open(base_ + ".snap", true)) return false;
+
+    // Snapshots are stored in rank order, so each entry lands at the tail.
+    for (size_t r = 1; r <= snap.size(); ++r) {
+        std::string name = snap.nameAt(r);
+        long long score = snap.scoreAt(r);
+        if (!ranking_.append(name, score)) ranking_.set(name, score);
+    }
+    return true;
+}
+
+bool ScoreStore::replayLog() {
+    std::string data;
+    if (!readWholeFile(base_ + ".log", data)) return false;
+
+    size_t pos = 0;
+    size_t good = 0;
+    logRecords_ = 0;
+    while (pos < data.size()) {
+        uint32_t len = 0, crc = 0;
+        long long total = 0;
+        size_t rec = pos;
+        if (!getRaw(data, rec, len) || !getRaw(data, rec, crc)) break;
+        if (len < sizeof(total) || len > sizeof(total) + MAX_NAME_BYTES || rec + len > data.size()) break;
+        if (ChecksumFile::checksum(data.data() + rec, len) != crc) break;
+        getRaw(data, rec, total);
+        ranking_.set(data.substr(rec, len - sizeof(total)), total);
+        pos = rec + len - sizeof(total);
+        good = pos;
+        ++logRecords_;
+    }
+
+    if (good != data.size()) {
+        // A crash mid-append leaves a torn record at the tail; drop it.
+        std::cerr << "ScoreStore: discarding " << (data.size() - good) << " bytes of incomplete log\n";
+        if (::truncate((base_ + ".log").c_str(), static_cast<off_t>(good)) != 0) return false;
+    }
+    return true;
+}
+
+bool ScoreStore::importLegacyText() {
+    std::ifstream in((base_ + ".txt").c_str());
+    if (!in) return false;
+
+    std::string line, name;
+    long long score = 0;
+    bool any = false;
+    while (std::getline(in, line)) {
+        if (!LeaderboardFile::parseTextLine(line, name, score)) continue;
+        long long prev = 0;
+        ranking_.lookup(name, prev);
+        ranking_.set(name, prev + score);
+        any = true;
+    }
+    return any;
+}
+
+bool ScoreStore::appendRecord(const std::string& name, long long total) {
+    if (logFd_ < 0) return false;
+
+    std::string payload;
+    putRaw(payload, total);
+    payload += name;
+
+    std::string rec;
+    putRaw(rec, static_cast<uint32_t>(payload.size()));
+    putRaw(rec, ChecksumFile::checksum(payload.data(), payload.size()));
+    rec += payload;
+
+    // A failed record is cut off again, so a torn tail can't hide the
+    // records appended after it from replayLog().
+    off_t end = ::lseek(logFd_, 0, SEEK_END);
+    if (!writeAll(logFd_, rec.data(), rec.size())) {
+        std::cerr << "ScoreStore: log write failed: " << std::strerror(errno) << "\n";
+        if (end >= 0) ::ftruncate(logFd_, end);
+        return false;
+    }
+    dirty_ = true;
+    if (autoSync_ && !sync()) {
+        std::cerr << "ScoreStore: log fsync failed: " << std::strerror(errno) << "\n";
+        if (end >= 0) ::ftruncate(logFd_, end);
+        return false;
+    }
+    ++logRecords_;
+    return true;
+}
+
+bool ScoreStore::addPoints(const std::string& player, long long points, long long* total) {
+    // Cut once here, so the ranking holds the same name the log replays.
+    std::string name = player.size() > MAX_NAME_BYTES ? player.substr(0, MAX_NAME_BYTES) : player;
+    long long t = 0;
+    ranking_.lookup(name, t);
+    t += points;
+    // The ranking only changes once the record is in the log.
+    if (!appendRecord(name, t)) return false;
+    ranking_.set(name, t);
+    if (total) *total = t;
+    if (logRecords_ >= compactThreshold_) compact();
+    return true;
+}
+
+bool ScoreStore::sync() {
+    if (logFd_ < 0) return false;
+    if (!dirty_) return true;
+    if (::fsync(logFd_) != 0) return false;
+    dirty_ = false;
+    return true;
+}
+
+bool ScoreStore::compact() {
+    if (!LeaderboardFile::write(base_ + ".snap", ranking_.top(ranking_.size()))) return false;
+
+    // Records still in the log are already in the snapshot; replaying them
+    // after a crash here is harmless because they carry absolute totals.
+    if (logFd_ >= 0 && ::ftruncate(logFd_, 0) == 0) {
+        ::fsync(logFd_);
+        dirty_ = false;
+    }
+    logRecords_ = 0;
+    return true;
+}
@@ -0,0 +1,131 @@
+#ifndef SCORESTORE_H
+#define SCORESTORE_H
+
+#include "LeaderboardFile.h"
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// In-memory leaderboard: a hash index by player plus an indexable skiplist
+// ordered by score (highest first, ties by name). Updates, rank lookups and
+// access by rank are all O(log n).
+class ScoreRanking {
+public:
+    ScoreRanking();
+    ~ScoreRanking();
+
+    // Sets the player's total, inserting the player if needed.
+    void set(const std::string& name, long long score);
+    bool remove(const std::string& name);
+    // Adds a new player that ranks after everyone already present in O(1),
+    // for loading entries that are already sorted. Returns false and changes
+    // nothing if the player exists or would not be last.
+    bool append(const std::string& name, long long score);
+    void clear();
+
+    bool lookup(const std::string& name, long long& score) const;
+    // 1-based rank, or 0 if the player is unknown.
+    size_t rank(const std::string& name) const;
+    // Entries ranked first .. first+count-1 (1-based), clipped to size().
+    std::vector<ScoreEntry> range(size_t first, size_t count) const;
+    std::vector<ScoreEntry> top(size_t k) const { return range(1, k); }
+    size_t size() const { return index_.size(); }
+
+private:
+    struct Node;
+    struct Link {
+        Node* node;
+        size_t span;
+    };
+    // Links are allocated inline after the node so a traversal step touches
+    // one cache line instead of chasing a separate link array.
+    struct Node {
+        std::string name;
+        long long score;
+        int level;
+        Link next[1];
+    };
+
+    static const int MAX_LEVEL = 32;
+
+    ScoreRanking(const ScoreRanking&);
+    ScoreRanking& operator=(const ScoreRanking&);
+
+    static Node* allocNode(int level);
+    static void freeNode(Node* node);
+    int randomLevel();
+    Node* insertNode(const std::string& name, long long score);
+    void eraseNode(Node* node);
+    const Node* nodeAt(size_t rank) const;
+
+    Node* head_;
+    int level_;
+    // Last node on each level and its rank, used by append(). Any other
+    // update invalidates them.
+    Node* tail_[MAX_LEVEL];
+    size_t tailRank_[MAX_LEVEL];
+    bool tailsValid_;
+    unsigned long long rng_;
+    std::unordered_map<std::string, Node*> index_;
+};
+
+// Persistent high-score table. Every update is appended to <base>.log as a
+// checksummed record holding the player's new total, so replaying the log
+// is idempotent and a torn write at the tail is simply dropped. The log is
+// periodically folded into <base>.snap, a LeaderboardFile written to a
+// temporary file and renamed into place so a crash never leaves a
+// half-written snapshot.
+//
+// A legacy <base>.txt ("name score" per line) is imported on first open.
+// open() takes an exclusive lock on <base>.lock, so a second process that
+// tries to open the same store fails instead of interleaving writes.
+class ScoreStore {
+public:
+    explicit ScoreStore(const std::string& basePath);
+    ~ScoreStore();
+
+    bool open();
+    void close();
+
+    // Adds points to the player's total and logs it, setting *total to the
+    // new total. False (ranking unchanged) if the record couldn't be logged
+    // or, with auto sync on, fsync'ed. Names are cut to their first 4096
+    // bytes.
+    bool addPoints(const std::string& player, long long points, long long* total = nullptr);
+
+    // When enabled (the default) each update is fsync'ed before returning.
+    // Batch writers turn it off and call sync() once per batch. A failed
+    // sync() is retried by the next one.
+    void setAutoSync(bool on) { autoSync_ = on; }
+    bool sync();
+
+    // Writes a fresh snapshot and truncates the log.
+    bool compact();
+    void setCompactThreshold(size_t records) { compactThreshold_ = records; }
+
+    const ScoreRanking& ranking() const { return ranking_; }
+    std::vector<ScoreEntry> top(size_t k) const { return ranking_.top(k); }
+    size_t rank(const std::string& name) const { return ranking_.rank(name); }
+    size_t size() const { return ranking_.size(); }
+
+private:
+    ScoreStore(const ScoreStore&);
+    ScoreStore& operator=(const ScoreStore&);
+
+    bool loadSnapshot();
+    bool replayLog();
+    bool importLegacyText();
+    bool appendRecord(const std::string& name, long long total);
+
+    std::string base_;
+    int lockFd_;
+    int logFd_;
+    size_t logRecords_;
+    size_t compactThreshold_;
+    bool autoSync_;
+    bool dirty_;
+    ScoreRanking ranking_;
+};
+
+#endif
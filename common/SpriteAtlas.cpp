@@ -0,0 +1,98 @@
+#include "SpriteAtlas.h"
+#include <SDL2/SDL_image.h>
+#include <iostream>
+
+SpriteAtlas::SpriteAtlas(SDL_Renderer* renderer) : renderer_(renderer), texture_(nullptr) {}
+
+SpriteAtlas::~SpriteAtlas() {
+    unload();
+}
+
+bool SpriteAtlas::load(const std::string& tablePath) {
+    if (!table_.read(tablePath)) return false;
+    std::string image = table_.imagePath(tablePath);
+    SDL_Texture* texture = IMG_LoadTexture(renderer_, image.c_str());
+    if (!texture) {
+        std::cerr << "Atlas image " << image << ": " << IMG_GetError() << "\n";
+        table_ = AtlasTable();
+        return false;
+    }
+    if (texture_) SDL_DestroyTexture(texture_);
+    texture_ = texture;
+    return true;
+}
+
+int SpriteAtlas::add(const std::string& name, const std::string& file) {
+    Sprite s;
+    const AtlasSprite* packed = texture_ ? table_.find(name) : nullptr;
+    if (packed) {
+        s.texture = texture_;
+        s.src.x = packed->x;
+        s.src.y = packed->y;
+        s.src.w = packed->w;
+        s.src.h = packed->h;
+        s.w = packed->sourceW;
+        s.h = packed->sourceH;
+        s.own = false;
+    } else {
+        s.texture = IMG_LoadTexture(renderer_, file.c_str());
+        if (!s.texture) {
+            std::cerr << "IMG_LoadTexture Error for " << file << ": " << IMG_GetError() << "\n";
+            return -1;
+        }
+        s.src.x = s.src.y = 0;
+        SDL_QueryTexture(s.texture, NULL, NULL, &s.src.w, &s.src.h);
+        s.w = s.src.w;
+        s.h = s.src.h;
+        s.own = true;
+    }
+    sprites_.push_back(s);
+    return static_cast<int>(sprites_.size()) - 1;
+}
+
+void SpriteAtlas::clear() {
+    for (const Sprite& s : sprites_) {
+        if (s.own) SDL_DestroyTexture(s.texture);
+    }
+    sprites_.clear();
+}
+
+void SpriteAtlas::unload() {
+    clear();
+    if (texture_) SDL_DestroyTexture(texture_);
+    texture_ = nullptr;
+    table_ = AtlasTable();
+}
+
+void SpriteAtlas::draw(int id, const SDL_Rect& dst) const {
+    if (id < 0 || id >= static_cast<int>(sprites_.size())) return;
+    const Sprite& s = sprites_[id];
+    SDL_RenderCopy(renderer_, s.texture, &s.src, &dst);
+}
+
+void SpriteAtlas::draw(int id, const SDL_Rect& dst, SDL_Color tint) const {
+    if (id < 0 || id >= static_cast<int>(sprites_.size())) return;
+    const Sprite& s = sprites_[id];
+    // The texture is shared, so put the tint back for the next sprite
+    SDL_SetTextureColorMod(s.texture, tint.r, tint.g, tint.b);
+    SDL_RenderCopy(renderer_, s.texture, &s.src, &dst);
+    SDL_SetTextureColorMod(s.texture, 255, 255, 255);
+}
+
+int SpriteAtlas::width(int id) const {
+    return id < 0 || id >= static_cast<int>(sprites_.size()) ? 0 : sprites_[id].w;
+}
+
+int SpriteAtlas::height(int id) const {
+    return id < 0 || id >= static_cast<int>(sprites_.size()) ? 0 : sprites_[id].h;
+}
+
+size_t SpriteAtlas::textureCount() const {
+    std::vector<SDL_Texture*> seen;
+    for (const Sprite& s : sprites_) {
+        bool found = false;
+        for (SDL_Texture* t : seen) found = found || t == s.texture;
+        if (!found) seen.push_back(s.texture);
+    }
+    return seen.size();
+}
@@ -0,0 +1,73 @@
+#ifndef SPRITEATLAS_H
+#define SPRITEATLAS_H
+
+#include "AtlasTable.h"
+#include <SDL2/SDL.h>
+#include <string>
+#include <vector>
+
+// A game's sprites, drawn by id out of one texture: the atlas image that
+// atlas/atlasc packed, described by its AtlasTable.
+//
+//     SpriteAtlas sprites(renderer);
+//     sprites.load("../atlas/out/shooter.atlas");
+//     int ship = sprites.add("player", "assets/ship1.png");
+//     ...
+//     sprites.draw(ship, rect);
+//
+// SDL's renderer queues draws and sends consecutive copies from the same
+// texture to the GPU together, so drawing a game's sprites back to back,
+// with no text or other texture between them, costs one batch however many
+// there are.
+//
+// A sprite the atlas doesn't have (or every sprite, when there is no atlas)
+// is loaded from its own file instead, as before the atlas existed; it
+// draws the same, only in a batch of its own.
+class SpriteAtlas {
+public:
+    explicit SpriteAtlas(SDL_Renderer* renderer);
+    ~SpriteAtlas();
+
+    // False (and the sprites fall back to their files) if the table or its
+    // image can't be loaded.
+    bool load(const std::string& tablePath);
+    bool loaded() const { return texture_ != nullptr; }
+
+    // The sprite called name, from the atlas or else from file. -1 if
+    // neither has it; drawing -1 draws nothing.
+    int add(const std::string& name, const std::string& file);
+    // Forgets the added sprites (and frees their own textures), keeping the
+    // atlas, so a new set can be added.
+    void clear();
+    // Frees every texture, the atlas's too; for when the renderer is going
+    // before this is.
+    void unload();
+
+    void draw(int id, const SDL_Rect& dst) const;
+    // Multiplied by tint, as SDL_SetTextureColorMod does.
+    void draw(int id, const SDL_Rect& dst, SDL_Color tint) const;
+
+    // The sprite's original image size, whatever size it was packed at.
+    int width(int id) const;
+    int height(int id) const;
+    // Textures the added sprites come from: 1 when the atlas has them all.
+    size_t textureCount() const;
+
+private:
+    struct Sprite {
+        SDL_Texture* texture;
+        SDL_Rect src;
+        int w, h;
+        bool own;   // loaded from its own file, freed with it
+    };
+
+    SpriteAtlas(const SpriteAtlas&);
+    SpriteAtlas& operator=(const SpriteAtlas&);
+
+    SDL_Renderer* renderer_;
+    SDL_Texture* texture_;
+    AtlasTable table_;
+    std::vector<Sprite> sprites_;
+};
+
+#endif
@@ -0,0 +1,211 @@
+#include "TextField.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+// Length of the UTF-8 sequence introduced by lead byte c (1 for invalid bytes,
+// so malformed input still advances).
+size_t utf8SeqLen(unsigned char c) {
+    if (c < 0x80) return 1;
+    if ((c >> 5) == 0x6) return 2;
+    if ((c >> 4) == 0xE) return 3;
+    if ((c >> 3) == 0x1E) return 4;
+    return 1;
+}
+
+Uint32 utf8Decode(const char* s, size_t len) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(s);
+    switch (len) {
+        case 2: return ((p[0] & 0x1F) << 6) | (p[1] & 0x3F);
+        case 3: return ((p[0] & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+        case 4: return ((p[0] & 0x07) << 18) | ((p[1] & 0x3F) << 12) | ((p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+        default: return p[0];
+    }
+}
+
+}
+
+TextField::TextField(SDL_Renderer* renderer, TTF_Font* font, SDL_Color color, SDL_Rect box, size_t maxBytes)
+    : renderer_(renderer), font_(font), color_(color), box_(box), maxBytes_(maxBytes),
+      lineHeight_(TTF_FontHeight(font)), backing_(nullptr), submitted_(false) {
+    if (box_.h < lineHeight_) box_.h = lineHeight_;
+
+    backing_ = SDL_CreateTexture(renderer_, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, box_.w, box_.h);
+    if (backing_) {
+        // Glyphs blended into the transparent backing leave it with
+        // premultiplied color, so it goes to the screen as such.
+        SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+            SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+        SDL_SetTextureBlendMode(backing_, premultiplied);
+        clearSpan(0, box_.w);
+    } else {
+        std::cerr << "TextField: no render target support, drawing glyphs directly: " << SDL_GetError() << "\n";
+    }
+}
+
+TextField::~TextField() {
+    for (auto& entry : glyphs_) {
+        if (entry.second.tex) SDL_DestroyTexture(entry.second.tex);
+    }
+    if (backing_) SDL_DestroyTexture(backing_);
+}
+
+const TextField::Glyph* TextField::glyphFor(Uint32 codepoint, const char* utf8, size_t len) {
+    auto it = glyphs_.find(codepoint);
+    if (it != glyphs_.end()) return &it->second;
+
+    std::string one(utf8, len);
+    Glyph g = {nullptr, 0, 0, 0};
+    TTF_SizeUTF8(font_, one.c_str(), &g.advance, nullptr);
+
+    SDL_Surface* surface = TTF_RenderUTF8_Blended(font_, one.c_str(), color_);
+    if (surface) {
+        g.tex = SDL_CreateTextureFromSurface(renderer_, surface);
+        g.w = surface->w;
+        g.h = surface->h;
+        SDL_FreeSurface(surface);
+        // Blended, not copied: a glyph wider than its advance overhangs the
+        // next cell, and copying that cell's transparent pixels would cut
+        // the overhang off.
+        if (g.tex) SDL_SetTextureBlendMode(g.tex, SDL_BLENDMODE_BLEND);
+    }
+    return &glyphs_.emplace(codepoint, g).first->second;
+}
+
+int TextField::penX() const {
+    return cells_.empty() ? 0 : cells_.back().x + cells_.back().glyph->advance;
+}
+
+void TextField::clearSpan(int x0, int x1) {
+    if (!backing_ || x1 <= x0) return;
+    SDL_Texture* prevTarget = SDL_GetRenderTarget(renderer_);
+    SDL_BlendMode prevBlend;
+    Uint8 r, g, b, a;
+    SDL_GetRenderDrawBlendMode(renderer_, &prevBlend);
+    SDL_GetRenderDrawColor(renderer_, &r, &g, &b, &a);
+
+    SDL_SetRenderTarget(renderer_, backing_);
+    SDL_SetRenderDrawBlendMode(renderer_, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 0);
+    SDL_Rect span = {x0, 0, x1 - x0, box_.h};
+    SDL_RenderFillRect(renderer_, &span);
+
+    SDL_SetRenderTarget(renderer_, prevTarget);
+    SDL_SetRenderDrawBlendMode(renderer_, prevBlend);
+    SDL_SetRenderDrawColor(renderer_, r, g, b, a);
+}
+
+void TextField::drawCells(size_t first) {
+    if (!backing_ || first >= cells_.size()) return;
+    SDL_Texture* prevTarget = SDL_GetRenderTarget(renderer_);
+    SDL_SetRenderTarget(renderer_, backing_);
+    for (size_t i = first; i < cells_.size(); ++i) {
+        const Glyph* g = cells_[i].glyph;
+        if (!g->tex) continue;
+        SDL_Rect dst = {cells_[i].x, 0, g->w, g->h};
+        SDL_RenderCopy(renderer_, g->tex, NULL, &dst);
+    }
+    SDL_SetRenderTarget(renderer_, prevTarget);
+}
+
+void TextField::redrawAll() {
+    clearSpan(0, box_.w);
+    drawCells(0);
+}
+
+bool TextField::append(const char* utf8) {
+    size_t first = cells_.size();
+    int x = penX();
+    for (const char* p = utf8; *p; ) {
+        size_t len = utf8SeqLen(static_cast<unsigned char>(*p));
+        for (size_t k = 1; k < len; ++k) {
+            if (p[k] == '\0') { len = k; break; }
+        }
+        if (text_.size() + len > maxBytes_) break;
+
+        const Glyph* g = glyphFor(utf8Decode(p, len), p, len);
+        if (x + g->advance > box_.w) break;
+
+        cells_.push_back(Cell{text_.size(), len, x, g});
+        text_.append(p, len);
+        x += g->advance;
+        p += len;
+    }
+    drawCells(first);
+    return cells_.size() != first;
+}
+
+bool TextField::eraseLast() {
+    if (cells_.empty()) return false;
+    Cell last = cells_.back();
+    cells_.pop_back();
+    text_.erase(last.byteOffset);
+
+    // A glyph can be wider than its advance (italics, 'f', 'j'), so clear
+    // all of it. Cells it overlapped lose their overhang to the clear and
+    // are drawn again from their left edge.
+    int x0 = last.x;
+    int x1 = last.x + std::max(last.glyph->advance, last.glyph->w);
+    size_t first = cells_.size();
+    while (first > 0 && cells_[first - 1].x + cells_[first - 1].glyph->w > x0) {
+        --first;
+        x0 = cells_[first].x;
+        x1 = std::max(x1, x0 + cells_[first].glyph->w);
+    }
+    clearSpan(x0, x1);
+    drawCells(first);
+    return true;
+}
+
+bool TextField::handleEvent(const SDL_Event& e) {
+    if (e.type == SDL_TEXTINPUT) {
+        return append(e.text.text);
+    }
+    if (e.type == SDL_KEYDOWN) {
+        SDL_Keycode key = e.key.keysym.sym;
+        if (key == SDLK_BACKSPACE) return eraseLast();
+        if ((key == SDLK_RETURN || key == SDLK_KP_ENTER) && !text_.empty()) submitted_ = true;
+        return false;
+    }
+    if (e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET) {
+        redrawAll();
+    }
+    return false;
+}
+
+void TextField::setText(const std::string& text) {
+    cells_.clear();
+    text_.clear();
+    clearSpan(0, box_.w);
+    append(text.c_str());
+}
+
+void TextField::clear() {
+    setText("");
+    submitted_ = false;
+}
+
+void TextField::setPosition(int x, int y) {
+    box_.x = x;
+    box_.y = y;
+}
+
+void TextField::render(bool showCaret) {
+    if (backing_) {
+        SDL_RenderCopy(renderer_, backing_, NULL, &box_);
+    } else {
+        for (const Cell& c : cells_) {
+            if (!c.glyph->tex) continue;
+            SDL_Rect dst = {box_.x + c.x, box_.y, c.glyph->w, c.glyph->h};
+            SDL_RenderCopy(renderer_, c.glyph->tex, NULL, &dst);
+        }
+    }
+
+    if (showCaret && (SDL_GetTicks() / 500) % 2 == 0) {
+        SDL_Rect caret = {box_.x + penX() + 1, box_.y + 2, 2, box_.h - 4};
+        SDL_SetRenderDrawColor(renderer_, color_.r, color_.g, color_.b, 255);
+        SDL_RenderFillRect(renderer_, &caret);
+    }
+}
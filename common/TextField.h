@@ -0,0 +1,78 @@
+#ifndef TEXTFIELD_H
+#define TEXTFIELD_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Single-line text input shared by the name and answer prompts.
+//
+// Every codepoint is rasterized once into a cached glyph texture and the
+// laid-out string lives in a backing texture. A keystroke only draws the
+// appended glyphs (or clears the erased ones) into that texture, so the cost
+// of typing does not depend on how long the string already is.
+class TextField {
+public:
+    TextField(SDL_Renderer* renderer, TTF_Font* font, SDL_Color color, SDL_Rect box, size_t maxBytes = 64);
+    ~TextField();
+
+    // Handles SDL_TEXTINPUT, backspace and enter. Returns true if the text changed.
+    bool handleEvent(const SDL_Event& e);
+
+    // Draws the field at its box; the caret blinks at the end of the text.
+    void render(bool showCaret = true);
+
+    const std::string& text() const { return text_; }
+    void setText(const std::string& text);
+    void clear();
+
+    // Set when enter is pressed on non-empty text, until resetSubmitted().
+    bool submitted() const { return submitted_; }
+    void resetSubmitted() { submitted_ = false; }
+
+    const SDL_Rect& box() const { return box_; }
+    void setPosition(int x, int y);
+
+private:
+    struct Glyph {
+        SDL_Texture* tex;
+        int w, h;
+        int advance;
+    };
+
+    struct Cell {
+        size_t byteOffset;
+        size_t byteLen;
+        int x;
+        const Glyph* glyph;
+    };
+
+    TextField(const TextField&);
+    TextField& operator=(const TextField&);
+
+    const Glyph* glyphFor(Uint32 codepoint, const char* utf8, size_t len);
+    bool append(const char* utf8);
+    bool eraseLast();
+    void drawCells(size_t first);
+    void clearSpan(int x0, int x1);
+    void redrawAll();
+    int penX() const;
+
+    SDL_Renderer* renderer_;
+    TTF_Font* font_;
+    SDL_Color color_;
+    SDL_Rect box_;
+    size_t maxBytes_;
+    int lineHeight_;
+
+    std::string text_;
+    std::vector<Cell> cells_;
+    std::unordered_map<Uint32, Glyph> glyphs_;
+    SDL_Texture* backing_;
+
+    bool submitted_;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+// Hands the newest of a stream of values from one thread to another
+// without locks and without either side ever waiting for the other.
+//
+// There are three slots. The producer writes into its back slot and
+// publish() swaps it with the middle one; the consumer's update() swaps the
+// middle one with its front slot if something new was published since. A
+// value is never written while the consumer can see it, so front() stays
+// as it was until the next update(). Values the consumer was too slow for
+// are skipped, never queued.
+//
+// Slots are reused, not reallocated: a T holding vectors keeps their
+// capacity, so steady-state publishing doesn't allocate.
+//
+// One producer thread and one consumer thread.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : back_(0), middle_(1), front_(2) {}
+
+    // Producer: the slot to fill, then publish() it. It holds whatever was
+    // published two or more times ago, so write every field.
+    T& back() { return slots_[back_]; }
+    void publish() {
+        back_ = middle_.exchange(back_ | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    // Consumer: true if something was published since the last call, and
+    // front() now holds the newest.
+    bool update() {
+        if (!(middle_.load(std::memory_order_relaxed) & FRESH)) return false;
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+    const T& front() const { return slots_[front_]; }
+
+private:
+    static const int INDEX = 3;
+    static const int FRESH = 4;   // set in middle_ by publish(), cleared by update()
+
+    TripleBuffer(const TripleBuffer&);
+    TripleBuffer& operator=(const TripleBuffer&);
+
+    T slots_[3];
+    int back_;                 // producer's
+    std::atomic<int> middle_;  // slot number, plus FRESH
+    int front_;                // consumer's
+};
+
+#endif
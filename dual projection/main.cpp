@@ -2,8 +2,11 @@
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_image.h>
 #include <cmath>
+#include "FrameArena.h"
+#include "FontCache.h"
+#include "AllocTracker.h"
+#include <iostream>
 #include <string>
-#include <sstream>
 #include <algorithm>
 #include <cctype>
 
@@ -67,14 +70,14 @@ void drawPoint(SDL_Renderer* ren, const Vec2& v, SDL_Color col, int rad=6) {
             SDL_RenderDrawPoint(ren, sx+dx, sy+dy);
 }
 
-void renderText(SDL_Renderer* ren, TTF_Font* font, const std::string& text, SDL_Color color, int x, int y) {
-    SDL_Surface* surf = TTF_RenderUTF8_Blended(font, text.c_str(), color);
-    if (!surf) return;
-    SDL_Texture* tex = SDL_CreateTextureFromSurface(ren, surf);
-    SDL_Rect dst = {x, y, surf->w, surf->h};
-    SDL_RenderCopy(ren, tex, NULL, &dst);
-    SDL_FreeSurface(surf);
-    SDL_DestroyTexture(tex);
+// Straight from the font's glyph atlas: no surface or texture per string.
+void renderText(const FontCache& font, const char* text, SDL_Color color, int x, int y) {
+    ALLOC_TAG("text");
+    font.draw(text, color, x, y);
+}
+
+void renderText(const FontCache& font, const std::string& text, SDL_Color color, int x, int y) {
+    renderText(font, text.c_str(), color, x, y);
 }
 
 // Parses x,y (handles extra spaces, disallows floats or nonsense).
@@ -110,13 +113,18 @@ Vec2 project(const Vec2& y, const Vec2& u) {
 }
 
 int main(int argc, char* argv[]) {
+    Uint64 startup = SDL_GetPerformanceCounter();
+    ALLOC_TRACK_START("dual projection");
+    ALLOC_TRACK_SDL();
     SDL_Init(SDL_INIT_VIDEO);
     TTF_Init();
     IMG_Init(IMG_INIT_PNG);
 
     SDL_Window* win = SDL_CreateWindow("Standard Basis Projection Game", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WIDTH, HEIGHT, 0);
     SDL_Renderer* ren = SDL_CreateRenderer(win, -1, SDL_RENDERER_ACCELERATED);
-    TTF_Font* font = TTF_OpenFont("DejaVuSans.ttf", 20);
+    // Glyphs mapped from the font cache after the first run.
+    FontCache font(ren);
+    if (font.open("DejaVuSans.ttf", 20) || font.open("ARIAL.TTF", 20)) font.printReport(std::cout);
 
     // Load background (optional)
     SDL_Texture* bgTex = nullptr;
@@ -144,8 +152,12 @@ int main(int argc, char* argv[]) {
     std::string user_input;
     Vec2 user_y1, user_y2;
     std::string input_error;
+    FrameArena arena(2048);
+    bool firstFrame = true;
 
     while (running) {
+        // Last frame's text is on screen by now
+        arena.reset();
         SDL_Event e;
         while (SDL_PollEvent(&e)) {
             if (e.type == SDL_QUIT) running = false;
@@ -224,28 +236,34 @@ int main(int argc, char* argv[]) {
             SDL_RenderDrawLine(ren, GRID_ORIGIN_X, GRID_ORIGIN_Y - yidx*CELL, GRID_ORIGIN_X + COLS*CELL, GRID_ORIGIN_Y - yidx*CELL);
 
         // Axis labels
-        for (int x = 0; x < COLS; ++x)
-            renderText(ren, font, std::to_string(x), {170,170,255,180}, GRID_ORIGIN_X + x*CELL + 10, GRID_ORIGIN_Y + 8);
-        for (int yidx = 0; yidx < ROWS; ++yidx)
-            renderText(ren, font, std::to_string(yidx), {170,170,255,180}, GRID_ORIGIN_X - 28, GRID_ORIGIN_Y - yidx*CELL - 3);
+        for (int x = 0; x < COLS; ++x) {
+            FrameText label(arena, 8);
+            label << x;
+            renderText(font, label.c_str(), {170,170,255,180}, GRID_ORIGIN_X + x*CELL + 10, GRID_ORIGIN_Y + 8);
+        }
+        for (int yidx = 0; yidx < ROWS; ++yidx) {
+            FrameText label(arena, 8);
+            label << yidx;
+            renderText(font, label.c_str(), {170,170,255,180}, GRID_ORIGIN_X - 28, GRID_ORIGIN_Y - yidx*CELL - 3);
+        }
 
         // Draw axes with arrowheads and label
         drawArrow(ren, {0,0}, {COLS-1,0}, {240,240,255,255}, 6);
         drawArrow(ren, {0,0}, {0,ROWS-1}, {240,240,255,255}, 6);
-        renderText(ren, font, "x", {220,220,255,255}, GRID_ORIGIN_X + (COLS-1)*CELL + 20, GRID_ORIGIN_Y + 10);
-        renderText(ren, font, "y", {220,220,255,255}, GRID_ORIGIN_X - 18, GRID_ORIGIN_Y - (ROWS-1)*CELL - 20);
-        renderText(ren, font, "O", {255,255,255,220}, GRID_ORIGIN_X-25, GRID_ORIGIN_Y+8);
+        renderText(font, "x", {220,220,255,255}, GRID_ORIGIN_X + (COLS-1)*CELL + 20, GRID_ORIGIN_Y + 10);
+        renderText(font, "y", {220,220,255,255}, GRID_ORIGIN_X - 18, GRID_ORIGIN_Y - (ROWS-1)*CELL - 20);
+        renderText(font, "O", {255,255,255,220}, GRID_ORIGIN_X-25, GRID_ORIGIN_Y+8);
 
         // Draw basis vectors with big arrowheads
         drawArrow(ren, {0,0}, u1_vis, {255,120,40,255}, 8);
         drawArrow(ren, {0,0}, u2_vis, {60,200,255,255}, 8);
-        renderText(ren, font, "u1", {255,120,40,255}, GRID_ORIGIN_X + int(u1_vis.x*CELL) + 15, GRID_ORIGIN_Y - int(u1_vis.y*CELL) - 25);
-        renderText(ren, font, "u2", {60,200,255,255}, GRID_ORIGIN_X + int(u2_vis.x*CELL) + 15, GRID_ORIGIN_Y - int(u2_vis.y*CELL) - 25);
+        renderText(font, "u1", {255,120,40,255}, GRID_ORIGIN_X + int(u1_vis.x*CELL) + 15, GRID_ORIGIN_Y - int(u1_vis.y*CELL) - 25);
+        renderText(font, "u2", {60,200,255,255}, GRID_ORIGIN_X + int(u2_vis.x*CELL) + 15, GRID_ORIGIN_Y - int(u2_vis.y*CELL) - 25);
 
         // y vector (player)
         drawArrow(ren, {0,0}, y, {90,255,100,255}, 5);
         drawPoint(ren, y, {90,255,100,255}, 9);
-        renderText(ren, font, "y", {90,255,100,255}, GRID_ORIGIN_X + int(y.x*CELL)+13, GRID_ORIGIN_Y - int(y.y*CELL) - 22);
+        renderText(font, "y", {90,255,100,255}, GRID_ORIGIN_X + int(y.x*CELL)+13, GRID_ORIGIN_Y - int(y.y*CELL) - 22);
 
         if (show_proj) {
             drawPoint(ren, y1, {255,120,40,255}, 10);
@@ -260,11 +278,11 @@ int main(int argc, char* argv[]) {
             SDL_RenderDrawLine(ren, cx, cy, bx, by);
             SDL_RenderDrawLine(ren, ax, ay, cx, cy);
 
-            renderText(ren, font, "y1: proj onto u1", {255,120,40,255}, WIDTH-340, 70);
-            renderText(ren, font, "y2: proj onto u2", {60,200,255,255}, WIDTH-340, 100);
-            renderText(ren, font, "ENTER: submit projection coords", {220,220,220,120}, 32, 32);
+            renderText(font, "y1: proj onto u1", {255,120,40,255}, WIDTH-340, 70);
+            renderText(font, "y2: proj onto u2", {60,200,255,255}, WIDTH-340, 100);
+            renderText(font, "ENTER: submit projection coords", {220,220,220,120}, 32, 32);
         } else {
-            renderText(ren, font, "SPACE: show projections", {220,220,220,120}, 32, 32);
+            renderText(font, "SPACE: show projections", {220,220,220,120}, 32, 32);
         }
 
         // Timer bar
@@ -273,32 +291,35 @@ int main(int argc, char* argv[]) {
             SDL_SetRenderDrawColor(ren, 0, 200, 255, 230);
             SDL_Rect bar = {80, 14, bar_w, 16};
             SDL_RenderFillRect(ren, &bar);
-            std::string timer_str = "Time left: " + std::to_string(sec_left) + "s";
-            renderText(ren, font, timer_str, {255,255,255,255}, WIDTH-170, 12);
+            FrameText timer_str(arena);
+            timer_str << "Time left: " << sec_left << "s";
+            renderText(font, timer_str.c_str(), {255,255,255,255}, WIDTH-170, 12);
         } else {
-            renderText(ren, font, "Time's Up!", {255, 60, 60, 255}, WIDTH/2-70, 16);
+            renderText(font, "Time's Up!", {255, 60, 60, 255}, WIDTH/2-70, 16);
         }
 
-        std::ostringstream oss;
-        oss << "y = (" << int(y.x) << ", " << int(y.y) << ")";
-        renderText(ren, font, oss.str(), {220,255,180,255}, WIDTH-340, 150);
+        FrameText yText(arena);
+        yText << "y = (" << int(y.x) << ", " << int(y.y) << ")";
+        renderText(font, yText.c_str(), {220,255,180,255}, WIDTH-340, 150);
 
         // Input mode with robust message and error
         if (input_mode) {
             SDL_Rect overlay = {100, 220, WIDTH-200, 160};
             SDL_SetRenderDrawColor(ren, 30,30,50,210);
             SDL_RenderFillRect(ren, &overlay);
-            renderText(ren, font, "Enter y1 and y2 projection coords as x,y", {255,255,255,255}, 120, 240);
+            renderText(font, "Enter y1 and y2 projection coords as x,y", {255,255,255,255}, 120, 240);
             if (input_stage == 1)
-                renderText(ren, font, "y1 (onto u1): ", {255,120,40,255}, 120, 270);
+                renderText(font, "y1 (onto u1): ", {255,120,40,255}, 120, 270);
             else
-                renderText(ren, font, "y2 (onto u2): ", {60,200,255,255}, 120, 270);
+                renderText(font, "y2 (onto u2): ", {60,200,255,255}, 120, 270);
 
-            renderText(ren, font, user_input+"|", {250,250,180,255}, 320, 270);
-            renderText(ren, font, "(format: x,y)", {210,210,210,120}, 520, 270);
+            FrameText typed(arena, 128);
+            typed << user_input << "|";
+            renderText(font, typed.c_str(), {250,250,180,255}, 320, 270);
+            renderText(font, "(format: x,y)", {210,210,210,120}, 520, 270);
             if (!input_error.empty())
-                renderText(ren, font, input_error, {255,50,80,255}, 120, 310);
-            renderText(ren, font, "ESC to cancel", {150,160,180,120}, 120, 350);
+                renderText(font, input_error, {255,50,80,255}, 120, 310);
+            renderText(font, "ESC to cancel", {150,160,180,120}, 120, 350);
         }
 
         // WIN/LOSE message and auto-exit
@@ -307,14 +328,15 @@ int main(int argc, char* argv[]) {
             SDL_SetRenderDrawColor(ren, winFlag ? 10 : 60, winFlag ? 120 : 30, winFlag ? 30 : 50, 210);
             SDL_RenderFillRect(ren, &overlay);
             if (winFlag) {
-                renderText(ren, font, "WIN! Projections are correct!", {255,255,120,255}, WIDTH/2-120, HEIGHT/2-10);
+                renderText(font, "WIN! Projections are correct!", {255,255,120,255}, WIDTH/2-120, HEIGHT/2-10);
                 SDL_RenderPresent(ren);
+                ALLOC_FRAME();
                 SDL_Delay(1800); // Show the win message for 1.8 seconds
                 running = false; // End the game loop
                 continue;
             } else {
-                renderText(ren, font, "Incorrect. Try Again!", {255,80,80,255}, WIDTH/2-120, HEIGHT/2-10);
-                renderText(ren, font, "Press ENTER to continue", {220,220,220,180}, WIDTH/2-120, HEIGHT/2+20);
+                renderText(font, "Incorrect. Try Again!", {255,80,80,255}, WIDTH/2-120, HEIGHT/2-10);
+                renderText(font, "Press ENTER to continue", {220,220,220,180}, WIDTH/2-120, HEIGHT/2+20);
                 SDL_Event e2;
                 while (SDL_PollEvent(&e2)) {
                     if (e2.type == SDL_KEYDOWN && e2.key.keysym.sym == SDLK_RETURN) {
@@ -326,6 +348,12 @@ int main(int argc, char* argv[]) {
         }
 
         SDL_RenderPresent(ren);
+        ALLOC_FRAME();
+        if (firstFrame) {
+            firstFrame = false;
+            std::cout << "First frame after "
+                      << (SDL_GetPerformanceCounter() - startup) * 1000.0 / SDL_GetPerformanceFrequency() << " ms\n";
+        }
         SDL_Delay(16);
 
         // Enable text input in input mode only
@@ -336,7 +364,7 @@ int main(int argc, char* argv[]) {
     }
 
     if (bgTex) SDL_DestroyTexture(bgTex);
-    TTF_CloseFont(font);
+    font.close();
     SDL_DestroyRenderer(ren);
     SDL_DestroyWindow(win);
     TTF_Quit();
@@ -0,0 +1,119 @@
+// Loads the same leaderboard from text and from the binary format and
+// reports how long it takes before the top scores and one player's rank
+// can be shown.
+//
+//   lb_bench [records] [workdir]     (defaults: 10000000 records, /tmp)
+//
+// Both files are read once before timing, so the numbers compare parsing
+// against mapping with a warm page cache rather than disk speed.
+#include "LeaderboardFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void warm(const std::string& path) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    std::vector<char> buf(1 << 20);
+    while (in.read(buf.data(), buf.size()) || in.gcount() > 0) {}
+}
+
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    std::string dir = argc > 2 ? argv[2] : "/tmp";
+    std::string textPath = dir + "/lb_bench.txt";
+    std::string binPath = dir + "/lb_bench.lb";
+    if (count == 0) count = 1;
+
+    std::cout << "generating " << count << " players\n";
+    std::vector<ScoreEntry> entries;
+    entries.reserve(count);
+    std::mt19937 rng(42);
+    for (size_t i = 0; i < count; ++i) {
+        entries.push_back(ScoreEntry{"player" + std::to_string(i), static_cast<long long>(rng() % 1000000)});
+    }
+    std::string probe = entries[count / 2].name;
+
+    {
+        std::ofstream out(textPath.c_str());
+        for (const ScoreEntry& e : entries) out << e.name << " " << e.score << "\n";
+    }
+    LeaderboardFile::sortByRank(entries);
+    Clock::time_point t = Clock::now();
+    if (!LeaderboardFile::write(binPath, entries)) return 1;
+    std::cout << "binary write: " << msSince(t) << " ms\n";
+    entries.clear();
+    entries.shrink_to_fit();
+
+    warm(textPath);
+    warm(binPath);
+
+    // Text: what menu.cpp used to do, parse every line and then rank.
+    t = Clock::now();
+    std::vector<ScoreEntry> parsed;
+    {
+        std::ifstream in(textPath.c_str());
+        std::string name;
+        long long score;
+        while (in >> name >> score) parsed.push_back(ScoreEntry{name, score});
+    }
+    double parseMs = msSince(t);
+    std::partial_sort(parsed.begin(), parsed.begin() + std::min<size_t>(10, parsed.size()), parsed.end(),
+                      &LeaderboardFile::ranksBefore);
+    long long probeScore = 0;
+    for (const ScoreEntry& e : parsed) {
+        if (e.name == probe) { probeScore = e.score; break; }
+    }
+    size_t probeRank = 1;
+    for (const ScoreEntry& e : parsed) {
+        if (LeaderboardFile::ranksBefore(e, ScoreEntry{probe, probeScore})) ++probeRank;
+    }
+    double textMs = msSince(t);
+    std::cout << "text:   parse " << parseMs << " ms, top 10 + rank " << (textMs - parseMs)
+              << " ms, total " << textMs << " ms (" << probe << " is #" << probeRank << ")\n";
+    parsed.clear();
+    parsed.shrink_to_fit();
+
+    // Binary: map the file and answer the same questions in place.
+    t = Clock::now();
+    LeaderboardFile file;
+    if (!file.open(binPath)) return 1;
+    double openMs = msSince(t);
+    std::vector<ScoreEntry> top = file.top(10);
+    size_t binRank = file.rank(probe);
+    double binMs = msSince(t);
+    std::cout << "binary: open " << openMs << " ms, top 10 + rank " << (binMs - openMs)
+              << " ms, total " << binMs << " ms (" << probe << " is #" << binRank << ")\n";
+
+    t = Clock::now();
+    long long sum = 0;
+    for (size_t r = 1; r <= file.size(); ++r) sum += file.scoreAt(r);
+    std::cout << "binary: full score scan " << msSince(t) << " ms (checksum " << sum % 1000 << ")\n";
+
+    t = Clock::now();
+    LeaderboardFile verified;
+    verified.open(binPath, true);
+    std::cout << "binary: open with CRC check " << msSince(t) << " ms\n";
+
+    if (binRank != probeRank) {
+        std::cerr << "rank mismatch between text and binary\n";
+        return 1;
+    }
+    std::remove(textPath.c_str());
+    std::remove(binPath.c_str());
+    return 0;
+}
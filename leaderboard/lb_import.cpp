@@ -0,0 +1,44 @@
+// Converts an old highscores.txt ("name score" per line) into the binary
+// leaderboard format. Repeated names are summed, as updateScore used to do.
+//
+//   lb_import highscores.txt highscores.lb
+#include "LeaderboardFile.h"
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "usage: " << argv[0] << " <highscores.txt> <out.lb>\n";
+        return 1;
+    }
+
+    std::ifstream in(argv[1]);
+    if (!in) {
+        std::cerr << "cannot open " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::unordered_map<std::string, long long> totals;
+    std::string line, name;
+    long long score = 0;
+    size_t lines = 0, skipped = 0;
+    while (std::getline(in, line)) {
+        ++lines;
+        if (!LeaderboardFile::parseTextLine(line, name, score)) {
+            if (!line.empty() && line != "\r") ++skipped;
+            continue;
+        }
+        totals[name] += score;
+    }
+
+    std::vector<ScoreEntry> entries;
+    entries.reserve(totals.size());
+    for (const auto& kv : totals) entries.push_back(ScoreEntry{kv.first, kv.second});
+    LeaderboardFile::sortByRank(entries);
+
+    if (!LeaderboardFile::write(argv[2], entries)) return 1;
+    std::cout << "read " << lines << " lines (" << skipped << " skipped), wrote "
+              << entries.size() << " players to " << argv[2] << "\n";
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Load generator for scored: each client thread keeps one submission in
+// flight and the tool reports sustained submissions per second and the
+// latency each client saw.
+//
+//   lb_loadgen [clients] [seconds] [players] [socket]   (defaults: 16 5 100000)
+#include "ScoreClient.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Result {
+    std::vector<float> latencyUs;
+    unsigned long long failures;
+};
+
+void runClient(int id, size_t players, const std::string& socketPath, Clock::time_point deadline,
+               std::atomic<bool>& failed, Result& result) {
+    // No fallback: a missing daemon should fail the run, not open the store.
+    ScoreClient client("", socketPath);
+    std::mt19937 rng(1234 + id);
+    result.failures = 0;
+    while (Clock::now() < deadline) {
+        std::string name = "load" + std::to_string(rng() % players);
+        Clock::time_point start = Clock::now();
+        if (!client.submit(name, 1 + rng() % 50)) {
+            if (++result.failures > 100) {
+                failed = true;
+                return;
+            }
+            continue;
+        }
+        result.latencyUs.push_back(std::chrono::duration<float, std::micro>(Clock::now() - start).count());
+    }
+}
+
+float percentile(std::vector<float>& v, double p) {
+    if (v.empty()) return 0;
+    size_t k = static_cast<size_t>(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+}
+
+int main(int argc, char** argv) {
+    int clients = argc > 1 ? std::atoi(argv[1]) : 16;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 5.0;
+    size_t players = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 100000;
+    std::string socketPath = argc > 4 ? argv[4] : ScoreClient::defaultSocketPath();
+    if (clients < 1 || players < 1) {
+        std::cerr << "usage: " << argv[0] << " [clients] [seconds] [players] [socket]\n";
+        return 1;
+    }
+
+    std::atomic<bool> failed(false);
+    std::vector<Result> results(clients);
+    std::vector<std::thread> threads;
+    Clock::time_point start = Clock::now();
+    Clock::time_point deadline = start + std::chrono::microseconds(static_cast<long long>(seconds * 1e6));
+    for (int i = 0; i < clients; ++i) {
+        threads.emplace_back(runClient, i, players, socketPath, deadline, std::ref(failed), std::ref(results[i]));
+    }
+    for (std::thread& t : threads) t.join();
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    if (failed) {
+        std::cerr << "lb_loadgen: cannot reach scored at " << socketPath << "\n";
+        return 1;
+    }
+
+    std::vector<float> all;
+    unsigned long long failures = 0;
+    for (Result& r : results) {
+        all.insert(all.end(), r.latencyUs.begin(), r.latencyUs.end());
+        failures += r.failures;
+    }
+    std::cout << clients << " clients, " << all.size() << " submissions in " << elapsed << " s: "
+              << static_cast<long long>(all.size() / elapsed) << " submissions/s";
+    if (failures) std::cout << " (" << failures << " failed)";
+    std::cout << "\nlatency p50 " << percentile(all, 0.50) << " us, p99 " << percentile(all, 0.99)
+              << " us, max " << percentile(all, 1.0) << " us\n";
+    return 0;
+}
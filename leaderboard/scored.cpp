@@ -0,0 +1,305 @@
+// Local score daemon. Games submit scores over a Unix-domain socket (see
+// common/ScoreClient.h for the protocol) and this process is the only
+// writer of the score store.
+//
+// Every pass of the poll loop reads whatever requests have arrived on all
+// connections, applies them in memory, then fsyncs the log once for the
+// whole batch (group commit). Replies are held back until that fsync
+// returns, so an acknowledged score is always durable, while the fsync
+// cost is shared by every submission that arrived during the previous one.
+// If the fsync fails, every submission in the batch is answered ERR.
+//
+//   scored [-s socket] [-d storebase] [--fsync-each]
+#include "ScoreClient.h"
+#include "ScoreStore.h"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const size_t MAX_LINE = 8192;
+const size_t MAX_LIST = 10000;
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void onSignal(int) {
+    stopRequested = 1;
+}
+
+struct Conn {
+    int fd;
+    std::string in;
+    std::string out;
+    std::vector<size_t> unsynced;   // where this batch's OK replies to SUBMIT start in out
+    bool closing;
+};
+
+struct Stats {
+    unsigned long long submits;
+    unsigned long long queries;
+    unsigned long long batches;
+    unsigned long long largestBatch;
+};
+
+bool setNonBlocking(int fd) {
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+void appendEntries(std::string& out, const std::vector<ScoreEntry>& entries) {
+    out += "OK " + std::to_string(entries.size()) + "\n";
+    for (const ScoreEntry& e : entries) {
+        out += std::to_string(e.score);
+        out += ' ';
+        out += e.name;
+        out += '\n';
+    }
+}
+
+// Runs one request line and appends the reply. Returns true for a write.
+bool handleLine(ScoreStore& store, const std::string& line, std::string& out, Stats& stats) {
+    size_t sp = line.find(' ');
+    std::string cmd = line.substr(0, sp);
+    std::string args = sp == std::string::npos ? std::string() : line.substr(sp + 1);
+
+    if (cmd == "SUBMIT") {
+        char* end = nullptr;
+        long long points = std::strtoll(args.c_str(), &end, 10);
+        if (end == args.c_str() || *end != ' ' || end[1] == '\0') {
+            out += "ERR usage: SUBMIT <points> <name>\n";
+            return false;
+        }
+        long long total = 0;
+        if (!store.addPoints(std::string(end + 1), points, &total)) {
+            out += "ERR score not saved\n";
+            return false;
+        }
+        out += "OK " + std::to_string(total) + "\n";
+        ++stats.submits;
+        return true;
+    }
+
+    ++stats.queries;
+    if (cmd == "TOP") {
+        size_t k = std::strtoull(args.c_str(), nullptr, 10);
+        appendEntries(out, store.top(std::min(k, MAX_LIST)));
+    } else if (cmd == "RANGE") {
+        char* end = nullptr;
+        size_t first = std::strtoull(args.c_str(), &end, 10);
+        size_t count = std::strtoull(end, nullptr, 10);
+        appendEntries(out, store.ranking().range(first, std::min(count, MAX_LIST)));
+    } else if (cmd == "RANK") {
+        long long score = 0;
+        size_t rank = store.rank(args);
+        if (rank) store.ranking().lookup(args, score);
+        out += "OK " + std::to_string(rank) + " " + std::to_string(score) + "\n";
+    } else if (cmd == "SIZE") {
+        out += "OK " + std::to_string(store.size()) + "\n";
+    } else {
+        out += "ERR unknown command\n";
+    }
+    return false;
+}
+
+// Reads everything available; returns the number of submissions applied.
+size_t readRequests(Conn& c, ScoreStore& store, Stats& stats) {
+    char buf[16384];
+    for (;;) {
+        ssize_t n = ::recv(c.fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            c.in.append(buf, static_cast<size_t>(n));
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) c.closing = true;
+        break;
+    }
+
+    size_t writes = 0;
+    size_t start = 0;
+    for (size_t nl; (nl = c.in.find('\n', start)) != std::string::npos; start = nl + 1) {
+        std::string line = c.in.substr(start, nl - start);
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+        size_t at = c.out.size();
+        if (handleLine(store, line, c.out, stats)) {
+            c.unsynced.push_back(at);
+            ++writes;
+        }
+    }
+    c.in.erase(0, start);
+    if (c.in.size() > MAX_LINE) {
+        c.out += "ERR line too long\n";
+        c.closing = true;
+    }
+    return writes;
+}
+
+// The batch's fsync failed: none of its submissions may be acknowledged.
+void failUnsynced(Conn& c) {
+    if (c.unsynced.empty()) return;
+    std::string out;
+    size_t from = 0;
+    for (size_t at : c.unsynced) {
+        out.append(c.out, from, at - from);
+        out += "ERR score not saved\n";
+        from = c.out.find('\n', at) + 1;
+    }
+    out.append(c.out, from, std::string::npos);
+    c.out.swap(out);
+    c.unsynced.clear();
+}
+
+void flushReplies(Conn& c) {
+    while (!c.out.empty()) {
+        ssize_t n = ::send(c.fd, c.out.data(), c.out.size(), 0);
+        if (n > 0) {
+            c.out.erase(0, static_cast<size_t>(n));
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        c.out.clear();
+        c.closing = true;
+    }
+}
+
+int listenOn(const std::string& path) {
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "scored: socket path too long\n";
+        return -1;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+    // A leftover socket file from a crashed daemon is removed, a live one is not.
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+        std::cerr << "scored: another daemon is already listening on " << path << "\n";
+        ::close(fd);
+        return -1;
+    }
+    ::close(fd);
+    ::unlink(path.c_str());
+
+    fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(fd, 128) != 0 || !setNonBlocking(fd)) {
+        std::cerr << "scored: cannot listen on " << path << ": " << std::strerror(errno) << "\n";
+        if (fd >= 0) ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::string socketPath = ScoreClient::defaultSocketPath();
+    std::string storeBase = "highscores";
+    bool fsyncEach = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-s" && i + 1 < argc) socketPath = argv[++i];
+        else if (arg == "-d" && i + 1 < argc) storeBase = argv[++i];
+        else if (arg == "--fsync-each") fsyncEach = true;
+        else {
+            std::cerr << "usage: " << argv[0] << " [-s socket] [-d storebase] [--fsync-each]\n";
+            return 1;
+        }
+    }
+
+    ScoreStore store(storeBase);
+    if (!store.open()) return 1;
+    store.setAutoSync(fsyncEach);
+
+    int listenFd = listenOn(socketPath);
+    if (listenFd < 0) return 1;
+
+    std::signal(SIGPIPE, SIG_IGN);
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::cout << "scored: " << store.size() << " players from " << storeBase
+              << ", listening on " << socketPath << std::endl;
+
+    std::vector<Conn> conns;
+    std::vector<pollfd> fds;
+    Stats stats = {0, 0, 0, 0};
+
+    while (!stopRequested) {
+        fds.clear();
+        fds.push_back(pollfd{listenFd, POLLIN, 0});
+        for (const Conn& c : conns) {
+            fds.push_back(pollfd{c.fd, static_cast<short>(POLLIN | (c.out.empty() ? 0 : POLLOUT)), 0});
+        }
+        if (::poll(fds.data(), fds.size(), 1000) < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "scored: poll failed: " << std::strerror(errno) << "\n";
+            break;
+        }
+
+        // Requests on every ready connection form one batch.
+        size_t batch = 0;
+        for (size_t i = 0; i < conns.size(); ++i) {
+            if (fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR)) {
+                batch += readRequests(conns[i], store, stats);
+            }
+        }
+        if (batch > 0) {
+            // With --fsync-each every record was synced before its reply.
+            if (!fsyncEach && !store.sync()) {
+                std::cerr << "scored: log fsync failed: " << std::strerror(errno) << "\n";
+                for (Conn& c : conns) failUnsynced(c);
+            }
+            ++stats.batches;
+            if (batch > stats.largestBatch) stats.largestBatch = batch;
+        }
+
+        for (Conn& c : conns) {
+            c.unsynced.clear();
+            flushReplies(c);
+        }
+        for (size_t i = 0; i < conns.size(); ) {
+            if (conns[i].closing && conns[i].out.empty()) {
+                ::close(conns[i].fd);
+                conns[i] = conns.back();
+                conns.pop_back();
+            } else {
+                ++i;
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            for (;;) {
+                int fd = ::accept(listenFd, nullptr, nullptr);
+                if (fd < 0) break;
+                setNonBlocking(fd);
+                conns.push_back(Conn{fd, std::string(), std::string(), std::vector<size_t>(), false});
+            }
+        }
+    }
+
+    for (Conn& c : conns) ::close(c.fd);
+    ::close(listenFd);
+    ::unlink(socketPath.c_str());
+    store.compact();
+    store.close();
+
+    std::cout << "scored: " << stats.submits << " submissions in " << stats.batches << " batches";
+    if (stats.batches) std::cout << " (avg " << stats.submits / stats.batches << ", max " << stats.largestBatch << ")";
+    std::cout << ", " << stats.queries << " queries" << std::endl;
+    return 0;
+}
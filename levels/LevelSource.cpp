@@ -0,0 +1,320 @@
+#include "LevelSource.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+namespace {
+
+struct FieldSpec {
+    const char* key;
+    bool text;
+    bool required;
+};
+
+struct KindSpec {
+    const char* kind;
+    FieldSpec fields[12];   // ends at the first null key
+};
+
+// What each game reads. Keys not listed for a kind are rejected, so a typo
+// is an error rather than a field the game silently ignores.
+const KindSpec KINDS[] = {
+    {"riddle", {{"question", true, true}, {"answer", true, true}, {"time", false, false}}},
+    {"maze", {{"size", false, true}, {"path", false, true}, {"labels", true, true}, {"time", false, false}}},
+    {"rsa", {{"n", false, true}, {"e", false, true}, {"cipher", false, true}, {"message", true, true}}},
+    {"circuit", {{"slotKinds", true, true}, {"slotRects", false, true},
+                 {"pieceKinds", true, true}, {"pieceRects", false, true},
+                 {"nets", false, true}, {"fixedKinds", true, false}, {"fixedNets", false, false},
+                 {"valueKinds", true, false}, {"values", false, false},
+                 {"expectKinds", true, false}, {"expectRanges", false, false}}},
+    {"pattern", {{"health", false, false}, {"spread", false, false}, {"spiral", false, false},
+                 {"aimed", false, false}, {"wave", false, false}}},
+};
+
+// Bullet pattern emitters: four numbers each, and the key may repeat.
+const char* const EMITTERS[] = {"spread", "spiral", "aimed", "wave"};
+
+const KindSpec* findKind(const std::string& kind) {
+    for (const KindSpec& k : KINDS) {
+        if (kind == k.kind) return &k;
+    }
+    return nullptr;
+}
+
+const LevelField* findField(const LevelDef& level, const char* key) {
+    for (const LevelField& f : level.fields) {
+        if (f.key == key) return &f;
+    }
+    return nullptr;
+}
+
+std::vector<std::string> words(const std::string& text) {
+    std::istringstream in(text);
+    std::vector<std::string> out;
+    std::string w;
+    while (in >> w) out.push_back(w);
+    return out;
+}
+
+size_t countOf(const LevelDef& level, const char* key) {
+    const LevelField* f = findField(level, key);
+    if (!f) return 0;
+    return f->isText ? words(f->text).size() : f->numbers.size();
+}
+
+bool allWhole(const std::vector<double>& values, double min) {
+    for (double v : values) {
+        if (v != std::floor(v) || v < min) return false;
+    }
+    return true;
+}
+
+}
+
+void LevelSource::error(const Origin& at, const std::string& message) {
+    std::ostringstream out;
+    out << at.file << ":" << at.line << ": " << message;
+    errors_.push_back(out.str());
+}
+
+bool LevelSource::parseFile(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        errors_.push_back(path + ": cannot open");
+        return false;
+    }
+    return parse(in, path);
+}
+
+bool LevelSource::parse(std::istream& in, const std::string& file) {
+    size_t errorsBefore = errors_.size();
+    LevelDef* level = nullptr;
+    std::string line;
+    Origin at = {file, 0};
+
+    while (std::getline(in, line)) {
+        ++at.line;
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line[start] == '#') continue;
+
+        size_t keyEnd = line.find_first_of(" \t", start);
+        std::string key = line.substr(start, keyEnd == std::string::npos ? std::string::npos : keyEnd - start);
+        size_t rest = keyEnd == std::string::npos ? line.size() : line.find_first_not_of(" \t", keyEnd);
+        if (rest == std::string::npos) rest = line.size();
+
+        if (key == "level") {
+            std::vector<std::string> args = words(line.substr(rest));
+            if (args.size() != 2) {
+                error(at, "expected 'level <name> <kind>'");
+                level = nullptr;
+                continue;
+            }
+            levels_.push_back(LevelDef{args[0], args[1], std::vector<LevelField>()});
+            origins_.push_back(at);
+            level = &levels_.back();
+            continue;
+        }
+        if (!level) {
+            error(at, "'" + key + "' outside of a level");
+            continue;
+        }
+
+        LevelField value;
+        value.key = key;
+        if (rest < line.size() && line[rest] == '"') {
+            value.isText = true;
+            size_t i = rest + 1;
+            bool closed = false;
+            for (; i < line.size(); ++i) {
+                if (line[i] == '\\' && i + 1 < line.size()) {
+                    value.text += line[++i];
+                } else if (line[i] == '"') {
+                    closed = true;
+                    break;
+                } else {
+                    value.text += line[i];
+                }
+            }
+            size_t after = closed ? line.find_first_not_of(" \t", i + 1) : std::string::npos;
+            if (!closed || (after != std::string::npos && line[after] != '#')) {
+                error(at, "'" + key + "': text must be one quoted string");
+                continue;
+            }
+        } else {
+            value.isText = false;
+            bool ok = rest < line.size();
+            for (const std::string& w : words(line.substr(rest))) {
+                if (w[0] == '#') break;
+                char* end = nullptr;
+                double v = std::strtod(w.c_str(), &end);
+                if (*end != '\0' || !std::isfinite(v)) {
+                    ok = false;
+                    break;
+                }
+                value.numbers.push_back(v);
+            }
+            if (!ok || value.numbers.empty()) {
+                error(at, "'" + key + "': expected numbers or a quoted string");
+                continue;
+            }
+        }
+
+        LevelField* existing = nullptr;
+        for (LevelField& f : level->fields) {
+            if (f.key == key) existing = &f;
+        }
+        if (!existing) {
+            level->fields.push_back(value);
+        } else if (!existing->isText && !value.isText) {
+            existing->numbers.insert(existing->numbers.end(), value.numbers.begin(), value.numbers.end());
+        } else {
+            error(at, "'" + key + "' given twice in level " + level->name);
+        }
+    }
+    return errors_.size() == errorsBefore;
+}
+
+bool LevelSource::validate() {
+    size_t errorsBefore = errors_.size();
+    std::set<std::string> names;
+    for (size_t i = 0; i < levels_.size(); ++i) {
+        if (!names.insert(levels_[i].name).second) {
+            error(origins_[i], "level " + levels_[i].name + " is defined twice");
+        }
+        validateLevel(i);
+    }
+    return errors_.size() == errorsBefore;
+}
+
+void LevelSource::validateLevel(size_t index) {
+    const LevelDef& level = levels_[index];
+    const Origin& at = origins_[index];
+    const KindSpec* spec = findKind(level.kind);
+    if (!spec) {
+        error(at, level.name + ": unknown kind '" + level.kind + "'");
+        return;
+    }
+
+    bool fieldsOk = true;
+    for (const LevelField& f : level.fields) {
+        const FieldSpec* fs = nullptr;
+        for (const FieldSpec* s = spec->fields; s->key; ++s) {
+            if (f.key == s->key) fs = s;
+        }
+        if (!fs) {
+            error(at, level.name + ": " + level.kind + " levels have no field '" + f.key + "'");
+            fieldsOk = false;
+        } else if (fs->text != f.isText) {
+            error(at, level.name + ": '" + f.key + "' must be " + (fs->text ? "quoted text" : "numbers"));
+            fieldsOk = false;
+        }
+    }
+    for (const FieldSpec* s = spec->fields; s->key; ++s) {
+        if (s->required && !findField(level, s->key)) {
+            error(at, level.name + ": missing '" + s->key + "'");
+            fieldsOk = false;
+        }
+    }
+    if (!fieldsOk) return;
+
+    const std::string& name = level.name;
+    const LevelField* time = findField(level, "time");
+    if (time && (time->numbers.size() != 1 || time->numbers[0] <= 0)) {
+        error(at, name + ": 'time' is one positive number of seconds");
+    }
+
+    if (level.kind == "maze") {
+        const std::vector<double>& size = findField(level, "size")->numbers;
+        const std::vector<double>& path = findField(level, "path")->numbers;
+        std::vector<std::string> labels = words(findField(level, "labels")->text);
+        if (size.size() != 2 || !allWhole(size, 1)) {
+            error(at, name + ": 'size' is <rows> <cols>");
+            return;
+        }
+        if (path.size() % 2 != 0 || path.size() < 4 || !allWhole(path, 0)) {
+            error(at, name + ": 'path' is two or more <row> <col> pairs");
+            return;
+        }
+        std::set<std::pair<int, int>> seen;
+        for (size_t i = 0; i < path.size(); i += 2) {
+            int r = static_cast<int>(path[i]), c = static_cast<int>(path[i + 1]);
+            if (r >= size[0] || c >= size[1]) error(at, name + ": path cell " + std::to_string(i / 2) + " is off the grid");
+            if (!seen.insert(std::make_pair(r, c)).second) error(at, name + ": path visits a cell twice");
+            if (i > 0 && std::abs(r - path[i - 2]) + std::abs(c - path[i - 1]) != 1) {
+                error(at, name + ": path cell " + std::to_string(i / 2) + " is not next to the one before");
+            }
+        }
+        if (labels.size() != path.size() / 2) {
+            error(at, name + ": 'labels' needs one label per path cell");
+            return;
+        }
+        for (const std::string& l : labels) {
+            if (l.size() != 1 || !std::strchr("SERWDCB", l[0])) error(at, name + ": unknown label '" + l + "'");
+        }
+        if (labels.front() != "S" || labels.back() != "E") error(at, name + ": the path runs from S to E");
+    } else if (level.kind == "rsa") {
+        const std::vector<double>& n = findField(level, "n")->numbers;
+        const std::vector<double>& e = findField(level, "e")->numbers;
+        const std::vector<double>& cipher = findField(level, "cipher")->numbers;
+        if (n.size() != 1 || e.size() != 1 || !allWhole(n, 2) || !allWhole(e, 1)) {
+            error(at, name + ": 'n' and 'e' are single positive integers");
+        } else if (!allWhole(cipher, 0) || *std::max_element(cipher.begin(), cipher.end()) >= n[0]) {
+            error(at, name + ": 'cipher' values are integers below n");
+        }
+    } else if (level.kind == "circuit") {
+        size_t slots = countOf(level, "slotKinds");
+        size_t pieces = countOf(level, "pieceKinds");
+        if (countOf(level, "slotRects") != 4 * slots) error(at, name + ": 'slotRects' needs <x> <y> <w> <h> per slot");
+        if (countOf(level, "pieceRects") != 4 * pieces) error(at, name + ": 'pieceRects' needs <x> <y> <w> <h> per piece");
+        if (countOf(level, "nets") != 2 * slots || !allWhole(findField(level, "nets")->numbers, 0)) {
+            error(at, name + ": 'nets' needs <node a> <node b> per slot");
+        }
+        if (countOf(level, "fixedNets") != 2 * countOf(level, "fixedKinds")) {
+            error(at, name + ": 'fixedNets' needs <node a> <node b> per fixed part");
+        }
+        if (countOf(level, "values") != countOf(level, "valueKinds")) {
+            error(at, name + ": 'values' needs one number per value kind");
+        }
+        if (countOf(level, "expectRanges") != 2 * countOf(level, "expectKinds")) {
+            error(at, name + ": 'expectRanges' needs <min> <max> per expectation");
+        } else if (const LevelField* kinds = findField(level, "expectKinds")) {
+            std::vector<std::string> what = words(kinds->text);
+            const std::vector<double>& ranges = findField(level, "expectRanges")->numbers;
+            for (size_t i = 0; i < what.size(); ++i) {
+                if (what[i] != "led" && what[i] != "ammeter" && what[i] != "voltmeter") {
+                    error(at, name + ": cannot expect a reading from '" + what[i] + "'");
+                }
+                if (ranges[2 * i] > ranges[2 * i + 1]) error(at, name + ": range for " + what[i] + " is reversed");
+            }
+        }
+    } else if (level.kind == "pattern") {
+        const LevelField* health = findField(level, "health");
+        if (health && (health->numbers.size() != 1 || health->numbers[0] <= 0)) {
+            error(at, name + ": 'health' is one positive number");
+        }
+        int emitters = 0;
+        for (const char* key : EMITTERS) {
+            const LevelField* f = findField(level, key);
+            if (!f) continue;
+            ++emitters;
+            const std::vector<double>& v = f->numbers;
+            if (v.size() % 4 != 0) {
+                error(at, name + ": '" + key + "' takes four numbers per emitter");
+                continue;
+            }
+            for (size_t i = 0; i < v.size(); i += 4) {
+                // The first number counts bullets; spirals turn either way.
+                bool spiral = std::strcmp(key, "spiral") == 0;
+                if (v[i] < 1 || v[i] != std::floor(v[i])) error(at, name + ": '" + key + "' needs a whole count of at least 1");
+                if (!spiral && v[i + 1] < 0) error(at, name + ": '" + key + "' can't have a negative " + (std::strcmp(key, "spread") == 0 ? "arc" : "gap"));
+                if (v[i + 2] <= 0 || v[i + 3] <= 0) error(at, name + ": '" + key + "' speed and interval must be positive");
+            }
+        }
+        if (emitters == 0) error(at, name + ": a pattern needs at least one emitter");
+    }
+}
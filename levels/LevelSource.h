@@ -0,0 +1,46 @@
+#ifndef LEVELSOURCE_H
+#define LEVELSOURCE_H
+
+#include "LevelPack.h"
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Reader for the text level sources that levelc packs.
+//
+//   # comment
+//   level <name> <kind>          starts a level; names are unique
+//   <key> "text"                 text field; \" and \\ escape
+//   <key> <number> ...           numeric field; repeating the key appends,
+//                                so long lists can span several lines
+//
+// Every level is then checked against the schema for its kind (see
+// validate()). Problems are reported as "file:line: message".
+class LevelSource {
+public:
+    // Parses one source file and appends its levels. Returns false and
+    // records the errors if anything in it is malformed.
+    bool parse(std::istream& in, const std::string& file);
+    bool parseFile(const std::string& path);
+
+    // Checks names are unique and every level fits its kind's schema.
+    bool validate();
+
+    const std::vector<LevelDef>& levels() const { return levels_; }
+    const std::vector<std::string>& errors() const { return errors_; }
+
+private:
+    struct Origin {
+        std::string file;
+        int line;
+    };
+
+    void error(const Origin& at, const std::string& message);
+    void validateLevel(size_t index);
+
+    std::vector<LevelDef> levels_;
+    std::vector<Origin> origins_;   // where each level starts
+    std::vector<std::string> errors_;
+};
+
+#endif
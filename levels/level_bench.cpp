@@ -0,0 +1,112 @@
+// Generates a source file of random maze levels, packs it, and compares
+// what a game pays at startup: parsing the text versus mapping the pack,
+// then reading every level's path once.
+//
+//   level_bench [levels] [workdir]     (defaults: 1000 levels, /tmp)
+#include "LevelPack.h"
+#include "LevelSource.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// A random self-avoiding walk from the top-left corner.
+void writeMaze(std::ostream& out, int index, std::mt19937& rng) {
+    const int rows = 16, cols = 16;
+    std::vector<bool> used(rows * cols, false);
+    std::vector<std::pair<int, int>> path(1, std::make_pair(0, 0));
+    used[0] = true;
+    const int dr[] = {0, 1, 0, -1}, dc[] = {1, 0, -1, 0};
+    while (path.size() < 40) {
+        int r = path.back().first, c = path.back().second;
+        int options[4], n = 0;
+        for (int d = 0; d < 4; ++d) {
+            int nr = r + dr[d], nc = c + dc[d];
+            if (nr >= 0 && nr < rows && nc >= 0 && nc < cols && !used[nr * cols + nc]) options[n++] = d;
+        }
+        if (n == 0) break;
+        int d = options[rng() % n];
+        path.push_back(std::make_pair(r + dr[d], c + dc[d]));
+        used[(r + dr[d]) * cols + c + dc[d]] = true;
+    }
+
+    const char parts[] = "RWDCB";
+    out << "level maze-" << index << " maze\nsize " << rows << " " << cols << "\n";
+    for (size_t i = 0; i < path.size(); ++i) {
+        out << (i % 8 == 0 ? "path" : "") << " " << path[i].first << " " << path[i].second;
+        if (i % 8 == 7 || i + 1 == path.size()) out << "\n";
+    }
+    out << "labels \"S";
+    for (size_t i = 1; i + 1 < path.size(); ++i) out << " " << parts[rng() % 5];
+    out << " E\"\n\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 1000;
+    std::string dir = argc > 2 ? argv[2] : "/tmp";
+    std::string srcPath = dir + "/level_bench.lvl";
+    std::string packPath = dir + "/level_bench.pak";
+    if (count < 1) count = 1;
+
+    {
+        std::ofstream out(srcPath.c_str());
+        std::mt19937 rng(42);
+        for (int i = 0; i < count; ++i) writeMaze(out, i, rng);
+    }
+
+    Clock::time_point t = Clock::now();
+    LevelSource source;
+    source.parseFile(srcPath);
+    source.validate();
+    double parseMs = msSince(t);
+    if (!source.errors().empty()) {
+        std::cerr << source.errors().front() << "\n";
+        return 1;
+    }
+    double sum = 0;
+    for (const LevelDef& level : source.levels()) {
+        for (const LevelField& f : level.fields) {
+            if (f.key == "path") sum += f.numbers.size();
+        }
+    }
+    double parseTotalMs = msSince(t);
+
+    t = Clock::now();
+    if (!LevelPack::write(packPath, source.levels())) return 1;
+    double writeMs = msSince(t);
+
+    t = Clock::now();
+    LevelPack pack;
+    if (!pack.open(packPath)) return 1;
+    double openMs = msSince(t);
+    double sum2 = 0;
+    for (size_t i = 0; i < pack.size(); ++i) {
+        size_t n = 0;
+        pack.numbers(i, "path", n);
+        sum2 += n;
+    }
+    double packTotalMs = msSince(t);
+
+    t = Clock::now();
+    int found = 0;
+    for (int i = 0; i < count; ++i) found += pack.find("maze-" + std::to_string(i)) >= 0;
+    double findUs = msSince(t) * 1000.0 / count;
+
+    std::cout << count << " levels, " << sum / 2 << " path cells\n"
+              << "text:  parse + validate " << parseMs << " ms, first read done at " << parseTotalMs << " ms\n"
+              << "pack:  open " << openMs << " ms, first read done at " << packTotalMs << " ms"
+              << (sum2 == sum ? "" : "  (MISMATCH)") << "\n"
+              << "pack:  write " << writeMs << " ms, find by name " << findUs << " us (" << found << " found)\n";
+    return 0;
+}
@@ -0,0 +1,75 @@
+// Validates level sources and packs them into the binary format the games
+// map at startup.
+//
+//   levelc -o levels.pak src/*.lvl     check and pack
+//   levelc -c src/*.lvl                check only
+//   levelc -l levels.pak               list a pack (checksum verified)
+//
+// Any error in any file stops the pack from being written, so a game that
+// hot-reloads the pack never sees half an edit.
+#include "LevelPack.h"
+#include "LevelSource.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+
+namespace {
+
+int usage(const char* argv0) {
+    std::cerr << "usage: " << argv0 << " -o <out.pak> <source.lvl>...\n"
+              << "       " << argv0 << " -c <source.lvl>...\n"
+              << "       " << argv0 << " -l <pack.pak>\n";
+    return 1;
+}
+
+int list(const std::string& path) {
+    LevelPack pack;
+    if (!pack.open(path, true)) {
+        std::cerr << "cannot open " << path << "\n";
+        return 1;
+    }
+    for (size_t i = 0; i < pack.size(); ++i) {
+        std::cout << pack.name(i) << " (" << pack.kind(i) << ")\n";
+    }
+    std::cout << pack.size() << " levels\n";
+    return 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) return usage(argv[0]);
+    if (std::strcmp(argv[1], "-l") == 0) return argc == 3 ? list(argv[2]) : usage(argv[0]);
+
+    bool checkOnly = std::strcmp(argv[1], "-c") == 0;
+    std::string outPath;
+    int first = 2;
+    if (!checkOnly) {
+        if (std::strcmp(argv[1], "-o") != 0 || argc < 4) return usage(argv[0]);
+        outPath = argv[2];
+        first = 3;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    LevelSource source;
+    for (int i = first; i < argc; ++i) source.parseFile(argv[i]);
+    source.validate();
+    for (const std::string& e : source.errors()) std::cerr << e << "\n";
+    if (!source.errors().empty()) {
+        std::cerr << source.errors().size() << " error(s), nothing written\n";
+        return 1;
+    }
+
+    std::map<std::string, int> perKind;
+    for (const LevelDef& level : source.levels()) ++perKind[level.kind];
+    std::cout << source.levels().size() << " levels from " << argc - first << " file(s):";
+    for (const auto& kv : perKind) std::cout << " " << kv.second << " " << kv.first;
+    std::cout << "\n";
+    if (checkOnly) return 0;
+
+    if (!LevelPack::write(outPath, source.levels())) return 1;
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "wrote " << outPath << " in " << ms << " ms\n";
+    return 0;
+}
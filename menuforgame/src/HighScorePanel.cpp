@@ -0,0 +1,281 @@
+#include "HighScorePanel.h"
+#include "AllocTracker.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+
+const size_t PAGE_SIZE = 128;
+const size_t MAX_PAGES = 16;
+// New row textures per frame; rows past the budget show a placeholder
+// for a frame or two while flinging through the list.
+const int RASTER_PER_FRAME = 6;
+const SDL_Color TEXT_COLOR = {255, 255, 255, 255};
+const SDL_Color SCORE_COLOR = {255, 255, 0, 255};
+const SDL_Color HINT_COLOR = {180, 180, 180, 255};
+
+SDL_Texture* makeText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, SDL_Color color, int& w, int& h) {
+    w = h = 0;
+    if (text.empty()) return nullptr;
+    SDL_Surface* surface = TTF_RenderUTF8_Blended(font, text.c_str(), color);
+    if (!surface) return nullptr;
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    w = surface->w;
+    h = surface->h;
+    SDL_FreeSurface(surface);
+    return texture;
+}
+
+}
+
+HighScorePanel::HighScorePanel(SDL_Renderer* renderer, TTF_Font* font, SDL_Rect area, ScoreClient& scores)
+    : renderer_(renderer), font_(font), area_(area), scores_(scores), open_(false),
+      rowHeight_(TTF_FontHeight(font) + 8), total_(0), scroll_(0), targetScroll_(0),
+      highlightRank_(0), rasterBudget_(RASTER_PER_FRAME),
+      search_(renderer, font, TEXT_COLOR, SDL_Rect{area.x + 20, area.y + 12 + TTF_FontHeight(font), area.w - 40, 0}, 32),
+      hint_(nullptr), hintW_(0), hintH_(0), emptyTex_(nullptr), emptyW_(0), emptyH_(0),
+      statusTex_(nullptr), statusW_(0), statusH_(0) {
+    int top = search_.box().y + search_.box().h + 12;
+    listArea_ = SDL_Rect{area.x + 10, top, area.w - 20, area.y + area.h - 10 - top};
+    hint_ = makeText(renderer_, font_, "Rank or name + Enter, Esc closes", HINT_COLOR, hintW_, hintH_);
+    emptyTex_ = makeText(renderer_, font_, "No high scores yet!", TEXT_COLOR, emptyW_, emptyH_);
+}
+
+HighScorePanel::~HighScorePanel() {
+    dropRowCache();
+    if (hint_) SDL_DestroyTexture(hint_);
+    if (emptyTex_) SDL_DestroyTexture(emptyTex_);
+    if (statusTex_) SDL_DestroyTexture(statusTex_);
+}
+
+void HighScorePanel::open() {
+    // Scores may have changed since the panel was last shown.
+    dropRowCache();
+    pages_.clear();
+    pageLru_.clear();
+    total_ = scores_.size();
+    scroll_ = targetScroll_ = 0;
+    highlightRank_ = 0;
+    status_.clear();
+    if (statusTex_) SDL_DestroyTexture(statusTex_);
+    statusTex_ = nullptr;
+    search_.clear();
+    SDL_StartTextInput();
+    open_ = true;
+}
+
+void HighScorePanel::close() {
+    SDL_StopTextInput();
+    dropRowCache();
+    open_ = false;
+}
+
+void HighScorePanel::dropRowCache() {
+    for (auto& entry : rows_) {
+        if (entry.second.tex.left) SDL_DestroyTexture(entry.second.tex.left);
+        if (entry.second.tex.right) SDL_DestroyTexture(entry.second.tex.right);
+    }
+    rows_.clear();
+    rowLru_.clear();
+}
+
+const ScoreEntry* HighScorePanel::entryAt(size_t rank) {
+    if (rank == 0 || rank > total_) return nullptr;
+    size_t page = (rank - 1) / PAGE_SIZE;
+    auto it = pages_.find(page);
+    if (it == pages_.end()) {
+        if (pages_.size() >= MAX_PAGES) {
+            pages_.erase(pageLru_.back());
+            pageLru_.pop_back();
+        }
+        it = pages_.emplace(page, scores_.range(page * PAGE_SIZE + 1, PAGE_SIZE)).first;
+        pageLru_.push_front(page);
+    } else {
+        pageLru_.remove(page);
+        pageLru_.push_front(page);
+    }
+    size_t offset = (rank - 1) % PAGE_SIZE;
+    return offset < it->second.size() ? &it->second[offset] : nullptr;
+}
+
+const HighScorePanel::RowTextures* HighScorePanel::rowTextures(size_t rank, bool mayRasterize) {
+    auto it = rows_.find(rank);
+    if (it != rows_.end()) {
+        rowLru_.splice(rowLru_.begin(), rowLru_, it->second.lru);
+        return &it->second.tex;
+    }
+    if (!mayRasterize || rasterBudget_ <= 0) return nullptr;
+
+    const ScoreEntry* entry = entryAt(rank);
+    if (!entry) return nullptr;
+    --rasterBudget_;
+
+    // Keep a few screens' worth of rows so scrolling back is free.
+    size_t capacity = 3 * static_cast<size_t>(listArea_.h / rowHeight_ + 2);
+    while (rows_.size() >= capacity && !rowLru_.empty()) {
+        auto victim = rows_.find(rowLru_.back());
+        if (victim->second.tex.left) SDL_DestroyTexture(victim->second.tex.left);
+        if (victim->second.tex.right) SDL_DestroyTexture(victim->second.tex.right);
+        rows_.erase(victim);
+        rowLru_.pop_back();
+    }
+
+    RowTextures tex;
+    int lh = 0, rh = 0;
+    tex.left = makeText(renderer_, font_, std::to_string(rank) + ". " + entry->name, TEXT_COLOR, tex.leftW, lh);
+    tex.right = makeText(renderer_, font_, std::to_string(entry->score), SCORE_COLOR, tex.rightW, rh);
+    tex.h = std::max(lh, rh);
+
+    rowLru_.push_front(rank);
+    CachedRow& row = rows_[rank];
+    row.tex = tex;
+    row.lru = rowLru_.begin();
+    return &row.tex;
+}
+
+float HighScorePanel::maxScroll() const {
+    float content = static_cast<float>(total_) * rowHeight_;
+    return std::max(0.0f, content - listArea_.h);
+}
+
+void HighScorePanel::scrollToRank(size_t rank) {
+    float y = static_cast<float>(rank - 1) * rowHeight_ - (listArea_.h - rowHeight_) / 2.0f;
+    targetScroll_ = std::min(std::max(0.0f, y), maxScroll());
+    highlightRank_ = rank;
+}
+
+void HighScorePanel::runSearch() {
+    const std::string& query = search_.text();
+    bool numeric = std::all_of(query.begin(), query.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; });
+
+    size_t rank = 0;
+    if (numeric) {
+        rank = std::strtoull(query.c_str(), nullptr, 10);
+        if (rank == 0 || rank > total_) status_ = "Ranks go from 1 to " + std::to_string(total_);
+    } else {
+        rank = scores_.rank(query);
+        if (rank == 0) status_ = "No player named " + query;
+    }
+    if (rank != 0 && rank <= total_) {
+        status_.clear();
+        scrollToRank(rank);
+    }
+
+    if (statusTex_) SDL_DestroyTexture(statusTex_);
+    statusTex_ = makeText(renderer_, font_, status_, SDL_Color{255, 90, 90, 255}, statusW_, statusH_);
+    search_.resetSubmitted();
+}
+
+bool HighScorePanel::handleEvent(const SDL_Event& e) {
+    if (!open_) return false;
+    if (e.type == SDL_QUIT) return false;
+
+    float page = static_cast<float>(listArea_.h - rowHeight_);
+    if (e.type == SDL_KEYDOWN) {
+        switch (e.key.keysym.sym) {
+            case SDLK_ESCAPE:   close(); return true;
+            case SDLK_UP:       targetScroll_ -= rowHeight_; break;
+            case SDLK_DOWN:     targetScroll_ += rowHeight_; break;
+            case SDLK_PAGEUP:   targetScroll_ -= page; break;
+            case SDLK_PAGEDOWN: targetScroll_ += page; break;
+            case SDLK_HOME:     targetScroll_ = 0; break;
+            case SDLK_END:      targetScroll_ = maxScroll(); break;
+            default:
+                search_.handleEvent(e);
+                if (search_.submitted()) runSearch();
+                return true;
+        }
+        targetScroll_ = std::min(std::max(0.0f, targetScroll_), maxScroll());
+        return true;
+    }
+    if (e.type == SDL_MOUSEWHEEL) {
+        targetScroll_ -= e.wheel.y * rowHeight_ * 3.0f;
+        targetScroll_ = std::min(std::max(0.0f, targetScroll_), maxScroll());
+        return true;
+    }
+    if (e.type == SDL_MOUSEBUTTONDOWN) {
+        SDL_Point p = {e.button.x, e.button.y};
+        if (p.x < area_.x || p.x > area_.x + area_.w || p.y < area_.y || p.y > area_.y + area_.h) close();
+        return true;
+    }
+    search_.handleEvent(e);
+    return true;
+}
+
+void HighScorePanel::update(float dt) {
+    rasterBudget_ = RASTER_PER_FRAME;
+    float k = std::min(1.0f, dt * 14.0f);
+    scroll_ += (targetScroll_ - scroll_) * k;
+    if (std::fabs(targetScroll_ - scroll_) < 0.5f) scroll_ = targetScroll_;
+}
+
+void HighScorePanel::render() {
+    ALLOC_TAG("scores");
+    if (!open_) return;
+
+    SDL_SetRenderDrawBlendMode(renderer_, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer_, 15, 15, 20, 225);
+    SDL_RenderFillRect(renderer_, &area_);
+    SDL_SetRenderDrawColor(renderer_, 255, 255, 0, 255);
+    SDL_RenderDrawRect(renderer_, &area_);
+
+    if (hint_) {
+        SDL_Rect r = {area_.x + 20, area_.y + 6, hintW_, hintH_};
+        SDL_RenderCopy(renderer_, hint_, NULL, &r);
+    }
+    search_.render();
+    if (statusTex_) {
+        SDL_Rect r = {area_.x + area_.w - statusW_ - 20, search_.box().y, statusW_, statusH_};
+        SDL_RenderCopy(renderer_, statusTex_, NULL, &r);
+    }
+
+    SDL_RenderSetClipRect(renderer_, &listArea_);
+    if (total_ == 0) {
+        if (emptyTex_) {
+            SDL_Rect r = {listArea_.x + 10, listArea_.y, emptyW_, emptyH_};
+            SDL_RenderCopy(renderer_, emptyTex_, NULL, &r);
+        }
+    } else {
+        size_t first = static_cast<size_t>(scroll_ / rowHeight_) + 1;
+        size_t last = std::min(total_, static_cast<size_t>((scroll_ + listArea_.h) / rowHeight_) + 1);
+        bool settled = std::fabs(targetScroll_ - scroll_) < rowHeight_ * 4.0f;
+        for (size_t rank = first; rank <= last; ++rank) {
+            int y = listArea_.y + static_cast<int>(std::lround((rank - 1) * static_cast<double>(rowHeight_) - scroll_));
+            if (rank == highlightRank_) {
+                SDL_Rect hl = {listArea_.x, y, listArea_.w, rowHeight_};
+                SDL_SetRenderDrawColor(renderer_, 255, 255, 0, 60);
+                SDL_RenderFillRect(renderer_, &hl);
+            }
+
+            const RowTextures* tex = rowTextures(rank, settled || rasterBudget_ > RASTER_PER_FRAME / 2);
+            if (!tex) {
+                SDL_Rect ph = {listArea_.x + 10, y + rowHeight_ / 3, listArea_.w / 2, rowHeight_ / 3};
+                SDL_SetRenderDrawColor(renderer_, 80, 80, 90, 160);
+                SDL_RenderFillRect(renderer_, &ph);
+                continue;
+            }
+            int ty = y + (rowHeight_ - tex->h) / 2;
+            if (tex->left) {
+                SDL_Rect r = {listArea_.x + 10, ty, tex->leftW, tex->h};
+                SDL_RenderCopy(renderer_, tex->left, NULL, &r);
+            }
+            if (tex->right) {
+                SDL_Rect r = {listArea_.x + listArea_.w - tex->rightW - 20, ty, tex->rightW, tex->h};
+                SDL_RenderCopy(renderer_, tex->right, NULL, &r);
+            }
+        }
+    }
+    SDL_RenderSetClipRect(renderer_, NULL);
+
+    float range = maxScroll();
+    if (range > 0) {
+        int trackH = listArea_.h;
+        int thumbH = std::max(20, static_cast<int>(trackH * (listArea_.h / (range + listArea_.h))));
+        int thumbY = listArea_.y + static_cast<int>((trackH - thumbH) * (scroll_ / range));
+        SDL_Rect thumb = {listArea_.x + listArea_.w - 6, thumbY, 4, thumbH};
+        SDL_SetRenderDrawColor(renderer_, 200, 200, 200, 180);
+        SDL_RenderFillRect(renderer_, &thumb);
+    }
+}
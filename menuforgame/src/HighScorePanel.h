@@ -0,0 +1,84 @@
+#ifndef HIGHSCOREPANEL_H
+#define HIGHSCOREPANEL_H
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include "ScoreClient.h"
+#include "TextField.h"
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Scrollable high-score list drawn inside the menu window.
+//
+// Only the rows that intersect the viewport are drawn. Scores are fetched
+// from the score service a page at a time (RANGE requests) and each row's text is rasterized once
+// into a cached texture, so the cost per frame depends on the panel height,
+// not on how many players are on the board.
+class HighScorePanel {
+public:
+    HighScorePanel(SDL_Renderer* renderer, TTF_Font* font, SDL_Rect area, ScoreClient& scores);
+    ~HighScorePanel();
+
+    void open();
+    void close();
+    bool isOpen() const { return open_; }
+
+    // Returns true if the event was consumed by the panel.
+    bool handleEvent(const SDL_Event& e);
+    void update(float dt);
+    void render();
+
+private:
+    struct RowTextures {
+        SDL_Texture* left;
+        SDL_Texture* right;
+        int leftW, rightW, h;
+    };
+
+    struct CachedRow {
+        RowTextures tex;
+        std::list<size_t>::iterator lru;
+    };
+
+    HighScorePanel(const HighScorePanel&);
+    HighScorePanel& operator=(const HighScorePanel&);
+
+    const ScoreEntry* entryAt(size_t rank);
+    const RowTextures* rowTextures(size_t rank, bool mayRasterize);
+    void dropRowCache();
+    void scrollToRank(size_t rank);
+    void runSearch();
+    float maxScroll() const;
+
+    SDL_Renderer* renderer_;
+    TTF_Font* font_;
+    SDL_Rect area_;
+    SDL_Rect listArea_;
+    ScoreClient& scores_;
+
+    bool open_;
+    int rowHeight_;
+    size_t total_;
+    float scroll_, targetScroll_;
+    size_t highlightRank_;
+    std::string status_;
+
+    std::unordered_map<size_t, std::vector<ScoreEntry>> pages_;
+    std::list<size_t> pageLru_;
+
+    std::unordered_map<size_t, CachedRow> rows_;
+    std::list<size_t> rowLru_;
+    int rasterBudget_;
+
+    TextField search_;
+    SDL_Texture* hint_;
+    int hintW_, hintH_;
+    SDL_Texture* emptyTex_;
+    int emptyW_, emptyH_;
+    SDL_Texture* statusTex_;
+    int statusW_, statusH_;
+};
+
+#endif
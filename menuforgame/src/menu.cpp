@@ -1,239 +1,206 @@
-#include <SDL.h>
-#include <SDL_ttf.h>
-#include <SDL_image.h>
-#include <iostream>
-#include <fstream>
-#include <vector>
-#include <algorithm>
-
-const int WINDOW_WIDTH = 768;
-const int WINDOW_HEIGHT = 1152;
-
-struct MenuButton {
-    SDL_Rect rect;
-    std::string label;
-    SDL_Color color;
-    bool hovered = false;
-    bool clicked = false;
-};
-
-bool pointInRect(int x, int y, SDL_Rect& rect) {
-    return (x >= rect.x && x <= rect.x + rect.w && y >= rect.y && y <= rect.y + rect.h);
-}
-
-void renderText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text,
-                SDL_Color color, SDL_Rect& dstRect) {
-    SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), color);
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_QueryTexture(texture, NULL, NULL, &dstRect.w, &dstRect.h);
-    SDL_RenderCopy(renderer, texture, NULL, &dstRect);
-    SDL_DestroyTexture(texture);
-    SDL_FreeSurface(surface);
-}
-
-void showHighScores(SDL_Renderer* parentRenderer, TTF_Font* font) {
-    SDL_Window* scoreWindow = SDL_CreateWindow("High Scores", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 400, 400, 0);
-    SDL_Renderer* renderer = SDL_CreateRenderer(scoreWindow, -1, SDL_RENDERER_ACCELERATED);
-    SDL_Event e;
-
-    std::vector<std::pair<std::string, int>> scores;
-    std::ifstream file("highscores.txt");
-    std::string name;
-    int score;
-    while (file >> name >> score) {
-        scores.emplace_back(name, score);
-    }
-
-    std::sort(scores.begin(), scores.end(), [](auto& a, auto& b) {
-        return b.second < a.second;
-    });
-
-    bool open = true;
-    while (open) {
-        while (SDL_PollEvent(&e)) {
-            if (e.type == SDL_QUIT || (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_ESCAPE)) {
-                open = false;
-            }
-        }
-
-        SDL_SetRenderDrawColor(renderer, 30, 30, 30, 255);
-        SDL_RenderClear(renderer);
-
-        int y = 50;
-        if (scores.empty()) {
-            SDL_Color color = {255, 255, 255};
-            SDL_Rect r = {50, y, 0, 0};
-            renderText(renderer, font, "No high scores yet!", color, r);
-        } else {
-            for (const auto& entry : scores) {
-                std::string line = entry.first + ": " + std::to_string(entry.second);
-                SDL_Color color = {255, 255, 255};
-                SDL_Rect r = {50, y, 0, 0};
-                renderText(renderer, font, line, color, r);
-                y += 50;
-            }
-        }
-
-        SDL_RenderPresent(renderer);
-    }
-
-    SDL_DestroyRenderer(renderer);
-    SDL_DestroyWindow(scoreWindow);
-}
-
-void updateScore(const std::string& player, int points) {
-    std::vector<std::pair<std::string, int>> scores;
-    std::ifstream inFile("highscores.txt");
-    std::string name;
-    int score;
-    bool found = false;
-    while (inFile >> name >> score) {
-        if (name == player) {
-            score += points;
-            found = true;
-        }
-        scores.emplace_back(name, score);
-    }
-    inFile.close();
-
-    if (!found) {
-        scores.emplace_back(player, points);
-    }
-
-    std::ofstream outFile("highscores.txt");
-    for (const auto& pair : scores) {
-        outFile << pair.first << " " << pair.second << "\n";
-    }
-}
-
-std::string getPlayerName(SDL_Renderer* renderer, TTF_Font* font) {
-    std::string nameInput;
-    SDL_StartTextInput();
-    SDL_Event e;
-    bool entering = true;
-
-    while (entering) {
-        while (SDL_PollEvent(&e)) {
-            if (e.type == SDL_QUIT) return "";
-            else if (e.type == SDL_TEXTINPUT) {
-                nameInput += e.text.text;
-            } else if (e.type == SDL_KEYDOWN) {
-                if (e.key.keysym.sym == SDLK_BACKSPACE && !nameInput.empty()) {
-                    nameInput.pop_back();
-                } else if (e.key.keysym.sym == SDLK_RETURN && !nameInput.empty()) {
-                    entering = false;
-                }
-            }
-        }
-
-        SDL_SetRenderDrawColor(renderer, 20, 20, 20, 255);
-        SDL_RenderClear(renderer);
-
-        SDL_Color color = {255, 255, 255};
-        SDL_Rect labelRect = {100, 200, 0, 0};
-        renderText(renderer, font, "Enter your name:", color, labelRect);
-
-        SDL_Rect inputRect = {100, 300, 0, 0};
-        renderText(renderer, font, nameInput, color, inputRect);
-
-        SDL_RenderPresent(renderer);
-    }
-
-    SDL_StopTextInput();
-    return nameInput;
-}
-
-int main() {
-    if (SDL_Init(SDL_INIT_VIDEO) < 0 || TTF_Init() == -1 || IMG_Init(IMG_INIT_PNG) == 0) {
-        std::cerr << "Failed to initialize SDL components\n";
-        return 1;
-    }
-
-    SDL_Window* window = SDL_CreateWindow("Escape Room Conquest", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH, WINDOW_HEIGHT, 0);
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-
-    SDL_Surface* bgSurface = IMG_Load("menusection/menu_background.png");
-    SDL_Texture* bgTexture = SDL_CreateTextureFromSurface(renderer, bgSurface);
-    SDL_FreeSurface(bgSurface);
-
-    TTF_Font* font = TTF_OpenFont("menusection/creepster.ttf", 36);
-    TTF_Font* titleFont = TTF_OpenFont("menusection/creepster.ttf", 64);
-
-    if (!font || !titleFont) {
-        std::cerr << "Failed to load font\n";
-        return 1;
-    }
-
-    std::vector<MenuButton> buttons = {
-        {{270, 300, 0, 0}, "New Game",      {255, 255, 0}},
-        {{270, 370, 0, 0}, "Resume Game",   {255, 255, 0}},
-        {{270, 440, 0, 0}, "Help",          {255, 255, 0}},
-        {{270, 510, 0, 0}, "Map",           {255, 255, 0}},
-        {{270, 580, 0, 0}, "Highest Score", {255, 255, 0}},
-        {{270, 650, 0, 0}, "Exit",          {255, 255, 0}}
-    };
-
-    bool running = true;
-    SDL_Event e;
-
-    while (running) {
-        int mouseX, mouseY;
-        SDL_GetMouseState(&mouseX, &mouseY);
-
-        while (SDL_PollEvent(&e)) {
-            if (e.type == SDL_QUIT) {
-                running = false;
-            } else if (e.type == SDL_MOUSEBUTTONDOWN) {
-                for (size_t i = 0; i < buttons.size(); ++i) {
-                    if (pointInRect(mouseX, mouseY, buttons[i].rect)) {
-                        for (auto& b : buttons) b.clicked = false;
-                        buttons[i].clicked = true;
-                        if (i == 0) {
-                            std::string playerName = getPlayerName(renderer, font);
-                            if (!playerName.empty()) {
-                                updateScore(playerName, 10);
-                            }
-                        }
-                        else if (i == 1) std::cout << "Resume Game\n";
-                        else if (i == 2) std::cout << "Help\n";
-                        else if (i == 3) std::cout << "Map\n";
-                        else if (i == 4) showHighScores(renderer, font);
-                        else if (i == 5) running = false;
-                    }
-                }
-            }
-        }
-
-        for (auto& btn : buttons) {
-            btn.hovered = pointInRect(mouseX, mouseY, btn.rect);
-        }
-
-        SDL_RenderClear(renderer);
-        SDL_RenderCopy(renderer, bgTexture, NULL, NULL);
-
-        SDL_Color titleColor = {255, 255, 255};
-        SDL_Rect titleRect = {0, 100, 0, 0};
-        renderText(renderer, titleFont, "Escape Room Conquest", titleColor, titleRect);
-        titleRect.x = (WINDOW_WIDTH - titleRect.w) / 2;
-        SDL_RenderCopy(renderer, SDL_GetRenderTarget(renderer), NULL, &titleRect);
-
-        for (auto& btn : buttons) {
-            SDL_Color textColor = btn.clicked ? SDL_Color{0, 0, 0} : (btn.hovered ? SDL_Color{255, 255, 255} : btn.color);
-            SDL_Rect textRect = btn.rect;
-            renderText(renderer, font, btn.label, textColor, textRect);
-            btn.rect = textRect;
-        }
-
-        SDL_RenderPresent(renderer);
-    }
-
-    SDL_DestroyTexture(bgTexture);
-    TTF_CloseFont(font);
-    TTF_CloseFont(titleFont);
-    SDL_DestroyRenderer(renderer);
-    SDL_DestroyWindow(window);
-    IMG_Quit();
-    TTF_Quit();
-    SDL_Quit();
-    return 0;
-}
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <SDL_image.h>
+#include "TextField.h"
+#include "ScoreClient.h"
+#include "HighScorePanel.h"
+#include "AllocTracker.h"
+#include "FontCache.h"
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+const int WINDOW_WIDTH = 768;
+const int WINDOW_HEIGHT = 1152;
+const int FRAME_MS = 16;
+
+struct MenuButton {
+    SDL_Rect rect;
+    std::string label;
+    SDL_Color color;
+    bool hovered = false;
+    bool clicked = false;
+};
+
+bool pointInRect(int x, int y, SDL_Rect& rect) {
+    return (x >= rect.x && x <= rect.x + rect.w && y >= rect.y && y <= rect.y + rect.h);
+}
+
+// Glyphs come from the font's cached atlas, so nothing is rasterized per frame.
+void renderText(const FontCache& font, const std::string& text, SDL_Color color, SDL_Rect& dstRect) {
+    ALLOC_TAG("text");
+    dstRect = font.draw(text, color, dstRect.x, dstRect.y);
+}
+
+// Scores go through the local score daemon (leaderboard/scored) when it is
+// running; otherwise highscores.snap + highscores.log are used directly.
+ScoreClient& scoreClient() {
+    static ScoreClient client("highscores");
+    return client;
+}
+
+void updateScore(const std::string& player, int points) {
+    scoreClient().submit(player, points);
+}
+
+std::string getPlayerName(SDL_Renderer* renderer, FontCache& font) {
+    if (!font.font()) return "";
+    SDL_StartTextInput();
+    SDL_Event e;
+    SDL_Color color = {255, 255, 255, 255};
+    // The text field still renders with SDL_ttf; the font is opened here, not at startup
+    TextField nameField(renderer, font.font(), color, {100, 300, 560, 0});
+
+    while (!nameField.submitted()) {
+        while (SDL_PollEvent(&e)) {
+            if (e.type == SDL_QUIT) return "";
+            nameField.handleEvent(e);
+        }
+
+        SDL_SetRenderDrawColor(renderer, 20, 20, 20, 255);
+        SDL_RenderClear(renderer);
+
+        SDL_Rect labelRect = {100, 200, 0, 0};
+        renderText(font, "Enter your name:", color, labelRect);
+        nameField.render();
+
+        SDL_RenderPresent(renderer);
+        ALLOC_FRAME();
+    }
+
+    SDL_StopTextInput();
+    return nameField.text();
+}
+
+int main() {
+    Uint64 startup = SDL_GetPerformanceCounter();
+    ALLOC_TRACK_START("menu");
+    ALLOC_TRACK_SDL();
+    if (SDL_Init(SDL_INIT_VIDEO) < 0 || TTF_Init() == -1 || IMG_Init(IMG_INIT_PNG) == 0) {
+        std::cerr << "Failed to initialize SDL components\n";
+        return 1;
+    }
+
+    SDL_Window* window = SDL_CreateWindow("Escape Room Conquest", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH, WINDOW_HEIGHT, 0);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+
+    SDL_Surface* bgSurface = IMG_Load("menusection/menu_background.png");
+    SDL_Texture* bgTexture = SDL_CreateTextureFromSurface(renderer, bgSurface);
+    SDL_FreeSurface(bgSurface);
+
+    // Baked glyph atlases, mapped from the font cache after the first run
+    FontCache font(renderer);
+    FontCache titleFont(renderer);
+    if (!font.open("menusection/creepster.ttf", 36) || !titleFont.open("menusection/creepster.ttf", 64)) {
+        std::cerr << "Failed to load font\n";
+        return 1;
+    }
+    titleFont.printReport(std::cout);
+    font.printReport(std::cout);
+
+    std::vector<MenuButton> buttons = {
+        {{270, 300, 0, 0}, "New Game",      {255, 255, 0, 255}},
+        {{270, 370, 0, 0}, "Resume Game",   {255, 255, 0, 255}},
+        {{270, 440, 0, 0}, "Help",          {255, 255, 0, 255}},
+        {{270, 510, 0, 0}, "Map",           {255, 255, 0, 255}},
+        {{270, 580, 0, 0}, "Highest Score", {255, 255, 0, 255}},
+        {{270, 650, 0, 0}, "Exit",          {255, 255, 0, 255}}
+    };
+
+    // Made the first time it is opened: it rasterizes its rows with SDL_ttf,
+    // which has no business slowing down the first frame.
+    std::unique_ptr<HighScorePanel> scorePanel;
+    bool firstFrame = true;
+
+    bool running = true;
+    SDL_Event e;
+    Uint32 lastTicks = SDL_GetTicks();
+
+    while (running) {
+        Uint32 frameStart = SDL_GetTicks();
+        float dt = (frameStart - lastTicks) / 1000.0f;
+        lastTicks = frameStart;
+
+        int mouseX, mouseY;
+        SDL_GetMouseState(&mouseX, &mouseY);
+
+        while (SDL_PollEvent(&e)) {
+            if (scorePanel && scorePanel->handleEvent(e)) continue;
+            if (e.type == SDL_QUIT) {
+                running = false;
+            } else if (e.type == SDL_MOUSEBUTTONDOWN) {
+                for (size_t i = 0; i < buttons.size(); ++i) {
+                    if (pointInRect(mouseX, mouseY, buttons[i].rect)) {
+                        for (auto& b : buttons) b.clicked = false;
+                        buttons[i].clicked = true;
+                        if (i == 0) {
+                            std::string playerName = getPlayerName(renderer, font);
+                            if (!playerName.empty()) {
+                                updateScore(playerName, 10);
+                            }
+                        }
+                        else if (i == 1) std::cout << "Resume Game\n";
+                        else if (i == 2) std::cout << "Help\n";
+                        else if (i == 3) std::cout << "Map\n";
+                        else if (i == 4) {
+                            if (!scorePanel && font.font()) {
+                                scorePanel.reset(new HighScorePanel(renderer, font.font(),
+                                                                    {60, 260, WINDOW_WIDTH - 120, WINDOW_HEIGHT - 420},
+                                                                    scoreClient()));
+                            }
+                            if (scorePanel) scorePanel->open();
+                        }
+                        else if (i == 5) running = false;
+                    }
+                }
+            }
+        }
+
+        for (auto& btn : buttons) {
+            btn.hovered = !(scorePanel && scorePanel->isOpen()) && pointInRect(mouseX, mouseY, btn.rect);
+        }
+        if (scorePanel) scorePanel->update(dt);
+
+        SDL_RenderClear(renderer);
+        SDL_RenderCopy(renderer, bgTexture, NULL, NULL);
+
+        SDL_Color titleColor = {255, 255, 255, 255};
+        SDL_Rect titleRect = titleFont.measure("Escape Room Conquest");
+        titleRect.x = (WINDOW_WIDTH - titleRect.w) / 2;
+        titleRect.y = 100;
+        renderText(titleFont, "Escape Room Conquest", titleColor, titleRect);
+
+        for (auto& btn : buttons) {
+            SDL_Color textColor = btn.clicked ? SDL_Color{0, 0, 0, 255} : (btn.hovered ? SDL_Color{255, 255, 255, 255} : btn.color);
+            SDL_Rect textRect = btn.rect;
+            renderText(font, btn.label, textColor, textRect);
+            btn.rect = textRect;
+        }
+        if (scorePanel) scorePanel->render();
+
+        SDL_RenderPresent(renderer);
+        ALLOC_FRAME();
+        if (firstFrame) {
+            firstFrame = false;
+            std::cout << "First frame after "
+                      << (SDL_GetPerformanceCounter() - startup) * 1000.0 / SDL_GetPerformanceFrequency() << " ms\n";
+        }
+
+        // Vsync normally paces the loop; this keeps it from spinning when
+        // the driver ignores the request.
+        Uint32 elapsed = SDL_GetTicks() - frameStart;
+        if (elapsed < FRAME_MS) SDL_Delay(FRAME_MS - elapsed);
+    }
+
+    scorePanel.reset();
+    SDL_DestroyTexture(bgTexture);
+    font.close();
+    titleFont.close();
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    IMG_Quit();
+    TTF_Quit();
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,67 @@
+#ifndef BULLETFIELD_H
+#define BULLETFIELD_H
+
+#include "raylib.h"
+#include "JobSystem.h"
+#include <vector>
+
+// The boss's bullets, tens of thousands at a time. Stored as a structure of
+// arrays: every x in one array, every y in another, and the speeds likewise,
+// each allocated once at full capacity. Live bullets are packed at the front
+// and a removed one is replaced by the last, like BulletPool.
+//
+// Moving them is then a straight multiply-add over contiguous floats with no
+// branches or calls, which the compiler turns into SIMD at -O2. Only the
+// second pass, culling and hits, looks at bullets one by one, and for nearly
+// all of them that is a few compares against a box.
+//
+// Both passes only touch the bullet they are on, so they can also run in
+// chunks on a JobSystem. Removal then happens in a last pass on one thread,
+// in index order, which keeps the result the same for any thread count.
+class BulletField {
+public:
+    // bounds is the play area; bullets are dropped once they leave it.
+    BulletField(int capacity, Rectangle bounds);
+
+    // False if the field is full; the shot is dropped.
+    bool spawn(Vector2 pos, Vector2 speed);
+    void clear();
+
+    // Moves every bullet dt seconds and removes the ones that left bounds or
+    // whose path this step touched target (bullets are circles of radius).
+    // Returns how many hit.
+    int update(float dt, Rectangle target, float radius);
+
+    // The same update as jobs, after the job after: moving and testing in
+    // chunks on any thread, then removing. Returns the job that finishes
+    // it; hits() then has the count. Don't touch the field until then.
+    JobSystem::Job schedule(JobSystem& jobs, float dt, Rectangle target, float radius,
+                            JobSystem::Job after = JobSystem::NONE);
+    int hits() const { return hits_; }
+
+    int count() const { return count_; }
+    int capacity() const { return capacity_; }
+    // Shots lost because the field was full.
+    long dropped() const { return dropped_; }
+    Rectangle bounds() const { return bounds_; }
+
+    // Positions of the live bullets, count() of each.
+    const float* x() const { return x_.data(); }
+    const float* y() const { return y_.data(); }
+
+private:
+    enum Fate { KEEP, HIT, GONE };
+
+    void move(int begin, int end, float dt);
+    void judge(int begin, int end, float dt, Rectangle target, float radius);
+    int compact();
+    void remove(int i);
+
+    std::vector<float> x_, y_, vx_, vy_;
+    std::vector<unsigned char> fate_;   // from judge() for compact()
+    int capacity_, count_, hits_;
+    long dropped_;
+    Rectangle bounds_;
+};
+
+#endif
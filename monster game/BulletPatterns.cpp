@@ -0,0 +1,135 @@
+#include "BulletPatterns.h"
+#include "LevelPack.h"
+#include "AllocTracker.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const struct {
+    const char* key;
+    EmitterKind kind;
+} EMITTER_KEYS[] = {
+    {"spread", EMIT_SPREAD}, {"spiral", EMIT_SPIRAL}, {"aimed", EMIT_AIMED}, {"wave", EMIT_WAVE},
+};
+
+const float DEG_TO_RAD = 3.14159265f / 180.0f;
+
+Pattern builtinBoss() {
+    return {"boss-opening", 100.0f, {{EMIT_SPREAD, 1, 0.0f, 300.0f, 2.0f}}};
+}
+
+Pattern builtinStress() {
+    return {"stress", 100.0f, {{EMIT_SPIRAL, 80, 37.0f, 60.0f, 0.008f},
+                               {EMIT_SPIRAL, 40, -53.0f, 90.0f, 0.01f},
+                               {EMIT_SPREAD, 24, 120.0f, 120.0f, 0.05f}}};
+}
+
+void shoot(BulletField& field, Vector2 origin, float degrees, float speed) {
+    float a = degrees * DEG_TO_RAD;
+    field.spawn(origin, {std::cos(a) * speed, std::sin(a) * speed});
+}
+
+float aimAt(Vector2 origin, Vector2 target) {
+    return std::atan2(target.y - origin.y, target.x - origin.x) / DEG_TO_RAD;
+}
+
+}
+
+void LoadPatterns(const LevelPack& pack, std::vector<Pattern>& phases, Pattern& stress) {
+    phases.clear();
+    stress = Pattern();
+    for (size_t id : pack.levelsOfKind("pattern")) {
+        Pattern p;
+        p.name = pack.name(id);
+        p.health = static_cast<float>(pack.number(id, "health", 0, 100.0));
+        for (const auto& k : EMITTER_KEYS) {
+            size_t n = 0;
+            const double* v = pack.numbers(id, k.key, n);
+            for (size_t i = 0; i + 3 < n; i += 4) {
+                p.emitters.push_back({k.kind, static_cast<int>(v[i]), static_cast<float>(v[i + 1]),
+                                      static_cast<float>(v[i + 2]), static_cast<float>(v[i + 3])});
+            }
+        }
+        if (p.name == "stress") stress = p;
+        else if (p.name.compare(0, 5, "boss-") == 0) phases.push_back(p);
+    }
+    if (phases.empty()) phases.push_back(builtinBoss());
+    if (stress.emitters.empty()) stress = builtinStress();
+    std::stable_sort(phases.begin(), phases.end(),
+                     [](const Pattern& a, const Pattern& b) { return a.health > b.health; });
+}
+
+const Pattern& PhaseFor(const std::vector<Pattern>& phases, int health) {
+    const Pattern* phase = &phases.front();
+    for (const Pattern& p : phases) {
+        if (health <= p.health) phase = &p;
+    }
+    return *phase;
+}
+
+PatternPlayer::PatternPlayer() {}
+
+void PatternPlayer::start(const Pattern& pattern) {
+    pattern_ = pattern;
+    state_.assign(pattern_.emitters.size(), EmitterState{0.0f, 0.0f, 0, 0.0f, 0});
+}
+
+void PatternPlayer::update(float dt, Vector2 origin, Vector2 target, BulletField& field) {
+    ALLOC_TAG("patterns");
+    for (size_t i = 0; i < state_.size(); ++i) {
+        const Emitter& e = pattern_.emitters[i];
+        EmitterState& s = state_[i];
+
+        s.timer += dt;
+        while (s.timer >= e.every) {
+            s.timer -= e.every;
+            volley(e, s, origin, target, field);
+        }
+
+        if (e.kind == EMIT_SPIRAL) s.angle = std::fmod(s.angle + e.shape * dt, 360.0f);
+        if (e.kind == EMIT_AIMED) {
+            while (s.burstLeft > 0 && s.burstTimer <= 0.0f) {
+                shoot(field, origin, aimAt(origin, target), e.speed);
+                --s.burstLeft;
+                s.burstTimer += e.shape;
+            }
+            if (s.burstLeft > 0) s.burstTimer -= dt;
+            else s.burstTimer = 0.0f;
+        }
+    }
+}
+
+void PatternPlayer::volley(const Emitter& e, EmitterState& s, Vector2 origin, Vector2 target, BulletField& field) {
+    switch (e.kind) {
+    case EMIT_SPREAD: {
+        float centre = aimAt(origin, target);
+        if (e.count == 1) {
+            shoot(field, origin, centre, e.speed);
+            break;
+        }
+        for (int k = 0; k < e.count; ++k) {
+            shoot(field, origin, centre - e.shape / 2 + e.shape * k / (e.count - 1), e.speed);
+        }
+        break;
+    }
+    case EMIT_SPIRAL:
+        for (int k = 0; k < e.count; ++k) shoot(field, origin, s.angle + 360.0f * k / e.count, e.speed);
+        break;
+    case EMIT_AIMED:
+        // The shots themselves go out in update(), gap seconds apart
+        s.burstLeft += e.count;
+        break;
+    case EMIT_WAVE: {
+        Rectangle area = field.bounds();
+        int gap = std::min(static_cast<int>(e.shape), e.count - 1);
+        int hole = s.volleys++ % (e.count - gap + 1);
+        float spacing = area.height / e.count;
+        for (int k = 0; k < e.count; ++k) {
+            if (k >= hole && k < hole + gap) continue;
+            field.spawn({origin.x, area.y + spacing * (k + 0.5f)}, {-e.speed, 0.0f});
+        }
+        break;
+    }
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef BULLETPATTERNS_H
+#define BULLETPATTERNS_H
+
+#include "raylib.h"
+#include "BulletField.h"
+#include <string>
+#include <vector>
+
+class LevelPack;
+
+enum EmitterKind { EMIT_SPREAD, EMIT_SPIRAL, EMIT_AIMED, EMIT_WAVE };
+
+// One emitter of a pattern level. What the numbers mean depends on the
+// kind; levels/src/patterns.lvl has the full description.
+typedef struct {
+    EmitterKind kind;
+    int count;     // bullets a volley; arms of a spiral
+    float shape;   // arc for a spread, turn for a spiral, gap for the others
+    float speed;   // pixels per second
+    float every;   // seconds between volleys
+} Emitter;
+
+typedef struct {
+    std::string name;
+    float health;   // the boss uses it once at or below this
+    std::vector<Emitter> emitters;
+} Pattern;
+
+// The boss's phases (pattern levels named boss-*) from highest health to
+// lowest, and the stress scene's pattern. Whatever the pack lacks comes
+// from the built-in ones: the boss's original single shot every two
+// seconds, and a stress pattern that keeps the field full.
+void LoadPatterns(const LevelPack& pack, std::vector<Pattern>& phases, Pattern& stress);
+
+// The phase for the boss's health: the lowest threshold that still covers
+// it, or the first phase if none does.
+const Pattern& PhaseFor(const std::vector<Pattern>& phases, int health);
+
+// Runs a pattern's emitters on the fixed step. Volleys are due on a timer
+// per emitter that carries its remainder over, so a pattern fires the same
+// bullets at any frame rate, several volleys in one step if it must.
+class PatternPlayer {
+public:
+    PatternPlayer();
+
+    // Starts pattern from the beginning; the player keeps its own copy.
+    void start(const Pattern& pattern);
+    const Pattern& pattern() const { return pattern_; }
+
+    // Fires what is due in the next dt seconds from origin into field.
+    // Spreads and bursts aim at target; waves span the field's height.
+    void update(float dt, Vector2 origin, Vector2 target, BulletField& field);
+
+private:
+    struct EmitterState {
+        float timer;       // seconds since the last volley
+        float angle;       // a spiral's current turn, degrees
+        int burstLeft;     // shots still to come in an aimed burst
+        float burstTimer;  // seconds until the next of them
+        int volleys;       // moves a wave's gap along
+    };
+
+    void volley(const Emitter& e, EmitterState& s, Vector2 origin, Vector2 target, BulletField& field);
+
+    Pattern pattern_;
+    std::vector<EmitterState> state_;
+};
+
+#endif
@@ -0,0 +1,39 @@
+#include "BulletPool.h"
+
+BulletPool::BulletPool(int capacity) : slots_(capacity > 0 ? capacity : 1), freeHead_(-1), dropped_(0) {
+    alive_.reserve(slots_.size());
+    clear();
+}
+
+void BulletPool::clear() {
+    alive_.clear();
+    for (int i = 0; i < capacity(); ++i) {
+        slots_[i].nextFree = i + 1 < capacity() ? i + 1 : -1;
+    }
+    freeHead_ = 0;
+}
+
+Bullet* BulletPool::spawn(Vector2 pos, Vector2 speed) {
+    if (freeHead_ < 0) {
+        ++dropped_;
+        return nullptr;
+    }
+    int slot = freeHead_;
+    Slot& s = slots_[slot];
+    freeHead_ = s.nextFree;
+    s.bullet.pos = pos;
+    s.bullet.speed = speed;
+    alive_.push_back(slot);
+    return &s.bullet;
+}
+
+void BulletPool::release(int i) {
+    int slot = alive_[i];
+    // Swap-remove: the last live bullet takes position i.
+    alive_[i] = alive_.back();
+    alive_.pop_back();
+
+    Slot& s = slots_[slot];
+    s.nextFree = freeHead_;
+    freeHead_ = slot;
+}
@@ -0,0 +1,52 @@
+#ifndef BULLETPOOL_H
+#define BULLETPOOL_H
+
+#include "raylib.h"
+#include <vector>
+
+typedef struct {
+    Vector2 pos;
+    Vector2 speed;
+} Bullet;
+
+// Fixed number of bullet slots, allocated once. Free slots form a linked
+// list threaded through the slots themselves, so spawning and releasing are
+// O(1) and never allocate. The live bullets' slot numbers are kept packed
+// in one array, so updating, collision and drawing touch only live bullets
+// however long the game has been running.
+//
+// Iterate with an index and release by index:
+//
+//   for (int i = 0; i < pool.count();) {
+//       if (gone(pool.at(i))) pool.release(i);   // the last one moves to i
+//       else ++i;
+//   }
+class BulletPool {
+public:
+    explicit BulletPool(int capacity);
+
+    // nullptr if every slot is in use; the shot is dropped.
+    Bullet* spawn(Vector2 pos, Vector2 speed);
+    // i is a position among the live bullets, in [0, count()).
+    void release(int i);
+    void clear();
+
+    Bullet& at(int i) { return slots_[alive_[i]].bullet; }
+    int count() const { return static_cast<int>(alive_.size()); }
+    int capacity() const { return static_cast<int>(slots_.size()); }
+    // Shots lost because the pool was full.
+    long dropped() const { return dropped_; }
+
+private:
+    union Slot {
+        Bullet bullet;   // while live
+        int nextFree;    // while free; -1 ends the list
+    };
+
+    std::vector<Slot> slots_;
+    std::vector<int> alive_;   // reserved to capacity, never grows past it
+    int freeHead_;
+    long dropped_;
+};
+
+#endif
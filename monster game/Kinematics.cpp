@@ -0,0 +1,78 @@
+#include "Kinematics.h"
+#include <algorithm>
+#include <cmath>
+
+FixedStep::FixedStep(float step, float maxFrame) : step_(step), maxFrame_(maxFrame), carried_(0) {}
+
+int FixedStep::advance(float frameTime) {
+    carried_ += std::min(std::max(frameTime, 0.0f), maxFrame_);
+    int steps = static_cast<int>(carried_ / step_);
+    carried_ -= steps * step_;
+    return steps;
+}
+
+Vector2 Integrate(Vector2 pos, Vector2 velocity, float dt) {
+    return {pos.x + velocity.x * dt, pos.y + velocity.y * dt};
+}
+
+namespace {
+
+// First time in [0, 1] the segment from + d*t is inside box; 0 if it
+// starts inside. The slab test, one axis at a time.
+bool SegmentRect(Vector2 from, Vector2 d, float left, float top, float right, float bottom, float* t) {
+    float enter = 0.0f, leave = 1.0f;
+    const float p[2] = {from.x, from.y}, v[2] = {d.x, d.y};
+    const float lo[2] = {left, top}, hi[2] = {right, bottom};
+    for (int axis = 0; axis < 2; ++axis) {
+        if (v[axis] == 0.0f) {
+            if (p[axis] < lo[axis] || p[axis] > hi[axis]) return false;
+            continue;
+        }
+        float t0 = (lo[axis] - p[axis]) / v[axis], t1 = (hi[axis] - p[axis]) / v[axis];
+        if (t0 > t1) std::swap(t0, t1);
+        enter = std::max(enter, t0);
+        leave = std::min(leave, t1);
+        if (enter > leave) return false;
+    }
+    *t = enter;
+    return true;
+}
+
+// First time in [0, 1] the segment is within radius of center.
+bool SegmentCircle(Vector2 from, Vector2 d, Vector2 center, float radius, float* t) {
+    float mx = from.x - center.x, my = from.y - center.y;
+    float c = mx * mx + my * my - radius * radius;
+    if (c <= 0.0f) {
+        *t = 0.0f;
+        return true;
+    }
+    float a = d.x * d.x + d.y * d.y, b = mx * d.x + my * d.y;
+    if (a == 0.0f || b >= 0.0f) return false;   // still, or moving away
+    float disc = b * b - a * c;
+    if (disc < 0.0f) return false;
+    float hit = (-b - std::sqrt(disc)) / a;
+    if (hit > 1.0f) return false;
+    *t = hit;
+    return true;
+}
+
+}
+
+// The set of centres where a circle touches the box is the box with its
+// edges pushed out by the radius and its corners rounded: two crossed
+// rectangles plus a circle at each corner. The first contact is the
+// earliest entry into any of them.
+bool SweepCircleRect(Vector2 from, Vector2 to, float radius, Rectangle box, float* t) {
+    Vector2 d = {to.x - from.x, to.y - from.y};
+    float left = box.x, top = box.y, right = box.x + box.width, bottom = box.y + box.height;
+    float best = 2.0f, hit;
+    if (SegmentRect(from, d, left - radius, top, right + radius, bottom, &hit)) best = std::min(best, hit);
+    if (SegmentRect(from, d, left, top - radius, right, bottom + radius, &hit)) best = std::min(best, hit);
+    const Vector2 corners[4] = {{left, top}, {right, top}, {left, bottom}, {right, bottom}};
+    for (const Vector2& corner : corners) {
+        if (SegmentCircle(from, d, corner, radius, &hit)) best = std::min(best, hit);
+    }
+    if (best > 1.0f) return false;
+    *t = best;
+    return true;
+}
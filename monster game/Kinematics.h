@@ -0,0 +1,37 @@
+#ifndef KINEMATICS_H
+#define KINEMATICS_H
+
+#include "raylib.h"
+
+// The game simulates in fixed steps of this many seconds, whatever the
+// frame rate. A frame runs as many steps as fit in its time and carries
+// the rest over, so the same inputs give the same game at 30, 60 or 240 fps.
+const float SIM_STEP = 1.0f / 120.0f;
+
+class FixedStep {
+public:
+    // Frames longer than maxFrame (a stall, a dragged window) only count
+    // as maxFrame, so the game slows down instead of running hundreds of
+    // steps to catch up.
+    explicit FixedStep(float step = SIM_STEP, float maxFrame = 0.25f);
+
+    // Steps to run for a frame that took frameTime seconds.
+    int advance(float frameTime);
+    float step() const { return step_; }
+
+private:
+    float step_, maxFrame_;
+    float carried_;
+};
+
+// Where something at pos moving at velocity (units per second) is after
+// dt seconds.
+Vector2 Integrate(Vector2 pos, Vector2 velocity, float dt);
+
+// A circle moving in a straight line from `from` to `to`: true if it
+// touches box anywhere along the way, with *t the fraction of the move
+// (0 to 1) at first contact. Unlike testing where it ends up, a fast
+// circle can't pass through a thin box between two steps.
+bool SweepCircleRect(Vector2 from, Vector2 to, float radius, Rectangle box, float* t);
+
+#endif
@@ -0,0 +1,67 @@
+#include "RaylibAtlas.h"
+
+bool RaylibAtlas::load(const std::string& tablePath) {
+    if (!table_.read(tablePath)) return false;
+    Texture2D texture = LoadTexture(table_.imagePath(tablePath).c_str());
+    if (texture.id == 0) {
+        table_ = AtlasTable();
+        return false;
+    }
+    if (texture_.id != 0) UnloadTexture(texture_);
+    texture_ = texture;
+    return true;
+}
+
+int RaylibAtlas::add(const std::string& name, const std::string& file) {
+    Sprite s;
+    const AtlasSprite* packed = texture_.id != 0 ? table_.find(name) : nullptr;
+    if (packed) {
+        s.texture = {0, 0, 0, 0, 0};
+        s.src = {(float)packed->x, (float)packed->y, (float)packed->w, (float)packed->h};
+        s.w = (float)packed->sourceW;
+        s.h = (float)packed->sourceH;
+        s.own = false;
+    } else {
+        s.texture = LoadTexture(file.c_str());
+        if (s.texture.id == 0) return -1;
+        s.src = {0, 0, (float)s.texture.width, (float)s.texture.height};
+        s.w = (float)s.texture.width;
+        s.h = (float)s.texture.height;
+        s.own = true;
+    }
+    sprites_.push_back(s);
+    return (int)sprites_.size() - 1;
+}
+
+void RaylibAtlas::draw(int id, Vector2 pos, float scale, Color tint) const {
+    if (id < 0 || id >= (int)sprites_.size()) return;
+    const Sprite& s = sprites_[id];
+    Rectangle dest = {pos.x, pos.y, s.w * scale, s.h * scale};
+    DrawTexturePro(s.own ? s.texture : texture_, s.src, dest, {0, 0}, 0.0f, tint);
+}
+
+void RaylibAtlas::smooth(int id) {
+    if (id < 0 || id >= (int)sprites_.size()) return;
+    Sprite& s = sprites_[id];
+    Texture2D& texture = s.own ? s.texture : texture_;
+    if (texture.mipmaps <= 1) GenTextureMipmaps(&texture);
+    SetTextureFilter(texture, TEXTURE_FILTER_TRILINEAR);
+}
+
+float RaylibAtlas::width(int id) const {
+    return id < 0 || id >= (int)sprites_.size() ? 0.0f : sprites_[id].w;
+}
+
+float RaylibAtlas::height(int id) const {
+    return id < 0 || id >= (int)sprites_.size() ? 0.0f : sprites_[id].h;
+}
+
+void RaylibAtlas::unload() {
+    for (const Sprite& s : sprites_) {
+        if (s.own) UnloadTexture(s.texture);
+    }
+    sprites_.clear();
+    if (texture_.id != 0) UnloadTexture(texture_);
+    texture_ = {0, 0, 0, 0, 0};
+    table_ = AtlasTable();
+}
@@ -0,0 +1,58 @@
+#ifndef RAYLIBATLAS_H
+#define RAYLIBATLAS_H
+
+#include "raylib.h"
+#include "AtlasTable.h"
+#include <string>
+#include <vector>
+
+// The raylib side of common/SpriteAtlas.h: sprites drawn by id out of the
+// one texture atlas/atlasc packed, so raylib's batch, which only has to be
+// flushed when the texture changes, keeps every sprite in one draw call.
+// A sprite the atlas doesn't have is loaded from its own file instead.
+//
+// Sizes are the original images', so scales worked out for the loose
+// files still draw sprites the same size from an atlas that shrank them.
+class RaylibAtlas {
+public:
+    RaylibAtlas() : texture_({0, 0, 0, 0, 0}) {}
+    ~RaylibAtlas() { unload(); }
+
+    // False (and the sprites fall back to their files) if the table or its
+    // image can't be loaded. Needs the window open.
+    bool load(const std::string& tablePath);
+
+    // The sprite called name, from the atlas or else from file; -1 if
+    // neither has it, and drawing -1 draws nothing.
+    int add(const std::string& name, const std::string& file);
+
+    // Top left at pos, scale times the original image's size.
+    void draw(int id, Vector2 pos, float scale, Color tint) const;
+
+    // Mipmaps and trilinear filtering for a sprite drawn far smaller than
+    // its image (for an atlas sprite that is the whole atlas).
+    void smooth(int id);
+
+    float width(int id) const;
+    float height(int id) const;
+
+    // Before CloseWindow.
+    void unload();
+
+private:
+    struct Sprite {
+        Texture2D texture;   // its own; the atlas's is texture_
+        Rectangle src;
+        float w, h;
+        bool own;   // loaded from its own file, unloaded with it
+    };
+
+    RaylibAtlas(const RaylibAtlas&);
+    RaylibAtlas& operator=(const RaylibAtlas&);
+
+    Texture2D texture_;
+    AtlasTable table_;
+    std::vector<Sprite> sprites_;
+};
+
+#endif
@@ -0,0 +1,108 @@
+// Updates a field of boss bullets through the JobSystem (move, then hit
+// test and cull in chunks, then remove) with 1, 2, ... threads. Prints the
+// time per step, the speedup over one thread and how busy each thread was,
+// and checks every thread count ends with exactly the same bullets.
+//
+//   job_bench [bullets] [steps] [max threads]   (defaults: 100000, 240, cores or 4)
+#include "BulletField.h"
+#include "JobSystem.h"
+#include "Kinematics.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+
+namespace {
+
+// A target in the middle of a large field: most bullets stay, a few hit
+// or fly out each step and are replaced, as in the stress scene.
+const Rectangle BOUNDS = {0, 0, 20000, 20000};
+const Rectangle TARGET = {9000, 9000, 2000, 2000};
+
+struct Result {
+    double msPerStep;
+    unsigned long long checksum;
+    long hits;
+    std::vector<JobSystem::ThreadStats> stats;
+    double wallMs;
+};
+
+void topUp(BulletField& field, int bullets, std::mt19937& rng) {
+    std::uniform_real_distribution<float> pos(0.0f, 20000.0f), speed(-400.0f, 400.0f);
+    while (field.count() < bullets) {
+        float x = pos(rng), y = pos(rng);
+        field.spawn({x, y}, {speed(rng), speed(rng)});
+    }
+}
+
+unsigned long long checksum(const BulletField& field) {
+    unsigned long long h = 1469598103934665603ull;
+    for (int i = 0; i < field.count(); ++i) {
+        const float v[2] = {field.x()[i], field.y()[i]};
+        unsigned char bytes[sizeof v];
+        std::memcpy(bytes, v, sizeof v);
+        for (unsigned char b : bytes) h = (h ^ b) * 1099511628211ull;
+    }
+    return h;
+}
+
+Result run(int threads, int bullets, int steps) {
+    JobSystem jobs(threads);
+    BulletField field(bullets, BOUNDS);
+    std::mt19937 rng(12345);
+    topUp(field, bullets, rng);
+
+    Result r = {0, 0, 0, {}, 0};
+    double busy = 0;
+    for (int s = 0; s < steps; ++s) {
+        if (s == steps / 8) jobs.resetStats();   // the first steps warm up
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        field.schedule(jobs, SIM_STEP, TARGET, 5.0f);
+        jobs.wait();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (s >= steps / 8) busy += ms;
+        r.hits += field.hits();
+        topUp(field, bullets, rng);
+    }
+    r.msPerStep = busy / (steps - steps / 8);
+    r.wallMs = busy;
+    r.checksum = checksum(field) ^ static_cast<unsigned long long>(r.hits);
+    r.stats = jobs.stats();
+    return r;
+}
+
+}
+
+int main(int argc, char** argv) {
+    int bullets = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int steps = argc > 2 ? std::atoi(argv[2]) : 240;
+    int maxThreads = argc > 3 ? std::atoi(argv[3]) : std::max(4u, std::thread::hardware_concurrency());
+    if (bullets < 1 || steps < 8 || maxThreads < 1) {
+        std::fprintf(stderr, "usage: job_bench [bullets] [steps] [max threads]\n");
+        return 1;
+    }
+    std::printf("%d bullets, %d steps, %u cores\n", bullets, steps, std::thread::hardware_concurrency());
+    std::printf("%-8s %10s %8s  %-s\n", "threads", "ms/step", "speedup", "busy per thread (% of the run, stolen jobs)");
+
+    double single = 0;
+    unsigned long long expected = 0;
+    bool same = true;
+    for (int t = 1; t <= maxThreads; ++t) {
+        Result r = run(t, bullets, steps);
+        if (t == 1) {
+            single = r.msPerStep;
+            expected = r.checksum;
+        }
+        same = same && r.checksum == expected;
+        std::printf("%-8d %10.3f %7.2fx ", t, r.msPerStep, single / r.msPerStep);
+        for (const JobSystem::ThreadStats& s : r.stats) {
+            std::printf(" %3.0f%% (%ld)", 100.0 * s.busyMs / r.wallMs, s.stolen);
+        }
+        std::printf("%s\n", r.checksum == expected ? "" : "  DIFFERENT RESULT");
+    }
+    std::printf("%s\n", same ? "every thread count gave the same bullets" : "results differ between thread counts");
+    return same ? 0 : 1;
+}
@@ -1,110 +1,183 @@
 #include "raylib.h"
 #include "raymath.h"
+#include "BulletPool.h"
+#include "BulletField.h"
+#include "BulletPatterns.h"
+#include "JobSystem.h"
+#include "Kinematics.h"
+#include "LevelPack.h"
+#include "AllocTracker.h"
+#include "RaylibAtlas.h"
 #include <vector>
 
 const int screenWidth = 800;
 const int screenHeight = 600;
+const float playerSpeed = 200.0f;   // pixels per second
+const float bulletSpeed = 300.0f;
+const float bulletRadius = 5.0f;
+const char* const LEVEL_PACK_PATH = "../levels/levels.pak";
+const char* const ATLAS_PATH = "../atlas/out/monster.atlas";
 
 typedef struct {
     Vector2 pos;
     int health;
 } Entity;
 
-typedef struct {
-    Vector2 pos;
-    Vector2 speed;
-    bool active;
-} Bullet;
-
 Entity player = {{121, 0}, 100};   // Y will be set dynamically
 Entity monster = {{569, 0}, 100};  // Y will be set dynamically
-std::vector<Bullet> playerBullets;
-std::vector<Bullet> monsterBullets;
-
-float monsterTimer = 0;
-float monsterInterval = 2.0f;
+// Far more than can be on screen at once; a full pool drops the shot.
+const int maxBullets = 256;
+BulletPool playerBullets(maxBullets);
+// The boss's patterns can keep tens of thousands in the air; the stress
+// scene fills it.
+const int maxMonsterBullets = 65536;
+BulletField monsterBullets(maxMonsterBullets, {0, 0, (float)screenWidth, (float)screenHeight});
+const Vector2 monsterMuzzle = {584, 367};
 
 void DrawBar(Vector2 pos, int health, Color color) {
     DrawRectangle(pos.x, pos.y, 100, 10, GRAY);
     DrawRectangle(pos.x, pos.y, health, 10, color);
 }
 
-void ShootBullet(std::vector<Bullet> &bullets, Vector2 pos, Vector2 speed) {
-    bullets.push_back({pos, speed, true});
+// speed is in pixels per second.
+void ShootBullet(BulletPool &bullets, Vector2 pos, Vector2 speed) {
+    bullets.spawn(pos, speed);
 }
 
-void UpdateBullets(std::vector<Bullet> &bullets) {
-    for (auto &b : bullets) {
-        if (b.active) {
-            b.pos.x += b.speed.x;
-            b.pos.y += b.speed.y;
-            if (b.pos.x < 0 || b.pos.x > screenWidth || b.pos.y < 0 || b.pos.y > screenHeight)
-                b.active = false;
-        }
-    }
-}
-
-void CheckCollision(std::vector<Bullet> &bullets, Entity &target, float targetW, float targetH) {
-    for (auto &b : bullets) {
-        Rectangle targetRect = { target.pos.x, target.pos.y, targetW, targetH };
-        if (b.active && CheckCollisionCircleRec(b.pos, 5, targetRect)) {
-            target.health -= 1;
-            b.active = false;
+// Moves each bullet dt seconds along its path and checks the whole path
+// against the target, so a fast bullet can't skip over it between steps.
+// Returns how many hit.
+int UpdateBullets(BulletPool &bullets, Rectangle target, float dt) {
+    int hits = 0;
+    for (int i = 0; i < bullets.count();) {
+        Bullet &b = bullets.at(i);
+        Vector2 next = Integrate(b.pos, b.speed, dt);
+        float t;
+        if (SweepCircleRect(b.pos, next, bulletRadius, target, &t)) {
+            hits++;
+            bullets.release(i);   // the last bullet moves into slot i
+            continue;
         }
+        b.pos = next;
+        if (b.pos.x < 0 || b.pos.x > screenWidth || b.pos.y < 0 || b.pos.y > screenHeight)
+            bullets.release(i);
+        else
+            i++;
     }
+    return hits;
 }
 
 int main() {
+    ALLOC_TRACK_START("monster");
     InitWindow(screenWidth, screenHeight, "MECHANOID: LAST SURVIVOR");
     SetTargetFPS(60);
 
     Texture2D background = LoadTexture("background.png");
-    Texture2D heroTex = LoadTexture("hero.png");
-    Texture2D enemyTex = LoadTexture("enemy.png");
-    Texture2D bulletTex = LoadTexture("bullet_player.png");
-    Texture2D enemyBulletTex = LoadTexture("bullet_enemy.png");
+    // The ships and bullets share one atlas texture, so they draw in one batch
+    RaylibAtlas sprites;
+    sprites.load(ATLAS_PATH);
+    int heroSprite = sprites.add("hero", "hero.png");
+    int enemySprite = sprites.add("enemy", "enemy.png");
+    int bulletSprite = sprites.add("bullet_player", "bullet_player.png");
+    int enemyBulletSprite = sprites.add("bullet_enemy", "bullet_enemy.png");
+    // Drawn far smaller than the image, tens of thousands of times
+    sprites.smooth(enemyBulletSprite);
 
     float targetHeight = 100.0f;
-    float heroScale = (targetHeight / (float)heroTex.height) * 2.5f;
-    float enemyScale = (targetHeight / (float)enemyTex.height) * 2.5f;
+    float heroScale = (targetHeight / sprites.height(heroSprite)) * 2.5f;
+    float enemyScale = (targetHeight / sprites.height(enemySprite)) * 2.5f;
 
-    float heroHeight = heroTex.height * heroScale;
-    float heroWidth = heroTex.width * heroScale;
-    float enemyHeight = enemyTex.height * enemyScale;
-    float enemyWidth = enemyTex.width * enemyScale;
+    float heroHeight = sprites.height(heroSprite) * heroScale;
+    float heroWidth = sprites.width(heroSprite) * heroScale;
+    float enemyHeight = sprites.height(enemySprite) * enemyScale;
+    float enemyWidth = sprites.width(enemySprite) * enemyScale;
 
     float baselineY = screenHeight - heroHeight - 100;
 
     player.pos.y = baselineY;
     monster.pos.y = baselineY;
 
-    while (!WindowShouldClose()) {
-        float dt = GetFrameTime();
+    LevelPack pack;
+    pack.open(LevelPack::defaultPath(LEVEL_PACK_PATH));
+    std::vector<Pattern> phases;
+    Pattern stressPattern;
+    LoadPatterns(pack, phases, stressPattern);
+    double lastReloadCheck = GetTime();
 
-        // Movement controls
-        if (IsKeyDown(KEY_W)) player.pos.y -= 200 * dt;
-        if (IsKeyDown(KEY_S)) player.pos.y += 200 * dt;
-        if (IsKeyDown(KEY_A)) player.pos.x -= 200 * dt;
-        if (IsKeyDown(KEY_D)) player.pos.x += 200 * dt;
+    PatternPlayer boss;
+    boss.start(PhaseFor(phases, monster.health));
 
-        // Clamp player position to window
-        player.pos.x = Clamp(player.pos.x, 0.0f, (float)(screenWidth - heroWidth));
-        player.pos.y = Clamp(player.pos.y, 0.0f, (float)(screenHeight - heroHeight));
+    // Bullet updates run as jobs on every core
+    JobSystem jobs;
 
-        if (IsKeyPressed(KEY_SPACE))
-            ShootBullet(playerBullets, {318, 367}, {300 * dt, 0});
+    FixedStep sim;
+    bool shotPending = false;
+    // F2: the boss fires the stress pattern and nobody takes damage.
+    // F3: frame time readout.
+    bool stressScene = false, showStats = false;
+    float simMs = 0, drawMs = 0;
 
-        monsterTimer += dt;
-        if (monsterTimer >= monsterInterval) {
-            ShootBullet(monsterBullets, {584, 367}, {-300 * dt, 0});
-            monsterTimer = 0;
+    while (!WindowShouldClose()) {
+        // A press is kept until the next step, which may not be this frame
+        if (IsKeyPressed(KEY_SPACE)) shotPending = true;
+        if (IsKeyPressed(KEY_F3)) showStats = !showStats;
+        if (IsKeyPressed(KEY_F2)) {
+            stressScene = !stressScene;
+            monsterBullets.clear();
+            boss.start(stressScene ? stressPattern : PhaseFor(phases, monster.health));
         }
 
-        UpdateBullets(playerBullets);
-        UpdateBullets(monsterBullets);
+        // After `make` in levels/, the new patterns take over
+        if (GetTime() - lastReloadCheck >= 1.0) {
+            lastReloadCheck = GetTime();
+            if (pack.reloadIfChanged()) {
+                LoadPatterns(pack, phases, stressPattern);
+                boss.start(stressScene ? stressPattern : PhaseFor(phases, monster.health));
+            }
+        }
 
-        CheckCollision(playerBullets, monster, enemyWidth, enemyHeight);
-        CheckCollision(monsterBullets, player, heroWidth, heroHeight);
+        double simStart = GetTime();
+        for (int steps = sim.advance(GetFrameTime()); steps > 0; steps--) {
+            float dt = sim.step();
+
+            // Movement controls
+            if (IsKeyDown(KEY_W)) player.pos.y -= playerSpeed * dt;
+            if (IsKeyDown(KEY_S)) player.pos.y += playerSpeed * dt;
+            if (IsKeyDown(KEY_A)) player.pos.x -= playerSpeed * dt;
+            if (IsKeyDown(KEY_D)) player.pos.x += playerSpeed * dt;
+
+            // Clamp player position to window
+            player.pos.x = Clamp(player.pos.x, 0.0f, (float)(screenWidth - heroWidth));
+            player.pos.y = Clamp(player.pos.y, 0.0f, (float)(screenHeight - heroHeight));
+
+            if (shotPending) {
+                ShootBullet(playerBullets, {318, 367}, {bulletSpeed, 0});
+                shotPending = false;
+            }
+
+            if (!stressScene && PhaseFor(phases, monster.health).name != boss.pattern().name)
+                boss.start(PhaseFor(phases, monster.health));
+            Vector2 aim = {player.pos.x + heroWidth / 2, player.pos.y + heroHeight / 2};
+            boss.update(dt, monsterMuzzle, aim, monsterBullets);
+
+            // The two sets of bullets share nothing, so they update side by
+            // side, the boss's in chunks across the cores
+            Rectangle monsterRect = {monster.pos.x, monster.pos.y, enemyWidth, enemyHeight};
+            Rectangle playerRect = {player.pos.x, player.pos.y, heroWidth, heroHeight};
+            int monsterHits = 0;
+            jobs.add([&] {
+                ALLOC_TAG("bullets");
+                monsterHits = UpdateBullets(playerBullets, monsterRect, dt);
+            });
+            monsterBullets.schedule(jobs, dt, playerRect, bulletRadius);
+            jobs.wait();
+            if (!stressScene) {
+                monster.health -= monsterHits;
+                player.health -= monsterBullets.hits();
+            }
+        }
+        // Smoothed so the readout can be read
+        simMs = simMs * 0.9f + (float)((GetTime() - simStart) * 1000.0) * 0.1f;
 
         // WIN CONDITION: close window immediately
         if (monster.health <= 0) {
@@ -112,6 +185,7 @@ int main() {
             break;
         }
 
+        double drawStart = GetTime();
         BeginDrawing();
         ClearBackground(BLACK);
 
@@ -119,29 +193,44 @@ int main() {
         Rectangle dest = {0, 0, (float)screenWidth, (float)screenHeight};
         DrawTexturePro(background, src, dest, {0, 0}, 0.0f, WHITE);
 
-        DrawTextureEx(heroTex, player.pos, 0.0f, heroScale, WHITE);
-        DrawBar({player.pos.x - 30, player.pos.y - 20}, player.health, GREEN);
+        // Sprites first and the health bars after, so nothing switches the
+        // texture between them
+        sprites.draw(heroSprite, player.pos, heroScale, WHITE);
+        sprites.draw(enemySprite, monster.pos, enemyScale, WHITE);
 
-        DrawTextureEx(enemyTex, monster.pos, 0.0f, enemyScale, WHITE);
-        DrawBar({monster.pos.x - 30, monster.pos.y - 20}, monster.health, ORANGE);
+        for (int i = 0; i < playerBullets.count(); i++)
+            sprites.draw(bulletSprite, playerBullets.at(i).pos, 0.05f, WHITE);
 
-        for (auto &b : playerBullets)
-            if (b.active) DrawTextureEx(bulletTex, b.pos, 0.0f, 0.05f, WHITE);
+        // Bullet sized in the stress scene, so the fill rate doesn't decide the frame time
+        float enemyBulletScale = stressScene ? 2 * bulletRadius / sprites.width(enemyBulletSprite) : 0.05f;
+        const float *bx = monsterBullets.x(), *by = monsterBullets.y();
+        for (int i = 0; i < monsterBullets.count(); i++)
+            sprites.draw(enemyBulletSprite, {bx[i], by[i]}, enemyBulletScale, WHITE);
 
-        for (auto &b : monsterBullets)
-            if (b.active) DrawTextureEx(enemyBulletTex, b.pos, 0.0f, 0.05f, WHITE);
+        DrawBar({player.pos.x - 30, player.pos.y - 20}, player.health, GREEN);
+        DrawBar({monster.pos.x - 30, monster.pos.y - 20}, monster.health, ORANGE);
 
         if (player.health <= 0)
             DrawText("GAME OVER", 300, 280, 40, RED);
 
+        if (showStats || stressScene) {
+            DrawRectangle(5, 5, 420, stressScene ? 70 : 50, Fade(BLACK, 0.6f));
+            DrawText(TextFormat("%d fps  frame %.1f ms", GetFPS(), GetFrameTime() * 1000.0f), 10, 10, 20, WHITE);
+            DrawText(TextFormat("sim %.2f ms on %d threads  draw %.2f ms", simMs, jobs.threads(), drawMs), 10, 30, 20,
+                     WHITE);
+            if (stressScene)
+                DrawText(TextFormat("bullets %d / %d  dropped %ld", monsterBullets.count(),
+                                    monsterBullets.capacity(), monsterBullets.dropped()), 10, 50, 20, YELLOW);
+        }
+        // Up to the buffer swap, which waits for the frame's turn
+        drawMs = drawMs * 0.9f + (float)((GetTime() - drawStart) * 1000.0) * 0.1f;
+
         EndDrawing();
+        ALLOC_FRAME();
     }
 
     UnloadTexture(background);
-    UnloadTexture(heroTex);
-    UnloadTexture(enemyTex);
-    UnloadTexture(bulletTex);
-    UnloadTexture(enemyBulletTex);
+    sprites.unload();
 
     return 0;
 }
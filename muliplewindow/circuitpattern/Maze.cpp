@@ -0,0 +1,302 @@
+#include "Maze.h"
+#include <algorithm>
+#include <cstdlib>
+#include <queue>
+
+namespace {
+
+const int DCOL[] = {1, 0, -1, 0};
+const int DROW[] = {0, 1, 0, -1};
+
+int popcount(uint64_t v) {
+    return __builtin_popcountll(v);
+}
+
+int lowestBit(uint64_t v) {
+    return __builtin_ctzll(v);
+}
+
+}
+
+void Maze::reset(int cols, int rows) {
+    cols_ = std::max(cols, 0);
+    rows_ = std::max(rows, 0);
+    words_ = (cols_ + 63) / 64;
+    east_.assign(static_cast<size_t>(rows_) * words_, 0);
+    south_.assign(static_cast<size_t>(rows_) * words_, 0);
+    rowMask_.assign(words_, 0);
+    for (int c = 0; c < cols_; ++c) set(rowMask_, c);
+}
+
+MazeCell Maze::step(MazeCell c, Dir d) const {
+    return MazeCell{c.col + DCOL[d], c.row + DROW[d]};
+}
+
+bool Maze::isOpen(MazeCell c, Dir d) const {
+    MazeCell n = step(c, d);
+    if (!contains(c) || !contains(n)) return false;
+    switch (d) {
+    case EAST:  return test(east_, bit(c));
+    case SOUTH: return test(south_, bit(c));
+    case WEST:  return test(east_, bit(n));
+    default:    return test(south_, bit(n));
+    }
+}
+
+void Maze::carve(MazeCell c, Dir d) {
+    MazeCell n = step(c, d);
+    if (!contains(c) || !contains(n)) return;
+    switch (d) {
+    case EAST:  set(east_, bit(c)); break;
+    case SOUTH: set(south_, bit(c)); break;
+    case WEST:  set(east_, bit(n)); break;
+    default:    set(south_, bit(n)); break;
+    }
+}
+
+bool Maze::connected(MazeCell a, MazeCell b) const {
+    for (int d = 0; d < 4; ++d) {
+        if (step(a, static_cast<Dir>(d)) == b) return isOpen(a, static_cast<Dir>(d));
+    }
+    return false;
+}
+
+void Maze::generateDFS(std::mt19937& rng) {
+    reset(cols_, rows_);
+    if (cols_ == 0 || rows_ == 0) return;
+    std::vector<char> visited(static_cast<size_t>(cols_) * rows_, 0);
+    std::vector<MazeCell> stack;
+    MazeCell start = {static_cast<int>(rng() % cols_), static_cast<int>(rng() % rows_)};
+    stack.push_back(start);
+    visited[start.row * cols_ + start.col] = 1;
+
+    while (!stack.empty()) {
+        MazeCell c = stack.back();
+        Dir options[4];
+        int n = 0;
+        for (int d = 0; d < 4; ++d) {
+            MazeCell next = step(c, static_cast<Dir>(d));
+            if (contains(next) && !visited[next.row * cols_ + next.col]) options[n++] = static_cast<Dir>(d);
+        }
+        if (n == 0) {
+            stack.pop_back();
+            continue;
+        }
+        Dir d = options[rng() % n];
+        MazeCell next = step(c, d);
+        carve(c, d);
+        visited[next.row * cols_ + next.col] = 1;
+        stack.push_back(next);
+    }
+}
+
+void Maze::generateWilson(std::mt19937& rng) {
+    reset(cols_, rows_);
+    size_t cells = static_cast<size_t>(cols_) * rows_;
+    if (cells == 0) return;
+    std::vector<char> inTree(cells, 0);
+    std::vector<char> exitDir(cells, 0);   // last direction the walk left each cell by
+    inTree[rng() % cells] = 1;
+
+    for (size_t first = 0; first < cells; ++first) {
+        if (inTree[first]) continue;
+        // Walk until the tree is hit. Only the last exit from each cell is
+        // kept, which erases any loop the walk made.
+        MazeCell c = {static_cast<int>(first % cols_), static_cast<int>(first / cols_)};
+        while (!inTree[c.row * cols_ + c.col]) {
+            Dir d;
+            MazeCell next;
+            do {
+                d = static_cast<Dir>(rng() % 4);
+                next = step(c, d);
+            } while (!contains(next));
+            exitDir[c.row * cols_ + c.col] = static_cast<char>(d);
+            c = next;
+        }
+        // Add the loop-erased walk to the tree.
+        c = MazeCell{static_cast<int>(first % cols_), static_cast<int>(first / cols_)};
+        while (!inTree[c.row * cols_ + c.col]) {
+            Dir d = static_cast<Dir>(exitDir[c.row * cols_ + c.col]);
+            inTree[c.row * cols_ + c.col] = 1;
+            carve(c, d);
+            c = step(c, d);
+        }
+    }
+}
+
+void Maze::braid(double fraction, std::mt19937& rng) {
+    std::vector<std::pair<MazeCell, Dir>> walls;
+    for (int r = 0; r < rows_; ++r) {
+        for (int c = 0; c < cols_; ++c) {
+            MazeCell cell = {c, r};
+            if (c + 1 < cols_ && !isOpen(cell, EAST)) walls.push_back(std::make_pair(cell, EAST));
+            if (r + 1 < rows_ && !isOpen(cell, SOUTH)) walls.push_back(std::make_pair(cell, SOUTH));
+        }
+    }
+    std::shuffle(walls.begin(), walls.end(), rng);
+    size_t count = static_cast<size_t>(walls.size() * std::min(std::max(fraction, 0.0), 1.0));
+    for (size_t i = 0; i < count; ++i) carve(walls[i].first, walls[i].second);
+}
+
+Maze Maze::fromPath(int cols, int rows, const std::vector<MazeCell>& path) {
+    Maze maze(cols, rows);
+    for (size_t i = 1; i < path.size(); ++i) {
+        for (int d = 0; d < 4; ++d) {
+            if (maze.step(path[i - 1], static_cast<Dir>(d)) == path[i]) maze.carve(path[i - 1], static_cast<Dir>(d));
+        }
+    }
+    return maze;
+}
+
+std::vector<MazeCell> Maze::solveBFS(MazeCell from, MazeCell to) const {
+    explored_ = 0;
+    if (!contains(from) || !contains(to)) return std::vector<MazeCell>();
+
+    size_t total = static_cast<size_t>(rows_) * words_;
+    Bits visited(total, 0), frontier(total, 0), next(total, 0);
+    std::vector<int> dist(static_cast<size_t>(cols_) * rows_, -1);
+    // Rows with frontier bits. A maze's frontier is a handful of cells, so
+    // only those rows and their neighbours are touched each step.
+    std::vector<int> rows(1, from.row), nextRows;
+    std::vector<int> rowStamp(rows_, -1);
+
+    set(frontier, bit(from));
+    set(visited, bit(from));
+    dist[from.row * cols_ + from.col] = 0;
+    const int W = words_;
+
+    for (int level = 1; !rows.empty() && !test(visited, bit(to)); ++level) {
+        nextRows.clear();
+        for (int r : rows) {
+            const uint64_t* f = &frontier[static_cast<size_t>(r) * W];
+            const uint64_t* east = &east_[static_cast<size_t>(r) * W];
+            uint64_t* out = &next[static_cast<size_t>(r) * W];
+            uint64_t carryEast = 0;
+            for (int w = 0; w < W; ++w) {
+                // East: cells open to the east move one bit up.
+                uint64_t m = f[w] & east[w];
+                out[w] |= (m << 1) | carryEast;
+                carryEast = m >> 63;
+                // West: a cell is reached from its east neighbour if it is open to the east.
+                uint64_t fromEast = (f[w] >> 1) | (w + 1 < W ? f[w + 1] << 63 : 0);
+                out[w] |= fromEast & east[w];
+            }
+            if (r + 1 < rows_) {
+                uint64_t* below = &next[static_cast<size_t>(r + 1) * W];
+                const uint64_t* south = &south_[static_cast<size_t>(r) * W];
+                for (int w = 0; w < W; ++w) below[w] |= f[w] & south[w];
+            }
+            if (r > 0) {
+                uint64_t* above = &next[static_cast<size_t>(r - 1) * W];
+                const uint64_t* southAbove = &south_[static_cast<size_t>(r - 1) * W];
+                for (int w = 0; w < W; ++w) above[w] |= f[w] & southAbove[w];
+            }
+            for (int rr = std::max(r - 1, 0); rr <= std::min(r + 1, rows_ - 1); ++rr) {
+                if (rowStamp[rr] != level) {
+                    rowStamp[rr] = level;
+                    nextRows.push_back(rr);
+                }
+            }
+        }
+
+        // Clear the old frontier rows, keep only new cells, and record their distance.
+        for (int r : rows) std::fill(frontier.begin() + static_cast<size_t>(r) * W, frontier.begin() + static_cast<size_t>(r + 1) * W, 0);
+        rows.clear();
+        for (int r : nextRows) {
+            bool any = false;
+            for (int w = 0; w < W; ++w) {
+                size_t i = static_cast<size_t>(r) * W + w;
+                uint64_t fresh = next[i] & ~visited[i] & rowMask_[w];
+                next[i] = 0;
+                if (!fresh) continue;
+                any = true;
+                visited[i] |= fresh;
+                frontier[i] = fresh;
+                explored_ += popcount(fresh);
+                for (uint64_t v = fresh; v; v &= v - 1) {
+                    dist[r * cols_ + w * 64 + lowestBit(v)] = level;
+                }
+            }
+            if (any) rows.push_back(r);
+        }
+    }
+    return walkBack(dist, from, to);
+}
+
+std::vector<MazeCell> Maze::walkBack(const std::vector<int>& dist, MazeCell from, MazeCell to) const {
+    std::vector<MazeCell> path;
+    if (dist[to.row * cols_ + to.col] < 0) return path;
+    MazeCell c = to;
+    path.push_back(c);
+    while (c != from) {
+        int want = dist[c.row * cols_ + c.col] - 1;
+        for (int d = 0; d < 4; ++d) {
+            MazeCell n = step(c, static_cast<Dir>(d));
+            if (isOpen(c, static_cast<Dir>(d)) && dist[n.row * cols_ + n.col] == want) {
+                c = n;
+                break;
+            }
+        }
+        path.push_back(c);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+std::vector<MazeCell> Maze::solveAStar(MazeCell from, MazeCell to) const {
+    explored_ = 0;
+    if (!contains(from) || !contains(to)) return std::vector<MazeCell>();
+
+    struct Node {
+        int f, g, cell;
+        // Lowest f first; among equals, the one furthest along.
+        bool operator<(const Node& o) const { return f != o.f ? f > o.f : g < o.g; }
+    };
+    size_t cells = static_cast<size_t>(cols_) * rows_;
+    std::vector<int> g(cells, -1);
+    std::vector<int> parent(cells, -1);
+    std::vector<char> closed(cells, 0);
+    std::priority_queue<Node> open;
+
+    int start = from.row * cols_ + from.col, goal = to.row * cols_ + to.col;
+    g[start] = 0;
+    open.push(Node{std::abs(from.col - to.col) + std::abs(from.row - to.row), 0, start});
+    while (!open.empty()) {
+        Node n = open.top();
+        open.pop();
+        if (closed[n.cell]) continue;
+        closed[n.cell] = 1;
+        ++explored_;
+        if (n.cell == goal) break;
+
+        MazeCell c = {n.cell % cols_, n.cell / cols_};
+        for (int d = 0; d < 4; ++d) {
+            if (!isOpen(c, static_cast<Dir>(d))) continue;
+            MazeCell m = step(c, static_cast<Dir>(d));
+            int id = m.row * cols_ + m.col;
+            if (closed[id] || (g[id] >= 0 && g[id] <= n.g + 1)) continue;
+            g[id] = n.g + 1;
+            parent[id] = n.cell;
+            open.push(Node{g[id] + std::abs(m.col - to.col) + std::abs(m.row - to.row), g[id], id});
+        }
+    }
+
+    std::vector<MazeCell> path;
+    if (!closed[goal]) return path;
+    for (int id = goal; id >= 0; id = parent[id]) path.push_back(MazeCell{id % cols_, id / cols_});
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+bool Maze::isPath(const std::vector<MazeCell>& path, MazeCell from, MazeCell to) const {
+    if (path.empty() || path.front() != from || path.back() != to) return false;
+    std::vector<char> seen(static_cast<size_t>(cols_) * rows_, 0);
+    for (size_t i = 0; i < path.size(); ++i) {
+        if (!contains(path[i])) return false;
+        char& s = seen[path[i].row * cols_ + path[i].col];
+        if (s) return false;
+        s = 1;
+        if (i > 0 && !connected(path[i - 1], path[i])) return false;
+    }
+    return true;
+}
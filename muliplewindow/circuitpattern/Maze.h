@@ -0,0 +1,82 @@
+#ifndef MAZE_H
+#define MAZE_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+struct MazeCell {
+    int col, row;
+};
+
+inline bool operator==(const MazeCell& a, const MazeCell& b) { return a.col == b.col && a.row == b.row; }
+inline bool operator!=(const MazeCell& a, const MazeCell& b) { return !(a == b); }
+
+// Grid maze whose passages are kept as bitsets: one bit per cell for "open
+// to the east" and one for "open to the south", each row padded to whole
+// 64-bit words. The solver expands a whole BFS frontier per step with word
+// operations (shift the frontier, mask it with the open bits, drop what
+// was already reached), so even a 256x256 board is a few thousand word
+// operations per step.
+//
+// generateDFS() and generateWilson() carve a perfect maze (exactly one
+// route between any two cells); braid() then knocks out extra walls so
+// several routes can be right.
+class Maze {
+public:
+    enum Dir { EAST, SOUTH, WEST, NORTH };
+
+    Maze() : cols_(0), rows_(0), words_(0) {}
+    Maze(int cols, int rows) { reset(cols, rows); }
+
+    // All walls closed.
+    void reset(int cols, int rows);
+    int cols() const { return cols_; }
+    int rows() const { return rows_; }
+    bool contains(MazeCell c) const { return c.col >= 0 && c.col < cols_ && c.row >= 0 && c.row < rows_; }
+
+    bool isOpen(MazeCell c, Dir d) const;
+    void carve(MazeCell c, Dir d);
+    // True if a and b are neighbours with no wall between them.
+    bool connected(MazeCell a, MazeCell b) const;
+
+    // Randomized depth-first search: long, winding corridors.
+    void generateDFS(std::mt19937& rng);
+    // Loop-erased random walks: a uniformly random spanning tree, so the
+    // mazes have no bias towards any shape.
+    void generateWilson(std::mt19937& rng);
+    // Removes this fraction of the walls between cells that are still closed.
+    void braid(double fraction, std::mt19937& rng);
+    // Only the passages between consecutive cells of path are open.
+    static Maze fromPath(int cols, int rows, const std::vector<MazeCell>& path);
+
+    // Shortest route from `from` to `to`, both included; empty if there is none.
+    std::vector<MazeCell> solveBFS(MazeCell from, MazeCell to) const;
+    // Same, by A* with the Manhattan distance. It looks at fewer cells, but
+    // each one costs a heap operation, so on these boards it is slower than
+    // the bitset BFS (see maze_bench).
+    std::vector<MazeCell> solveAStar(MazeCell from, MazeCell to) const;
+    // Cells the last solve looked at, for comparing the two.
+    size_t lastExplored() const { return explored_; }
+
+    // True if path runs from `from` to `to` through open passages without
+    // visiting a cell twice.
+    bool isPath(const std::vector<MazeCell>& path, MazeCell from, MazeCell to) const;
+
+private:
+    typedef std::vector<uint64_t> Bits;
+
+    size_t bit(MazeCell c) const { return static_cast<size_t>(c.row) * words_ * 64 + c.col; }
+    static bool test(const Bits& b, size_t i) { return (b[i >> 6] >> (i & 63)) & 1; }
+    static void set(Bits& b, size_t i) { b[i >> 6] |= uint64_t(1) << (i & 63); }
+    MazeCell step(MazeCell c, Dir d) const;
+    std::vector<MazeCell> walkBack(const std::vector<int>& dist, MazeCell from, MazeCell to) const;
+
+    int cols_, rows_;
+    int words_;           // 64-bit words per row
+    Bits east_, south_;   // passage open to the east / south of each cell
+    Bits rowMask_;        // the bits of one row that are real cells
+    mutable size_t explored_ = 0;
+};
+
+#endif
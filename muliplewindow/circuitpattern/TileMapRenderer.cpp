@@ -0,0 +1,177 @@
+#include "TileMapRenderer.h"
+#include <algorithm>
+
+namespace {
+
+// Labels are rasterized at this size and scaled down to the tiles.
+const unsigned ATLAS_CHAR_SIZE = 48;
+const float HOVER_THICKNESS = 3.0f;
+
+const char* TINT_SHADER =
+    "uniform sampler2D texture;\n"
+    "uniform vec4 tint;\n"
+    "void main() {\n"
+    "    gl_FragColor = gl_Color * texture2D(texture, gl_TexCoord[0].xy) * tint;\n"
+    "}\n";
+
+}
+
+TileMapRenderer::TileMapRenderer()
+    : cols_(0), rows_(0), tileSize_(0), fills_(sf::Quads), lines_(sf::Lines), labels_(sf::Quads),
+      hover_(sf::Quads), hoverCol_(-1), hoverRow_(-1), labelsVisible_(true), shaderReady_(false),
+      tint_(sf::Color::White) {
+    if (sf::Shader::isAvailable() && tintShader_.loadFromMemory(TINT_SHADER, sf::Shader::Fragment)) {
+        tintShader_.setUniform("texture", sf::Shader::CurrentTexture);
+        tintShader_.setUniform("tint", sf::Glsl::Vec4(tint_));
+        shaderReady_ = true;
+    }
+}
+
+void TileMapRenderer::setQuad(sf::Vertex* quad, float x, float y, float w, float h) {
+    quad[0].position = sf::Vector2f(x, y);
+    quad[1].position = sf::Vector2f(x + w, y);
+    quad[2].position = sf::Vector2f(x + w, y + h);
+    quad[3].position = sf::Vector2f(x, y + h);
+}
+
+void TileMapRenderer::buildAtlas(const std::vector<std::string>& labels, const sf::Font& font) {
+    atlasNames_.clear();
+    for (const std::string& l : labels) {
+        if (!l.empty() && std::find(atlasNames_.begin(), atlasNames_.end(), l) == atlasNames_.end()) {
+            atlasNames_.push_back(l);
+        }
+    }
+
+    // Side by side in one strip, with a pixel of space so smoothing
+    // doesn't bleed one label into the next.
+    std::vector<sf::Text> texts(atlasNames_.size());
+    unsigned width = 1, height = 1;
+    for (size_t i = 0; i < atlasNames_.size(); ++i) {
+        texts[i] = sf::Text(atlasNames_[i], font, ATLAS_CHAR_SIZE);
+        sf::FloatRect b = texts[i].getLocalBounds();
+        width += static_cast<unsigned>(b.left + b.width) + 2;
+        height = std::max(height, static_cast<unsigned>(b.top + b.height) + 2);
+    }
+    atlasRects_.clear();
+    if (!atlas_.create(width, height)) return;
+    atlas_.clear(sf::Color::Transparent);
+    float x = 1;
+    for (size_t i = 0; i < texts.size(); ++i) {
+        sf::FloatRect b = texts[i].getLocalBounds();
+        texts[i].setFillColor(sf::Color::White);
+        texts[i].setPosition(x, 1);
+        atlas_.draw(texts[i]);
+        atlasRects_.push_back(sf::FloatRect(x + b.left, 1 + b.top, b.width, b.height));
+        x += b.left + b.width + 2;
+    }
+    atlas_.display();
+    atlas_.setSmooth(true);
+}
+
+void TileMapRenderer::build(int cols, int rows, int tileSize, const std::vector<std::string>& labels, const sf::Font& font) {
+    cols_ = cols;
+    rows_ = rows;
+    tileSize_ = tileSize;
+    hoverCol_ = hoverRow_ = -1;
+    hover_.clear();
+
+    fills_.resize(static_cast<size_t>(cols) * rows * 4);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            sf::Vertex* quad = &fills_[(static_cast<size_t>(r) * cols + c) * 4];
+            setQuad(quad, c * tileSize + 1.0f, r * tileSize + 1.0f, tileSize - 2.0f, tileSize - 2.0f);
+            for (int k = 0; k < 4; ++k) quad[k].color = sf::Color::Transparent;
+        }
+    }
+
+    lines_.clear();
+    sf::Color lineColor = sf::Color::White;
+    for (int c = 0; c <= cols; ++c) {
+        lines_.append(sf::Vertex(sf::Vector2f(c * tileSize, 0), lineColor));
+        lines_.append(sf::Vertex(sf::Vector2f(c * tileSize, rows * tileSize), lineColor));
+    }
+    for (int r = 0; r <= rows; ++r) {
+        lines_.append(sf::Vertex(sf::Vector2f(0, r * tileSize), lineColor));
+        lines_.append(sf::Vertex(sf::Vector2f(cols * tileSize, r * tileSize), lineColor));
+    }
+
+    buildAtlas(labels, font);
+    labels_.clear();
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            const std::string& l = labels[static_cast<size_t>(r) * cols + c];
+            if (l.empty()) continue;
+            size_t id = std::find(atlasNames_.begin(), atlasNames_.end(), l) - atlasNames_.begin();
+            if (id >= atlasRects_.size()) continue;
+            const sf::FloatRect& src = atlasRects_[id];
+            // Half the tile high, centred, keeping the glyphs' proportions.
+            float h = tileSize * 0.5f;
+            float w = src.height > 0 ? src.width * h / src.height : h;
+            sf::Vertex quad[4];
+            setQuad(quad, c * tileSize + (tileSize - w) / 2, r * tileSize + (tileSize - h) / 2, w, h);
+            quad[0].texCoords = sf::Vector2f(src.left, src.top);
+            quad[1].texCoords = sf::Vector2f(src.left + src.width, src.top);
+            quad[2].texCoords = sf::Vector2f(src.left + src.width, src.top + src.height);
+            quad[3].texCoords = sf::Vector2f(src.left, src.top + src.height);
+            for (int k = 0; k < 4; ++k) {
+                quad[k].color = shaderReady_ ? sf::Color::White : tint_;
+                labels_.append(quad[k]);
+            }
+        }
+    }
+}
+
+bool TileMapRenderer::tileAt(sf::Vector2i pixel, int& col, int& row) const {
+    if (tileSize_ <= 0 || pixel.x < 0 || pixel.y < 0) return false;
+    col = pixel.x / tileSize_;
+    row = pixel.y / tileSize_;
+    return col < cols_ && row < rows_;
+}
+
+void TileMapRenderer::setTileColor(int col, int row, sf::Color color) {
+    if (col < 0 || col >= cols_ || row < 0 || row >= rows_) return;
+    sf::Vertex* quad = &fills_[(static_cast<size_t>(row) * cols_ + col) * 4];
+    if (quad[0].color == color) return;
+    for (int k = 0; k < 4; ++k) quad[k].color = color;
+}
+
+void TileMapRenderer::setHover(int col, int row) {
+    if (col == hoverCol_ && row == hoverRow_) return;
+    hoverCol_ = col;
+    hoverRow_ = row;
+    hover_.clear();
+    if (col < 0 || col >= cols_ || row < 0 || row >= rows_) return;
+
+    float x = col * tileSize_, y = row * tileSize_, s = tileSize_, t = std::min(HOVER_THICKNESS, s / 2);
+    const float edges[4][4] = {{x, y, s, t}, {x, y + s - t, s, t}, {x, y, t, s}, {x + s - t, y, t, s}};
+    for (const float* e : edges) {
+        sf::Vertex quad[4];
+        setQuad(quad, e[0], e[1], e[2], e[3]);
+        for (int k = 0; k < 4; ++k) {
+            quad[k].color = sf::Color::Cyan;
+            hover_.append(quad[k]);
+        }
+    }
+}
+
+void TileMapRenderer::setLabelTint(sf::Color tint) {
+    if (tint == tint_) return;
+    tint_ = tint;
+    if (shaderReady_) {
+        tintShader_.setUniform("tint", sf::Glsl::Vec4(tint));
+        return;
+    }
+    for (size_t i = 0; i < labels_.getVertexCount(); ++i) labels_[i].color = tint;
+}
+
+void TileMapRenderer::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    target.draw(fills_, states);
+    target.draw(lines_, states);
+    if (labelsVisible_ && labels_.getVertexCount() > 0) {
+        sf::RenderStates labelStates = states;
+        labelStates.texture = &atlas_.getTexture();
+        if (shaderReady_) labelStates.shader = &tintShader_;
+        target.draw(labels_, labelStates);
+    }
+    if (hover_.getVertexCount() > 0) target.draw(hover_, states);
+}
@@ -0,0 +1,62 @@
+#ifndef TILEMAPRENDERER_H
+#define TILEMAPRENDERER_H
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+
+// Draws a grid of tiles in a fixed handful of draw calls, whatever the
+// board size: one vertex array of fill quads, one of grid lines, one of
+// label quads textured from a small atlas, and the hover outline.
+//
+// Vertices only change when a tile does: setTileColor() rewrites that
+// tile's four vertices and nothing else. Every label string is rendered
+// once into the atlas; the labels' shared tint goes through a shader
+// uniform, or, where shaders are not available, a recolor of the label
+// vertices that only happens when the tint actually changes.
+class TileMapRenderer : public sf::Drawable {
+public:
+    TileMapRenderer();
+
+    // labels is row-major, one per tile; "" for none.
+    void build(int cols, int rows, int tileSize, const std::vector<std::string>& labels, const sf::Font& font);
+
+    int cols() const { return cols_; }
+    int rows() const { return rows_; }
+    int tileSize() const { return tileSize_; }
+
+    // Tile under a pixel, by integer division; false if off the board.
+    bool tileAt(sf::Vector2i pixel, int& col, int& row) const;
+
+    void setTileColor(int col, int row, sf::Color color);
+    // Outline one tile; a negative column clears it.
+    void setHover(int col, int row);
+    void setLabelTint(sf::Color tint);
+    // Labels are skipped when tiles are too small to read them.
+    void setLabelsVisible(bool visible) { labelsVisible_ = visible; }
+
+    bool usingShader() const { return shaderReady_; }
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    void buildAtlas(const std::vector<std::string>& labels, const sf::Font& font);
+    static void setQuad(sf::Vertex* quad, float x, float y, float w, float h);
+
+    int cols_, rows_, tileSize_;
+    sf::VertexArray fills_;     // 4 vertices per tile
+    sf::VertexArray lines_;     // grid
+    sf::VertexArray labels_;    // 4 vertices per labelled tile
+    sf::VertexArray hover_;     // 4 thin quads around the hovered tile
+    int hoverCol_, hoverRow_;
+
+    sf::RenderTexture atlas_;
+    std::vector<std::string> atlasNames_;
+    std::vector<sf::FloatRect> atlasRects_;
+    bool labelsVisible_;
+
+    sf::Shader tintShader_;
+    bool shaderReady_;
+    sf::Color tint_;
+};
+
+#endif
@@ -1,183 +1,352 @@
-#include <SFML/Graphics.hpp>
-#include <iostream>
-#include <vector>
-#include <cmath> // For sine wave glow
-
-const int TILE_SIZE = 100;
-const int ROWS = 6;
-const int COLS = 6;
-const float TIME_LIMIT = 60.0f;
-
-enum TileType { EMPTY, START, END, RESISTOR, WIRE, DIODE, CAPACITOR, BATTERY };
-
-struct Tile {
-    TileType type;
-    sf::RectangleShape shape;
-    sf::Text label;
-    bool visited = false;
-};
-
-std::vector<sf::Vector2i> validPath = {
-    {0,0}, {0,1}, {0,2}, {0,3}, {1,2}, {2,2}, {3,2}, {3,3}, {3,4}, {3,5}
-};
-
-bool isValidStep(int index, sf::Vector2i pos) {
-    return index < validPath.size() && validPath[index] == pos;
-}
-
-bool isComponent(TileType type) {
-    return type != EMPTY;
-}
-
-int main() {
-    sf::RenderWindow window(sf::VideoMode(COLS * TILE_SIZE, ROWS * TILE_SIZE + 50), "Circuit Maze Game");
-
-    sf::Font font;
-    if (!font.loadFromFile("arial.ttf")) {
-        std::cerr << "Font loading failed!\n";
-        return -1;
-    }
-
-    sf::Texture backgroundTexture;
-    if (!backgroundTexture.loadFromFile("background.png")) {
-        std::cerr << "Background image loading failed!\n";
-        return -1;
-    }
-    sf::Sprite backgroundSprite(backgroundTexture);
-    backgroundSprite.setScale(
-        float(COLS * TILE_SIZE) / backgroundTexture.getSize().x,
-        float(ROWS * TILE_SIZE) / backgroundTexture.getSize().y
-    );
-
-    Tile grid[ROWS][COLS];
-    for (int y = 0; y < ROWS; ++y) {
-        for (int x = 0; x < COLS; ++x) {
-            grid[y][x].type = EMPTY;
-            grid[y][x].shape.setSize(sf::Vector2f(TILE_SIZE - 2, TILE_SIZE - 2));
-            grid[y][x].shape.setFillColor(sf::Color::Transparent);
-            grid[y][x].shape.setOutlineColor(sf::Color::White);
-            grid[y][x].shape.setOutlineThickness(1);
-            grid[y][x].shape.setPosition(x * TILE_SIZE, y * TILE_SIZE);
-
-            grid[y][x].label.setFont(font);
-            grid[y][x].label.setCharacterSize(20);
-            grid[y][x].label.setFillColor(sf::Color::White);
-            grid[y][x].label.setPosition(x * TILE_SIZE + 10, y * TILE_SIZE + 35);
-        }
-    }
-
-    std::vector<std::pair<sf::Vector2i, std::string>> components = {
-        {{0,0}, "S"}, {{0,1}, "R"}, {{0,2}, "W"}, {{0,3}, "D"},
-        {{1,2}, "W"}, {{2,2}, "C"}, {{3,2}, "B"},
-        {{3,3}, "W"}, {{3,4}, "W"}, {{3,5}, "E"}
-    };
-
-    for (auto& comp : components) {
-        int y = comp.first.y;
-        int x = comp.first.x;
-        std::string label = comp.second;
-
-        grid[y][x].label.setString(label);
-        if (label == "S") grid[y][x].type = START;
-        else if (label == "E") grid[y][x].type = END;
-        else if (label == "R") grid[y][x].type = RESISTOR;
-        else if (label == "C") grid[y][x].type = CAPACITOR;
-        else if (label == "D") grid[y][x].type = DIODE;
-        else if (label == "B") grid[y][x].type = BATTERY;
-        else if (label == "W") grid[y][x].type = WIRE;
-    }
-
-    int pathIndex = 0;
-    bool gameWon = false, gameLost = false;
-
-    sf::Clock clock;
-    sf::Text timerText;
-    timerText.setFont(font);
-    timerText.setCharacterSize(20);
-    timerText.setFillColor(sf::Color::Yellow);
-    timerText.setPosition(10, ROWS * TILE_SIZE + 10);
-
-    sf::Text resultText;
-    resultText.setFont(font);
-    resultText.setCharacterSize(24);
-    resultText.setFillColor(sf::Color::White);
-    resultText.setPosition(200, ROWS * TILE_SIZE + 10);
-
-    while (window.isOpen()) {
-        sf::Event event;
-        float elapsed = clock.getElapsedTime().asSeconds();
-
-        float glow = 200 + 55 * std::sin(elapsed * 2.0f);
-        backgroundSprite.setColor(sf::Color(glow, glow, glow));
-
-        timerText.setString("Time Left: " + std::to_string(int(TIME_LIMIT - elapsed)));
-
-        if (elapsed >= TIME_LIMIT && !gameWon) {
-            gameLost = true;
-            resultText.setString("Time's up! You lost.");
-        }
-
-        sf::Vector2i mousePos = sf::Mouse::getPosition(window);
-
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed)
-                window.close();
-
-            if (!gameWon && !gameLost && event.type == sf::Event::MouseButtonPressed) {
-                int x = mousePos.x / TILE_SIZE;
-                int y = mousePos.y / TILE_SIZE;
-
-                if (x < COLS && y < ROWS) {
-                    if (isValidStep(pathIndex, {y, x})) {
-                        grid[y][x].visited = true;
-                        grid[y][x].shape.setFillColor(sf::Color(0, 255, 0, 100));
-                        pathIndex++;
-                        if (pathIndex == validPath.size()) {
-                            gameWon = true;
-                            resultText.setString("Success! You completed the circuit.");
-                        }
-                    } else {
-                        grid[y][x].shape.setFillColor(sf::Color(255, 0, 0, 100));
-                        gameLost = true;
-                        resultText.setString("Wrong step! You lost.");
-                    }
-                }
-            }
-        }
-
-        window.clear();
-        window.draw(backgroundSprite);
-
-        for (int y = 0; y < ROWS; ++y) {
-            for (int x = 0; x < COLS; ++x) {
-                Tile& tile = grid[y][x];
-
-                // Animate glow for components
-                if (isComponent(tile.type)) {
-                    tile.label.setFillColor(sf::Color(glow, glow, 255));
-                }
-
-                // Hover effect
-                sf::FloatRect bounds = tile.shape.getGlobalBounds();
-                if (bounds.contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y))) {
-                    tile.shape.setOutlineColor(sf::Color::Cyan);
-                    tile.shape.setOutlineThickness(3);
-                } else {
-                    tile.shape.setOutlineColor(sf::Color::White);
-                    tile.shape.setOutlineThickness(1);
-                }
-
-                window.draw(tile.shape);
-                window.draw(tile.label);
-            }
-        }
-
-        window.draw(timerText);
-        if (gameWon || gameLost)
-            window.draw(resultText);
-
-        window.display();
-    }
-
-    return 0;
-}
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <cmath> // For sine wave glow
+#include "AllocTracker.h"
+#include "FramePacer.h"
+#include "LevelPack.h"
+#include "Maze.h"
+#include "TileMapRenderer.h"
+
+const int BOARD_PIXELS = 600;
+const int DEFAULT_SIZE = 6;
+const int MAX_SIZE = 256;
+const float DEFAULT_TIME_LIMIT = 60.0f;
+const char* LEVEL_PACK = "../../levels/levels.pak";
+
+enum TileType { EMPTY, START, END, RESISTOR, WIRE, DIODE, CAPACITOR, BATTERY };
+
+struct Tile {
+    TileType type;
+    bool visited = false;
+    float flashUntil = 0.0f;   // red after a click that doesn't connect
+};
+
+// A board: the maze's walls, a component label per cell, and the two
+// terminals the circuit has to join. Any route from start to end through
+// open passages completes the circuit.
+struct MazeLevel {
+    Maze maze;
+    std::vector<std::string> labels;   // row-major, "" for an empty cell
+    MazeCell start, end;
+    float timeLimit;
+};
+
+// A random size x size maze with S top-left, E bottom-right and components
+// everywhere else. A few extra walls are knocked out so there is more than
+// one right answer. The solver confirms the terminals are joined, and the
+// shortest route sets the time limit.
+MazeLevel generateLevel(int size, std::mt19937& rng) {
+    static const char* parts[] = {"W", "W", "W", "R", "D", "C", "B"};
+    MazeLevel level;
+    level.start = MazeCell{0, 0};
+    level.end = MazeCell{size - 1, size - 1};
+    std::vector<MazeCell> route;
+    do {
+        level.maze.reset(size, size);
+        level.maze.generateWilson(rng);
+        level.maze.braid(0.1, rng);
+        route = level.maze.solveBFS(level.start, level.end);
+    } while (route.empty());
+
+    level.labels.assign(size * size, "");
+    for (std::string& label : level.labels) label = parts[rng() % 7];
+    level.labels[0] = "S";
+    level.labels[size * size - 1] = "E";
+    level.timeLimit = std::max(DEFAULT_TIME_LIMIT, route.size() * 1.5f);
+    return level;
+}
+
+// First maze in the pack. Only the passages along its path are open, so
+// that path is the one route. levelc has already checked it, so this only
+// copies the numbers out of the mapping.
+bool loadLevel(const LevelPack& pack, MazeLevel& level) {
+    std::vector<size_t> mazes = pack.levelsOfKind("maze");
+    if (mazes.empty()) return false;
+    size_t id = mazes[0];
+
+    size_t count = 0;
+    const double* size = pack.numbers(id, "size", count);
+    if (count != 2) return false;
+    int rows = static_cast<int>(size[0]);
+    int cols = static_cast<int>(size[1]);
+
+    const double* cells = pack.numbers(id, "path", count);
+    std::vector<MazeCell> path;
+    for (size_t i = 0; i + 1 < count; i += 2) {
+        path.push_back(MazeCell{static_cast<int>(cells[i + 1]), static_cast<int>(cells[i])});
+    }
+    std::istringstream labels(pack.text(id, "labels"));
+    std::vector<std::string> pathLabels;
+    std::string label;
+    while (labels >> label) pathLabels.push_back(label);
+    if (path.size() < 2 || pathLabels.size() != path.size()) return false;
+
+    level.maze = Maze::fromPath(cols, rows, path);
+    level.start = path.front();
+    level.end = path.back();
+    if (level.maze.solveBFS(level.start, level.end).empty()) return false;
+    level.labels.assign(rows * cols, "");
+    for (size_t i = 0; i < path.size(); ++i) level.labels[path[i].row * cols + path[i].col] = pathLabels[i];
+    level.timeLimit = static_cast<float>(pack.number(id, "time", 0, DEFAULT_TIME_LIMIT));
+    return true;
+}
+
+bool isComponent(TileType type) {
+    return type != EMPTY;
+}
+
+int tileSizeFor(const MazeLevel& level) {
+    return std::max(2, BOARD_PIXELS / std::max(level.maze.cols(), level.maze.rows()));
+}
+
+void setupGrid(std::vector<Tile>& grid, TileMapRenderer& renderer, const MazeLevel& level, const sf::Font& font, int tileSize) {
+    int cols = level.maze.cols(), rows = level.maze.rows();
+    grid.assign(rows * cols, Tile());
+    renderer.build(cols, rows, tileSize, level.labels, font);
+    // Too small to read below this; the colours still show the route.
+    renderer.setLabelsVisible(tileSize >= 16);
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < cols; ++x) {
+            Tile& tile = grid[y * cols + x];
+            tile.type = EMPTY;
+            const std::string& label = level.labels[y * cols + x];
+            if (label == "S") tile.type = START;
+            else if (label == "E") tile.type = END;
+            else if (label == "R") tile.type = RESISTOR;
+            else if (label == "C") tile.type = CAPACITOR;
+            else if (label == "D") tile.type = DIODE;
+            else if (label == "B") tile.type = BATTERY;
+            else if (label == "W") tile.type = WIRE;
+        }
+    }
+}
+
+sf::Color tileColor(const Tile& tile, float now) {
+    if (tile.flashUntil > now) return sf::Color(255, 0, 0, 100);
+    if (tile.visited) return sf::Color(0, 255, 0, 100);
+    return sf::Color::Transparent;
+}
+
+// One line per closed wall, plus the border.
+sf::VertexArray buildWalls(const Maze& maze, int tileSize) {
+    sf::VertexArray walls(sf::Lines);
+    sf::Color color(255, 200, 0);
+    auto line = [&](float x0, float y0, float x1, float y1) {
+        walls.append(sf::Vertex(sf::Vector2f(x0, y0), color));
+        walls.append(sf::Vertex(sf::Vector2f(x1, y1), color));
+    };
+    float w = maze.cols() * tileSize, h = maze.rows() * tileSize;
+    line(0, 0, w, 0);
+    line(w, 0, w, h);
+    line(w, h, 0, h);
+    line(0, h, 0, 0);
+    for (int r = 0; r < maze.rows(); ++r) {
+        for (int c = 0; c < maze.cols(); ++c) {
+            float x = (c + 1) * tileSize, y = (r + 1) * tileSize;
+            if (c + 1 < maze.cols() && !maze.isOpen(MazeCell{c, r}, Maze::EAST)) line(x, r * tileSize, x, y);
+            if (r + 1 < maze.rows() && !maze.isOpen(MazeCell{c, r}, Maze::SOUTH)) line(c * tileSize, y, x, y);
+        }
+    }
+    return walls;
+}
+
+// Usage: circuit_maze [size]
+// With a size, plays random size x size mazes (N for a new one). Without,
+// plays the level pack's maze, or a random 6x6 one if there is no pack.
+int main(int argc, char* argv[]) {
+    ALLOC_TRACK_START("circuit_maze");
+    int size = argc > 1 ? std::max(2, std::min(std::atoi(argv[1]), MAX_SIZE)) : 0;
+    std::mt19937 rng(static_cast<unsigned>(std::time(nullptr)));
+
+    LevelPack pack;
+    MazeLevel level;
+    bool fromPack = size == 0 && pack.open(LevelPack::defaultPath(LEVEL_PACK)) && loadLevel(pack, level);
+    if (!fromPack) level = generateLevel(size > 0 ? size : DEFAULT_SIZE, rng);
+    int tileSize = tileSizeFor(level);
+
+    sf::RenderWindow window(sf::VideoMode(level.maze.cols() * tileSize, level.maze.rows() * tileSize + 50), "Circuit Maze Game");
+
+    sf::Font font;
+    if (!font.loadFromFile("arial.ttf")) {
+        std::cerr << "Font loading failed!\n";
+        return -1;
+    }
+
+    sf::Texture backgroundTexture;
+    if (!backgroundTexture.loadFromFile("background.png")) {
+        std::cerr << "Background image loading failed!\n";
+        return -1;
+    }
+    sf::Sprite backgroundSprite(backgroundTexture);
+    std::vector<Tile> grid;
+    TileMapRenderer renderer;
+    sf::VertexArray walls;
+    // The player's route so far, from the start terminal.
+    std::vector<MazeCell> route;
+    // Cells showing a wrong-click flash, to clear when it runs out.
+    std::vector<MazeCell> flashing;
+    bool gameWon = false, gameLost = false;
+
+    sf::Clock clock;
+    sf::Text timerText;
+    timerText.setFont(font);
+    timerText.setCharacterSize(20);
+    timerText.setFillColor(sf::Color::Yellow);
+
+    sf::Text resultText;
+    resultText.setFont(font);
+    resultText.setCharacterSize(24);
+    resultText.setFillColor(sf::Color::White);
+
+    // 60 fps, vsync while frames keep up with it. F3 shows the frame time,
+    // to check big boards (e.g. circuit_maze 200) still keep up.
+    FramePacer pacer(60.0);
+    pacer.useAdaptiveVsync([&](bool on) { window.setVerticalSyncEnabled(on); });
+    bool showFrameTime = false;
+    sf::Text frameText;
+    frameText.setFont(font);
+    frameText.setCharacterSize(16);
+    frameText.setFillColor(sf::Color::Cyan);
+
+    auto startLevel = [&]() {
+        tileSize = tileSizeFor(level);
+        float w = level.maze.cols() * tileSize, h = level.maze.rows() * tileSize;
+        window.setSize(sf::Vector2u(w, h + 50));
+        window.setView(sf::View(sf::FloatRect(0, 0, w, h + 50)));
+        setupGrid(grid, renderer, level, font, tileSize);
+        walls = buildWalls(level.maze, tileSize);
+        backgroundSprite.setScale(w / backgroundTexture.getSize().x, h / backgroundTexture.getSize().y);
+        timerText.setPosition(10, h + 10);
+        resultText.setPosition(200, h + 10);
+        frameText.setPosition(std::max(10.0f, w - 150), h + 14);
+        route.assign(1, level.start);
+        flashing.clear();
+        grid[level.start.row * level.maze.cols() + level.start.col].visited = true;
+        renderer.setTileColor(level.start.col, level.start.row, tileColor(grid[level.start.row * level.maze.cols() + level.start.col], 0.0f));
+        gameWon = gameLost = false;
+        clock.restart();
+    };
+    startLevel();
+
+    sf::Clock reloadClock;
+
+    while (window.isOpen()) {
+        // Pick up a rebuilt pack (make -C levels) and restart on its maze.
+        if (fromPack && reloadClock.getElapsedTime().asSeconds() >= 1.0f) {
+            reloadClock.restart();
+            MazeLevel fresh;
+            if (pack.reloadIfChanged() && loadLevel(pack, fresh)) {
+                level = fresh;
+                startLevel();
+            }
+        }
+
+        sf::Event event;
+        float elapsed = clock.getElapsedTime().asSeconds();
+
+        float glow = 200 + 55 * std::sin(elapsed * 2.0f);
+        backgroundSprite.setColor(sf::Color(glow, glow, glow));
+
+        timerText.setString("Time Left: " + std::to_string(int(level.timeLimit - elapsed)));
+
+        if (elapsed >= level.timeLimit && !gameWon) {
+            gameLost = true;
+            resultText.setString("Time's up! You lost.");
+        }
+
+        sf::Vector2i mousePos = sf::Mouse::getPosition(window);
+
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed)
+                window.close();
+
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3)
+                showFrameTime = !showFrameTime;
+
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::N) {
+                fromPack = false;
+                level = generateLevel(size > 0 ? size : level.maze.cols(), rng);
+                startLevel();
+                elapsed = 0.0f;
+            }
+
+            if (!gameWon && !gameLost && event.type == sf::Event::MouseButtonPressed) {
+                int x, y;
+                MazeCell cell = {-1, -1};
+                if (renderer.tileAt(sf::Vector2i(event.mouseButton.x, event.mouseButton.y), x, y)) cell = MazeCell{x, y};
+
+                if (level.maze.contains(cell)) {
+                    Tile& tile = grid[y * level.maze.cols() + x];
+                    std::vector<MazeCell>::iterator onRoute = std::find(route.begin(), route.end(), cell);
+                    if (onRoute != route.end()) {
+                        // Clicking back onto the route undoes everything after that cell.
+                        for (std::vector<MazeCell>::iterator it = onRoute + 1; it != route.end(); ++it) {
+                            Tile& undone = grid[it->row * level.maze.cols() + it->col];
+                            undone.visited = false;
+                            renderer.setTileColor(it->col, it->row, tileColor(undone, elapsed));
+                        }
+                        route.erase(onRoute + 1, route.end());
+                    } else if (level.maze.connected(route.back(), cell)) {
+                        tile.visited = true;
+                        renderer.setTileColor(x, y, tileColor(tile, elapsed));
+                        route.push_back(cell);
+                        if (cell == level.end && level.maze.isPath(route, level.start, level.end)) {
+                            gameWon = true;
+                            resultText.setString("Success! You completed the circuit.");
+                        }
+                    } else {
+                        tile.flashUntil = elapsed + 0.3f;
+                        renderer.setTileColor(x, y, tileColor(tile, elapsed));
+                        flashing.push_back(cell);
+                    }
+                }
+            }
+        }
+
+        // Only tiles whose flash has run out get new colours.
+        for (size_t i = 0; i < flashing.size();) {
+            Tile& tile = grid[flashing[i].row * level.maze.cols() + flashing[i].col];
+            if (tile.flashUntil > elapsed) {
+                ++i;
+                continue;
+            }
+            renderer.setTileColor(flashing[i].col, flashing[i].row, tileColor(tile, elapsed));
+            flashing[i] = flashing.back();
+            flashing.pop_back();
+        }
+
+        // Hover effect
+        int hoverCol, hoverRow;
+        if (renderer.tileAt(mousePos, hoverCol, hoverRow)) renderer.setHover(hoverCol, hoverRow);
+        else renderer.setHover(-1, -1);
+
+        // Animate glow for components
+        renderer.setLabelTint(sf::Color(glow, glow, 255));
+
+        window.clear();
+        window.draw(backgroundSprite);
+        window.draw(renderer);
+        window.draw(walls);
+
+        window.draw(timerText);
+        if (gameWon || gameLost)
+            window.draw(resultText);
+        if (showFrameTime) {
+            FramePacer::Stats stats = pacer.stats();
+            frameText.setString(std::to_string(int(stats.meanMs + 0.5f)) + " ms/frame, worst " +
+                                std::to_string(int(stats.worstMs + 0.5f)));
+            window.draw(frameText);
+        }
+
+        window.display();
+        ALLOC_FRAME();
+        pacer.tick();
+    }
+
+    return 0;
+}
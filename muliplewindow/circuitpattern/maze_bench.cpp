@@ -0,0 +1,64 @@
+// Generation and solve times for the circuit maze, from the 6x6 board the
+// game shows up to 256x256. Every maze is checked: both solvers must find
+// a route of the same length and isPath() must accept it.
+//
+//   maze_bench [max size] [seed]     (defaults: 256, 1)
+#include "Maze.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char** argv) {
+    int maxSize = argc > 1 ? std::atoi(argv[1]) : 256;
+    unsigned seed = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 1u;
+    std::mt19937 rng(seed);
+    const char* names[] = {"dfs", "wilson", "wilson+braid"};
+
+    std::printf("%-13s %5s %7s %10s %10s %8s %10s %8s\n",
+                "generator", "size", "route", "gen ms", "bfs ms", "bfs seen", "a* ms", "a* seen");
+    for (int size = 6; size <= maxSize; size = size < 16 ? 16 : size * 2) {
+        int reps = size <= 16 ? 200 : size <= 64 ? 20 : 3;
+        for (int kind = 0; kind < 3; ++kind) {
+            double genMs = 0, bfsMs = 0, astarMs = 0;
+            size_t route = 0, bfsSeen = 0, astarSeen = 0;
+            MazeCell from = {0, 0}, to = {size - 1, size - 1};
+            for (int rep = 0; rep < reps; ++rep) {
+                Maze maze(size, size);
+                Clock::time_point t = Clock::now();
+                if (kind == 0) maze.generateDFS(rng);
+                else maze.generateWilson(rng);
+                if (kind == 2) maze.braid(0.1, rng);
+                genMs += msSince(t);
+
+                t = Clock::now();
+                std::vector<MazeCell> a = maze.solveBFS(from, to);
+                bfsMs += msSince(t);
+                bfsSeen += maze.lastExplored();
+                t = Clock::now();
+                std::vector<MazeCell> b = maze.solveAStar(from, to);
+                astarMs += msSince(t);
+                astarSeen += maze.lastExplored();
+
+                if (a.size() != b.size() || !maze.isPath(a, from, to) || !maze.isPath(b, from, to)) {
+                    std::printf("%s %dx%d seed %u: solvers disagree (%zu vs %zu)\n",
+                                names[kind], size, size, seed, a.size(), b.size());
+                    return 1;
+                }
+                route += a.size();
+            }
+            std::printf("%-13s %5d %7zu %10.3f %10.3f %8zu %10.3f %8zu\n", names[kind], size, route / reps,
+                        genMs / reps, bfsMs / reps, bfsSeen / reps, astarMs / reps, astarSeen / reps);
+        }
+    }
+    return 0;
+}
@@ -1,10 +1,10 @@
-#ifndef PUZZLEGAME_H
-#define PUZZLEGAME_H
-
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
-#include <SDL2/SDL_image.h>
-
-void runPuzzle(SDL_Window* window, SDL_Renderer* renderer, TTF_Font* font);
-
-#endif
+#ifndef PUZZLEGAME_H
+#define PUZZLEGAME_H
+
+#include "FontCache.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+void runPuzzle(SDL_Window* window, SDL_Renderer* renderer, FontCache& font);
+
+#endif
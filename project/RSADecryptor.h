@@ -1,10 +1,10 @@
-#ifndef RSADECRYPTOR_H
-#define RSADECRYPTOR_H
-
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
-#include <SDL2/SDL_image.h>
-
-void runRSADecyptor(SDL_Renderer* renderer, TTF_Font* font);
-
-#endif
+#ifndef RSADECRYPTOR_H
+#define RSADECRYPTOR_H
+
+#include "FontCache.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+
+void runRSADecyptor(SDL_Renderer* renderer, FontCache& font);
+
+#endif
@@ -1,203 +1,385 @@
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
-#include <SDL2/SDL_image.h>  // ✅ ADD THIS
-#include "SpaceShooter.h"
-#include "Utils.h"
-#include <iostream>
-#include <vector>
-#include <ctime>
-#include <cmath>
-#include <algorithm>
-
-
-const int SCREEN_WIDTH = 800;
-const int SCREEN_HEIGHT = 600;
-const int WIN_SCORE = 100;
-
-struct Bullet {
-    SDL_Rect rect;
-    int speed = -10;
-};
-
-struct Enemy {
-    SDL_Rect rect;
-    std::string label;
-    int speed = 1;
-};
-
-bool checkCollision(SDL_Rect a, SDL_Rect b) {
-    return SDL_HasIntersection(&a, &b);
-}
-
-std::string getPlayerName(SDL_Renderer* renderer, TTF_Font* font) {
-    SDL_StartTextInput();
-    std::string name;
-    SDL_Event e;
-    bool done = false;
-    SDL_Color white = {255, 255, 255};
-
-    while (!done) {
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
-        renderText(renderer, font, "Enter Your Name:", white, 250, 200);
-        renderText(renderer, font, name + "_", white, 250, 250);
-        SDL_RenderPresent(renderer);
-
-        while (SDL_PollEvent(&e)) {
-            if (e.type == SDL_QUIT) return "Player";
-            if (e.type == SDL_TEXTINPUT) name += e.text.text;
-            if (e.type == SDL_KEYDOWN) {
-                if (e.key.keysym.sym == SDLK_BACKSPACE && !name.empty()) name.pop_back();
-                if (e.key.keysym.sym == SDLK_RETURN && !name.empty()) done = true;
-            }
-        }
-    }
-
-    SDL_StopTextInput();
-    return name;
-}
-
-std::string generateEncryptedCode() {
-    std::string code = "Encrypted code: ";
-    for (int i = 0; i < 16; ++i) {
-        code += 'A' + rand() % 26;
-    }
-    return code;
-}
-
-void showEndScreen(SDL_Renderer* renderer, TTF_Font* font, const std::string& name, int score, bool won) {
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
-
-    renderText(renderer, font, "Game Over!", {255, 255, 255}, 320, 180);
-    renderText(renderer, font, "Player: " + name, {255, 255, 255}, 300, 230);
-    renderText(renderer, font, "Score: " + std::to_string(score), {255, 255, 255}, 300, 270);
-
-    if (won) {
-        renderText(renderer, font, generateEncryptedCode(), {0, 255, 0}, 220, 310);
-    } else {
-        renderText(renderer, font, "Try Again!", {255, 0, 0}, 300, 310);
-    }
-
-    SDL_RenderPresent(renderer);
-    SDL_Delay(5000);
-}
-
-void runSpaceShooter(SDL_Renderer* renderer, TTF_Font* font) {
-    srand(static_cast<unsigned>(time(NULL)));
-
-    SDL_Surface* bgSurface = IMG_Load("assets/space_background.png");
-    SDL_Surface* ship1Surface = IMG_Load("assets/ship1.png");
-    SDL_Surface* ship2Surface = IMG_Load("assets/ship2.png");
-
-    if (!bgSurface || !ship1Surface || !ship2Surface) {
-        std::cerr << "Image load error: " << IMG_GetError() << "\n";
-        if (bgSurface) SDL_FreeSurface(bgSurface);
-        if (ship1Surface) SDL_FreeSurface(ship1Surface);
-        if (ship2Surface) SDL_FreeSurface(ship2Surface);
-        return;
-    }
-
-    SDL_Texture* bgTex = SDL_CreateTextureFromSurface(renderer, bgSurface);
-    SDL_Texture* playerTex = SDL_CreateTextureFromSurface(renderer, ship1Surface);
-    SDL_Texture* enemyTex = SDL_CreateTextureFromSurface(renderer, ship2Surface);
-
-    SDL_FreeSurface(bgSurface);
-    SDL_FreeSurface(ship1Surface);
-    SDL_FreeSurface(ship2Surface);
-
-    std::string playerName = getPlayerName(renderer, font);
-    SDL_Rect player = {SCREEN_WIDTH / 2 - 25, SCREEN_HEIGHT - 60, 50, 40};
-    std::vector<Bullet> bullets;
-    std::vector<Enemy> enemies;
-    std::string labels[] = {"PROJECT", "QUIZ", "LAB", "EXAM"};
-
-    int score = 0;
-    bool quit = false;
-    SDL_Event e;
-    Uint32 lastSpawnTime = SDL_GetTicks();
-
-    while (!quit) {
-        while (SDL_PollEvent(&e)) {
-            if (e.type == SDL_QUIT) quit = true;
-            if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_SPACE) {
-                Bullet b;
-                b.rect = {player.x + player.w / 2 - 5, player.y, 10, 20};
-                bullets.push_back(b);
-            }
-        }
-
-        const Uint8* keys = SDL_GetKeyboardState(NULL);
-        if (keys[SDL_SCANCODE_LEFT] && player.x > 0) player.x -= 7;
-        if (keys[SDL_SCANCODE_RIGHT] && player.x < SCREEN_WIDTH - player.w) player.x += 7;
-
-        for (auto& b : bullets) b.rect.y += b.speed;
-        bullets.erase(std::remove_if(bullets.begin(), bullets.end(), [](Bullet& b) {
-            return b.rect.y < 0;
-        }), bullets.end());
-
-        Uint32 current = SDL_GetTicks();
-        if (current - lastSpawnTime > 1000) {
-            Enemy en;
-            en.rect = {rand() % (SCREEN_WIDTH - 60), 0, 60, 40};
-            en.label = labels[rand() % 4];
-            en.speed = 2 + rand() % 3;
-            enemies.push_back(en);
-            lastSpawnTime = current;
-        }
-
-        for (auto& en : enemies) en.rect.y += en.speed;
-
-        for (size_t i = 0; i < bullets.size(); ++i) {
-            bool hit = false;
-            for (size_t j = 0; j < enemies.size(); ++j) {
-                if (checkCollision(bullets[i].rect, enemies[j].rect)) {
-                    bullets.erase(bullets.begin() + i);
-                    enemies.erase(enemies.begin() + j);
-                    score += 10;
-                    --i;
-                    hit = true;
-                    break;
-                }
-            }
-            if (hit) break;
-        }
-
-        enemies.erase(std::remove_if(enemies.begin(), enemies.end(), [&](Enemy& en) {
-            if (en.rect.y > SCREEN_HEIGHT) {
-                quit = true;
-                return true;
-            }
-            return false;
-        }), enemies.end());
-
-        if (score >= WIN_SCORE) quit = true;
-
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
-        SDL_RenderCopy(renderer, bgTex, NULL, NULL);
-        SDL_RenderCopy(renderer, playerTex, NULL, &player);
-
-        int glow = 128 + 127 * sin(SDL_GetTicks() / 300.0);
-        SDL_Color glowColor = {(Uint8)glow, (Uint8)glow, (Uint8)glow, 255};
-
-        for (auto& en : enemies) {
-            SDL_RenderCopy(renderer, enemyTex, NULL, &en.rect);
-            renderText(renderer, font, en.label, glowColor, en.rect.x + 5, en.rect.y + 10);
-        }
-
-        SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
-        for (auto& b : bullets) {
-            SDL_RenderFillRect(renderer, &b.rect);
-        }
-
-        renderText(renderer, font, "Score: " + std::to_string(score), {255, 255, 255}, 10, 10);
-        SDL_RenderPresent(renderer);
-        SDL_Delay(16);
-    }
-
-    showEndScreen(renderer, font, playerName, score, score >= WIN_SCORE);
-    SDL_DestroyTexture(bgTex);
-    SDL_DestroyTexture(playerTex);
-    SDL_DestroyTexture(enemyTex);
-}
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <SDL2/SDL_image.h>  // ✅ ADD THIS
+#include "SpaceShooter.h"
+#include "Utils.h"
+#include "TextField.h"
+#include "ScoreClient.h"
+#include "InputSampler.h"
+#include "TripleBuffer.h"
+#include "FrameArena.h"
+#include "SpriteAtlas.h"
+#include "AllocTracker.h"
+#include <iostream>
+#include <vector>
+#include <ctime>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+
+const int SCREEN_WIDTH = 800;
+const int SCREEN_HEIGHT = 600;
+const int WIN_SCORE = 100;
+const char* const SHIP_ATLAS_PATH = "../atlas/out/shooter.atlas";
+
+struct Bullet {
+    SDL_Rect rect;
+    int speed = -10;
+};
+
+struct Enemy {
+    SDL_Rect rect;
+    std::string label;
+    int speed = 1;
+};
+
+bool checkCollision(SDL_Rect a, SDL_Rect b) {
+    return SDL_HasIntersection(&a, &b);
+}
+
+std::string getPlayerName(SDL_Renderer* renderer, FontCache& font) {
+    SDL_StartTextInput();
+    SDL_Event e;
+    SDL_Color white = {255, 255, 255, 255};
+    TextField nameField(renderer, font.font(), white, {250, 250, 300, 0});
+
+    while (!nameField.submitted()) {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        renderText(renderer, font, "Enter Your Name:", white, 250, 200);
+        nameField.render();
+        SDL_RenderPresent(renderer);
+        ALLOC_FRAME();
+
+        while (SDL_PollEvent(&e)) {
+            if (e.type == SDL_QUIT) return "Player";
+            nameField.handleEvent(e);
+        }
+    }
+
+    SDL_StopTextInput();
+    return nameField.text();
+}
+
+std::string generateEncryptedCode() {
+    std::string code = "Encrypted code: ";
+    for (int i = 0; i < 16; ++i) {
+        code += 'A' + rand() % 26;
+    }
+    return code;
+}
+
+void showEndScreen(SDL_Renderer* renderer, FontCache& font, const std::string& name, int score, bool won, size_t rank) {
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+
+    renderText(renderer, font, "Game Over!", {255, 255, 255, 255}, 320, 180);
+    renderText(renderer, font, "Player: " + name, {255, 255, 255, 255}, 300, 230);
+    renderText(renderer, font, "Score: " + std::to_string(score), {255, 255, 255, 255}, 300, 270);
+    if (rank > 0) {
+        renderText(renderer, font, "Leaderboard rank: #" + std::to_string(rank), {255, 255, 0, 255}, 300, 350);
+    }
+
+    if (won) {
+        renderText(renderer, font, generateEncryptedCode(), {0, 255, 0, 255}, 220, 310);
+    } else {
+        renderText(renderer, font, "Try Again!", {255, 0, 0, 255}, 300, 310);
+    }
+
+    SDL_RenderPresent(renderer);
+    SDL_Delay(5000);
+}
+
+
+const int PLAYER_SPEED = 7;   // pixels per tick
+
+// Input collected by the thread that polls events, for the simulation.
+struct ShooterInput {
+    std::atomic<bool> left{false}, right{false};
+    std::atomic<int> shots{0};       // presses of space not yet taken
+    std::atomic<Uint32> seq{0};      // presses of any game key so far
+    std::atomic<bool> quit{false};
+};
+
+// Which way the arrow keys push: -1, 0 or +1.
+int axisOf(bool left, bool right) {
+    return (right ? 1 : 0) - (left ? 1 : 0);
+}
+
+// Everything drawing needs from one simulation tick. The simulation writes
+// a whole frame and never touches it once published.
+struct ShooterFrame {
+    SDL_Rect player;
+    std::vector<Bullet> bullets;
+    std::vector<Enemy> enemies;
+    int score = 0;
+    bool over = false;
+    Uint32 inputSeq = 0;   // the frame reflects every key press up to this one
+    int axis = 0;          // the arrow keys as the tick saw them
+};
+
+// The game itself, one tick per call, at the pace the loop used to run
+// (a tick every 16 ms; speeds are per tick).
+class ShooterSim {
+public:
+    ShooterSim() : player{SCREEN_WIDTH / 2 - 25, SCREEN_HEIGHT - 60, 50, 40}, lastSpawnTime(SDL_GetTicks()) {}
+
+    void step(ShooterInput& input) {
+        ALLOC_TAG("simulation");
+        inputSeq = input.seq.load();
+        for (int n = input.shots.exchange(0); n > 0; --n) {
+            Bullet b;
+            b.rect = {player.x + player.w / 2 - 5, player.y, 10, 20};
+            bullets.push_back(b);
+        }
+        bool left = input.left.load(), right = input.right.load();
+        axis = axisOf(left, right);
+        if (left && player.x > 0) player.x -= PLAYER_SPEED;
+        if (right && player.x < SCREEN_WIDTH - player.w) player.x += PLAYER_SPEED;
+
+        for (auto& b : bullets) b.rect.y += b.speed;
+        bullets.erase(std::remove_if(bullets.begin(), bullets.end(), [](Bullet& b) {
+            return b.rect.y < 0;
+        }), bullets.end());
+
+        Uint32 current = SDL_GetTicks();
+        if (current - lastSpawnTime > 1000) {
+            Enemy en;
+            en.rect = {rand() % (SCREEN_WIDTH - 60), 0, 60, 40};
+            en.label = labels[rand() % 4];
+            en.speed = 2 + rand() % 3;
+            enemies.push_back(en);
+            lastSpawnTime = current;
+        }
+
+        for (auto& en : enemies) en.rect.y += en.speed;
+
+        for (size_t i = 0; i < bullets.size(); ++i) {
+            bool hit = false;
+            for (size_t j = 0; j < enemies.size(); ++j) {
+                if (checkCollision(bullets[i].rect, enemies[j].rect)) {
+                    bullets.erase(bullets.begin() + i);
+                    enemies.erase(enemies.begin() + j);
+                    score += 10;
+                    --i;
+                    hit = true;
+                    break;
+                }
+            }
+            if (hit) break;
+        }
+
+        enemies.erase(std::remove_if(enemies.begin(), enemies.end(), [&](Enemy& en) {
+            if (en.rect.y > SCREEN_HEIGHT) {
+                over = true;
+                return true;
+            }
+            return false;
+        }), enemies.end());
+
+        if (score >= WIN_SCORE) over = true;
+    }
+
+    // Copies into a reused frame, so its vectors keep their capacity.
+    void snapshot(ShooterFrame& out) const {
+        ALLOC_TAG("snapshot");
+        out.player = player;
+        out.bullets.assign(bullets.begin(), bullets.end());
+        out.enemies.assign(enemies.begin(), enemies.end());
+        out.score = score;
+        out.over = over;
+        out.inputSeq = inputSeq;
+        out.axis = axis;
+    }
+
+    bool isOver() const { return over; }
+
+private:
+    SDL_Rect player;
+    std::vector<Bullet> bullets;
+    std::vector<Enemy> enemies;
+    const std::string labels[4] = {"PROJECT", "QUIZ", "LAB", "EXAM"};
+    int score = 0;
+    bool over = false;
+    Uint32 lastSpawnTime;
+    Uint32 inputSeq = 0;
+    int axis = 0;
+};
+
+// Passes on what the sampler just took.
+void forwardInput(const InputSampler& sampler, ShooterInput& input) {
+    for (const SDL_Event& e : sampler.events()) {
+        if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_SPACE) input.shots.fetch_add(1);   // held, it repeats
+    }
+    input.left.store(sampler.held(SDL_SCANCODE_LEFT));
+    input.right.store(sampler.held(SDL_SCANCODE_RIGHT));
+    input.seq.store(sampler.presses());
+}
+
+// Late latch: if the arrow keys held right now differ from what the frame's
+// tick saw, the player is drawn where the next tick will put it, so a press
+// shows before the simulation has run with it.
+SDL_Rect latchedPlayer(InputSampler& sampler, const ShooterFrame& frame) {
+    SDL_Rect player = frame.player;
+    int axis = sampler.latchAxis(SDL_SCANCODE_LEFT, SDL_SCANCODE_RIGHT);
+    if (axis != frame.axis) {
+        player.x = std::max(0, std::min(SCREEN_WIDTH - player.w, player.x + axis * PLAYER_SPEED));
+    }
+    return player;
+}
+
+void reportLatency(const InputSampler& sampler, const char* mode) {
+    InputSampler::Latency l = sampler.latency();
+    if (l.samples == 0) return;
+    std::cout << "Space shooter (" << mode << "): input to screen over " << l.samples << " key presses: mean "
+              << l.meanMs << " ms, median " << l.medianMs << " ms, 95th " << l.p95Ms << " ms, 99th " << l.p99Ms
+              << " ms, worst " << l.worstMs << " ms\n";
+}
+
+void reportArena(const FrameArena& arena) {
+    const FrameArena::Counters& c = arena.counters();
+    if (c.frames == 0) return;
+    std::cout << "Space shooter: frame arena peaked at " << c.peakBytes << " of " << arena.capacity() << " bytes over "
+              << c.frames << " frames, " << c.overflows << " overflows\n";
+}
+
+struct Ships {
+    int player, enemy;
+};
+
+// Text for the frame comes from arena, which the caller resets once it is
+// presented. The ships all come from one atlas texture and are drawn before
+// any text, so they go to the GPU as one batch.
+void drawFrame(SDL_Renderer* renderer, FontCache& font, FrameArena& arena, SDL_Texture* bgTex,
+               const SpriteAtlas& sprites, const Ships& ships, const ShooterFrame& frame, const SDL_Rect& player) {
+    ALLOC_TAG("draw");
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    SDL_RenderCopy(renderer, bgTex, NULL, NULL);
+    sprites.draw(ships.player, player);
+    for (auto& en : frame.enemies) {
+        sprites.draw(ships.enemy, en.rect);
+    }
+
+    SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
+    for (auto& b : frame.bullets) {
+        SDL_RenderFillRect(renderer, &b.rect);
+    }
+
+    int glow = 128 + 127 * sin(SDL_GetTicks() / 300.0);
+    SDL_Color glowColor = {(Uint8)glow, (Uint8)glow, (Uint8)glow, 255};
+    for (auto& en : frame.enemies) {
+        renderText(renderer, font, en.label, glowColor, en.rect.x + 5, en.rect.y + 10);
+    }
+
+    FrameText score(arena);
+    score << "Score: " << frame.score;
+    renderText(renderer, font, score.c_str(), {255, 255, 255, 255}, 10, 10);
+}
+
+void runSpaceShooter(SDL_Renderer* renderer, FontCache& font) {
+    srand(static_cast<unsigned>(time(NULL)));
+
+    SDL_Surface* bgSurface = IMG_Load("assets/space_background.png");
+    SpriteAtlas sprites(renderer);
+    sprites.load(SHIP_ATLAS_PATH);
+    Ships ships;
+    ships.player = sprites.add("player", "assets/ship1.png");
+    ships.enemy = sprites.add("enemy", "assets/ship2.png");
+
+    if (!bgSurface || ships.player < 0 || ships.enemy < 0) {
+        std::cerr << "Image load error: " << IMG_GetError() << "\n";
+        if (bgSurface) SDL_FreeSurface(bgSurface);
+        return;
+    }
+
+    SDL_Texture* bgTex = SDL_CreateTextureFromSurface(renderer, bgSurface);
+    SDL_FreeSurface(bgSurface);
+
+    std::string playerName = getPlayerName(renderer, font);
+    ShooterSim sim;
+    ShooterInput input;
+    InputSampler sampler;
+    sampler.track(SDLK_SPACE);
+    sampler.track(SDLK_LEFT);
+    sampler.track(SDLK_RIGHT);
+    ShooterFrame last;
+    FrameArena arena(1024);
+
+    // The simulation runs on a thread of its own at a steady tick and hands
+    // each frame over through a triple buffer; this thread (SDL wants events
+    // and the renderer on the one that made them) polls and draws the newest
+    // whenever there is one, so a present that blocks on vsync never holds
+    // up the game. SHOOTER_SINGLE_THREAD=1 runs everything on this thread,
+    // sleeping first and sampling input just in time for each 16 ms tick.
+    const char* single = std::getenv("SHOOTER_SINGLE_THREAD");
+    bool singleThread = single && std::string(single) == "1";
+    if (singleThread) {
+        const Uint64 tick = SDL_GetPerformanceFrequency() * 16 / 1000;
+        Uint64 deadline = InputSampler::now() + tick;
+        while (!last.over) {
+            if (!sampler.sampleBefore(deadline)) break;
+            forwardInput(sampler, input);
+            sim.step(input);
+            sim.snapshot(last);
+            drawFrame(renderer, font, arena, bgTex, sprites, ships, last, latchedPlayer(sampler, last));
+            sampler.readyToPresent();
+            SDL_RenderPresent(renderer);
+            sampler.presented(last.inputSeq);
+            arena.reset();
+            ALLOC_FRAME();
+            // A late frame starts the cadence again instead of rushing to catch up
+            deadline += tick;
+            if (InputSampler::now() > deadline) deadline = InputSampler::now() + tick;
+        }
+    } else {
+        TripleBuffer<ShooterFrame> frames;
+        std::thread simThread([&] {
+            const std::chrono::milliseconds tick(16);
+            std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+            while (!input.quit.load()) {
+                sim.step(input);
+                sim.snapshot(frames.back());
+                frames.publish();
+                if (sim.isOver()) break;
+                next += tick;
+                std::this_thread::sleep_until(next);
+            }
+        });
+
+        while (!last.over) {
+            if (!sampler.sample()) break;
+            forwardInput(sampler, input);
+            if (!frames.update()) {
+                SDL_Delay(1);
+                continue;
+            }
+            const ShooterFrame& frame = frames.front();
+            drawFrame(renderer, font, arena, bgTex, sprites, ships, frame, latchedPlayer(sampler, frame));
+            sampler.readyToPresent();
+            SDL_RenderPresent(renderer);
+            sampler.presented(frame.inputSeq);
+            arena.reset();
+            ALLOC_FRAME();
+            last.score = frame.score;
+            last.over = frame.over;
+        }
+        input.quit.store(true);
+        simThread.join();
+        if (frames.update()) last.score = frames.front().score;
+    }
+    reportLatency(sampler, singleThread ? "single thread" : "simulation thread");
+    reportArena(arena);
+    int score = last.score;
+
+    ScoreClient scores;
+    size_t rank = 0;
+    if (!playerName.empty() && scores.submit(playerName, score)) rank = scores.rank(playerName);
+
+    showEndScreen(renderer, font, playerName, score, score >= WIN_SCORE, rank);
+    SDL_DestroyTexture(bgTex);
+}
@@ -1,18 +1,18 @@
-#ifndef SPACESHOOTER_H
-#define SPACESHOOTER_H
-
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
-
-void runSpaceShooter(SDL_Renderer* renderer, TTF_Font* font);
-
-#endif
-#ifndef SPACESHOOTER_H
-#define SPACESHOOTER_H
-
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
-
-void runSpaceShooter(SDL_Renderer* renderer, TTF_Font* font);
-
-#endif
+#ifndef SPACESHOOTER_H
+#define SPACESHOOTER_H
+
+#include "FontCache.h"
+#include <SDL2/SDL.h>
+
+void runSpaceShooter(SDL_Renderer* renderer, FontCache& font);
+
+#endif
+#ifndef SPACESHOOTER_H
+#define SPACESHOOTER_H
+
+#include "FontCache.h"
+#include <SDL2/SDL.h>
+
+void runSpaceShooter(SDL_Renderer* renderer, FontCache& font);
+
+#endif
@@ -1,20 +1,42 @@
-#include "Utils.h"
-#include <iostream>
-
-void renderText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, SDL_Color color, int x, int y) {
-    SDL_Surface* surface = TTF_RenderUTF8_Blended(font, text.c_str(), color);
-    if (!surface) {
-        std::cerr << "Failed to render text: " << TTF_GetError() << "\n";
-        return;
-    }
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
-    if (!texture) {
-        std::cerr << "Failed to create texture: " << SDL_GetError() << "\n";
-        return;
-    }
-    SDL_Rect dst = {x, y, 0, 0};
-    SDL_QueryTexture(texture, NULL, NULL, &dst.w, &dst.h);
-    SDL_RenderCopy(renderer, texture, NULL, &dst);
-    SDL_DestroyTexture(texture);
-}
+#include "Utils.h"
+#include "AllocTracker.h"
+#include <iostream>
+
+namespace {
+
+bool printableAscii(const char* text) {
+    for (const char* p = text; *p; ++p) {
+        if (*p < ' ' || *p > '~') return false;
+    }
+    return true;
+}
+
+}
+
+void renderText(SDL_Renderer* renderer, FontCache& font, const char* text, SDL_Color color, int x, int y) {
+    if (printableAscii(text) || !font.font()) {
+        font.draw(text, color, x, y);
+        return;
+    }
+
+    ALLOC_TAG("text");
+    SDL_Surface* surface = TTF_RenderUTF8_Blended(font.font(), text, color);
+    if (!surface) {
+        std::cerr << "Failed to render text: " << TTF_GetError() << "\n";
+        return;
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+    if (!texture) {
+        std::cerr << "Failed to create texture: " << SDL_GetError() << "\n";
+        return;
+    }
+    SDL_Rect dst = {x, y, 0, 0};
+    SDL_QueryTexture(texture, NULL, NULL, &dst.w, &dst.h);
+    SDL_RenderCopy(renderer, texture, NULL, &dst);
+    SDL_DestroyTexture(texture);
+}
+
+void renderText(SDL_Renderer* renderer, FontCache& font, const std::string& text, SDL_Color color, int x, int y) {
+    renderText(renderer, font, text.c_str(), color, x, y);
+}
@@ -1,10 +1,17 @@
-#ifndef UTILS_H
-#define UTILS_H
-
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
-#include <string>
-
-void renderText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, SDL_Color color, int x, int y);
-
-#endif
+#ifndef UTILS_H
+#define UTILS_H
+
+#include "FontCache.h"
+#include <SDL2/SDL.h>
+#include <string>
+
+// Built from ../levels/src by `make -C ../levels`; LEVEL_PACK overrides it.
+const char* const LEVEL_PACK_PATH = "../levels/levels.pak";
+
+// Draws text from the font cache's glyphs. Text outside printable ASCII (a
+// typed name) is rasterized with the TTF font instead, as the cache would
+// draw it as '?'. color.a is the text's opacity.
+void renderText(SDL_Renderer* renderer, FontCache& font, const char* text, SDL_Color color, int x, int y);
+void renderText(SDL_Renderer* renderer, FontCache& font, const std::string& text, SDL_Color color, int x, int y);
+
+#endif
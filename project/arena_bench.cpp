@@ -0,0 +1,150 @@
+// Heap allocations per frame for the text the games build every frame, the
+// old way (std::string concatenation, std::to_string, ostringstream) and in
+// a FrameArena with FrameText. malloc, calloc, realloc and free are
+// replaced below to count every call, whichever library makes it.
+//
+// After a warm-up the arena frames must make no heap allocation at all; the
+// bench fails (exit 1) if one does.
+//
+//   arena_bench [frames]   (default 200000)
+#include "FrameArena.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+// glibc's own allocator, under the names it exports for wrappers like these
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* p, size_t size);
+void __libc_free(void* p);
+}
+
+namespace {
+size_t heapCalls = 0;
+}
+
+extern "C" {
+void* malloc(size_t size) {
+    ++heapCalls;
+    return __libc_malloc(size);
+}
+void* calloc(size_t count, size_t size) {
+    ++heapCalls;
+    return __libc_calloc(count, size);
+}
+void* realloc(void* p, size_t size) {
+    ++heapCalls;
+    return __libc_realloc(p, size);
+}
+void free(void* p) {
+    __libc_free(p);
+}
+}
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// What the games show on a frame, from the frame number
+struct State {
+    int score, secondsLeft, x, y;
+    std::string question, answer, player;
+};
+
+State stateAt(int frame) {
+    State s;
+    s.score = frame * 10;
+    s.secondsLeft = 60 - frame / 60 % 60;
+    s.x = frame % 13;
+    s.y = frame % 11;
+    s.question = "I speak without a mouth and hear without ears. I have no body, but I come alive with wind. What am I?";
+    s.answer = "an echo";
+    s.player = "Player One";
+    return s;
+}
+
+// Keeps the compiler from dropping text nobody reads
+size_t sink = 0;
+void use(const char* text) {
+    sink += static_cast<unsigned char>(text[0]);
+}
+
+void oldFrame(const State& s) {
+    use(("Score: " + std::to_string(s.score)).c_str());
+    use(("Time Left: " + std::to_string(s.secondsLeft)).c_str());
+    use(("Welcome, " + s.player + "!").c_str());
+    std::ostringstream oss;
+    oss << "y = (" << s.x << ", " << s.y << ")";
+    use(oss.str().c_str());
+    std::string fullText = s.question + "\n\nYour Answer: " + s.answer + "\n\nTime Left: " + std::to_string(s.secondsLeft);
+    use(fullText.c_str());
+}
+
+void arenaFrame(FrameArena& arena, const State& s) {
+    FrameText score(arena);
+    score << "Score: " << s.score;
+    use(score.c_str());
+    FrameText timeLeft(arena);
+    timeLeft << "Time Left: " << s.secondsLeft;
+    use(timeLeft.c_str());
+    FrameText welcome(arena, 96);
+    welcome << "Welcome, " << s.player << "!";
+    use(welcome.c_str());
+    FrameText y(arena);
+    y << "y = (" << s.x << ", " << s.y << ")";
+    use(y.c_str());
+    FrameText fullText(arena, 1024);
+    fullText << s.question << "\n\nYour Answer: " << s.answer << "\n\nTime Left: " << s.secondsLeft;
+    use(fullText.c_str());
+    arena.reset();
+}
+
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::atoi(argv[1]) : 200000;
+    if (frames < 1) {
+        std::fprintf(stderr, "usage: arena_bench [frames]\n");
+        return 1;
+    }
+    // The states are made up front so only the formatting is counted
+    const int distinct = 3600;
+    State* states = new State[distinct];
+    for (int i = 0; i < distinct; ++i) states[i] = stateAt(i);
+
+    FrameArena arena(4096);
+    for (int i = 0; i < 100; ++i) {
+        oldFrame(states[i]);
+        arenaFrame(arena, states[i]);
+    }
+
+    size_t before = heapCalls;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < frames; ++i) oldFrame(states[i % distinct]);
+    double oldNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / frames;
+    size_t oldCalls = heapCalls - before;
+
+    before = heapCalls;
+    start = Clock::now();
+    for (int i = 0; i < frames; ++i) arenaFrame(arena, states[i % distinct]);
+    double arenaNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / frames;
+    size_t arenaCalls = heapCalls - before;
+
+    const FrameArena::Counters& c = arena.counters();
+    std::printf("%d frames, 5 strings each\n", frames);
+    std::printf("%-24s %14s %12s\n", "", "mallocs/frame", "ns/frame");
+    std::printf("%-24s %14.2f %12.0f\n", "std::string, ostream", double(oldCalls) / frames, oldNs);
+    std::printf("%-24s %14.2f %12.0f\n", "FrameArena, FrameText", double(arenaCalls) / frames, arenaNs);
+    std::printf("arena: %zu of %zu bytes at peak, %zu overflows, %zu heap block\n", c.peakBytes, arena.capacity(),
+                c.overflows, c.heapBlocks);
+    delete[] states;
+    if (sink == 0) std::printf("\n");
+    if (arenaCalls != 0 || c.overflows != 0) {
+        std::printf("FAIL: arena frames allocated from the heap\n");
+        return 1;
+    }
+    return 0;
+}
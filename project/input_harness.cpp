@@ -0,0 +1,172 @@
+// Pushes synthetic key presses through SDL's event queue and measures with
+// InputSampler how long each takes to reach the screen, for two loops:
+//
+//   sample, update, draw, present, SDL_Delay(16)   the space shooter's old loop
+//   sleep, sample just in time, update, draw, present   InputSampler::sampleBefore
+//
+// By default it runs without a display on SDL's dummy video driver, whose
+// present doesn't wait for a refresh, so the harness waits for a 60 Hz one
+// itself after each present. With --window it opens a real window with
+// vsync instead.
+//
+//   input_harness [presses per loop] [draw ms] [--window]   (defaults: 200, 4)
+#include "InputSampler.h"
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+
+namespace {
+
+struct Display {
+    SDL_Window* window;
+    SDL_Renderer* renderer;
+    bool emulateVsync;
+    Uint64 start;     // performance counter at the first refresh
+    Uint64 refresh;   // performance counter ticks per refresh
+};
+
+// The next refresh after now.
+Uint64 nextRefresh(const Display& d) {
+    Uint64 now = InputSampler::now();
+    return d.start + ((now - d.start) / d.refresh + 1) * d.refresh;
+}
+
+void present(Display& d) {
+    SDL_RenderPresent(d.renderer);
+    if (!d.emulateVsync) return;
+    Uint64 until = nextRefresh(d);
+    double ms = InputSampler::ms(InputSampler::now(), until);
+    if (ms > 1.0) SDL_Delay(static_cast<Uint32>(ms - 1.0));
+    while (InputSampler::now() < until) {
+    }
+}
+
+// A frame's worth of work: some rectangles, then busy until drawMs is up.
+void draw(Display& d, double drawMs, int frame) {
+    Uint64 start = InputSampler::now();
+    SDL_SetRenderDrawColor(d.renderer, 0, 0, 0, 255);
+    SDL_RenderClear(d.renderer);
+    SDL_SetRenderDrawColor(d.renderer, 255, 255, 0, 255);
+    for (int i = 0; i < 200; ++i) {
+        SDL_Rect r = {(i * 37 + frame * 3) % 780, (i * 53) % 580, 10, 20};
+        SDL_RenderFillRect(d.renderer, &r);
+    }
+    while (InputSampler::ms(start, InputSampler::now()) < drawMs) {
+    }
+}
+
+// Presses space `presses` times at random intervals from another thread,
+// as a keyboard would, through the same queue.
+void inject(int presses, std::atomic<bool>& done) {
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<int> gap(30, 120);
+    for (int i = 0; i < presses; ++i) {
+        SDL_Delay(gap(rng));
+        SDL_Event e;
+        std::memset(&e, 0, sizeof e);
+        e.type = SDL_KEYDOWN;
+        e.key.state = SDL_PRESSED;
+        e.key.keysym.sym = SDLK_SPACE;
+        e.key.keysym.scancode = SDL_SCANCODE_SPACE;
+        SDL_PushEvent(&e);
+        SDL_Delay(10);
+        e.type = SDL_KEYUP;
+        e.key.state = SDL_RELEASED;
+        SDL_PushEvent(&e);
+    }
+    done.store(true);
+}
+
+void run(Display& d, const char* name, bool late, int presses, double drawMs) {
+    InputSampler sampler;
+    sampler.track(SDLK_SPACE);
+    std::atomic<bool> done(false);
+    std::thread injector(inject, presses, std::ref(done));
+
+    Uint64 deadline = nextRefresh(d);
+    int frame = 0;
+    while (!done.load() || sampler.latency().samples < static_cast<size_t>(sampler.presses())) {
+        if (late) {
+            sampler.sampleBefore(deadline);
+        } else {
+            sampler.sample();
+        }
+        Uint32 shows = sampler.presses();   // the "update"
+        draw(d, drawMs, frame++);
+        sampler.readyToPresent();
+        present(d);
+        sampler.presented(shows);
+        if (late) {
+            deadline = nextRefresh(d);
+        } else {
+            SDL_Delay(16);
+        }
+    }
+    injector.join();
+
+    InputSampler::Latency l = sampler.latency();
+    std::printf("%-26s %6zu %8.1f %8.1f %8.1f %8.1f %8.1f\n", name, l.samples, l.meanMs, l.medianMs, l.p95Ms,
+                l.p99Ms, l.worstMs);
+}
+
+}
+
+int main(int argc, char** argv) {
+    int presses = 200;
+    double drawMs = 4.0;
+    bool window = false;
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--window") window = true;
+        else if (positional++ == 0) presses = std::atoi(argv[i]);
+        else drawMs = std::atof(argv[i]);
+    }
+    if (presses < 1 || drawMs < 0 || drawMs > 15) {
+        std::fprintf(stderr, "usage: input_harness [presses per loop] [draw ms, under 15] [--window]\n");
+        return 1;
+    }
+
+    if (!window) SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        std::fprintf(stderr, "SDL_Init failed: %s\n", SDL_GetError());
+        return 1;
+    }
+    Display d;
+    d.window = SDL_CreateWindow("input harness", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600,
+                                window ? SDL_WINDOW_SHOWN : SDL_WINDOW_HIDDEN);
+    d.renderer = d.window ? SDL_CreateRenderer(d.window, -1, window ? SDL_RENDERER_PRESENTVSYNC : SDL_RENDERER_SOFTWARE)
+                          : NULL;
+    if (!d.renderer) {
+        std::fprintf(stderr, "can't open a window: %s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+    int hz = 60;
+    SDL_DisplayMode mode;
+    if (window && SDL_GetCurrentDisplayMode(0, &mode) == 0 && mode.refresh_rate > 0) hz = mode.refresh_rate;
+    d.emulateVsync = !window;
+    d.refresh = SDL_GetPerformanceFrequency() / hz;
+    d.start = InputSampler::now();
+    if (window) {
+        // Line the refresh grid up with a real present
+        SDL_RenderPresent(d.renderer);
+        d.start = InputSampler::now();
+    }
+
+    std::printf("%d presses per loop, %.1f ms to draw, %d Hz %s\n", presses, drawMs, hz,
+                window ? "vsync" : "emulated refresh (dummy driver)");
+    std::printf("%-26s %6s %8s %8s %8s %8s %8s\n", "loop", "keys", "mean ms", "median", "95th", "99th", "worst");
+    run(d, "sample, then sleep 16 ms", false, presses, drawMs);
+    run(d, "sleep, then sample late", true, presses, drawMs);
+
+    SDL_DestroyRenderer(d.renderer);
+    SDL_DestroyWindow(d.window);
+    SDL_Quit();
+    return 0;
+}
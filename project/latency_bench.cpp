@@ -0,0 +1,153 @@
+// Input-to-screen latency of the space shooter's two loops, without a
+// window: the old one that polls, updates, draws, presents and sleeps 16 ms
+// on one thread, and the new one with the simulation on its own thread
+// handing frames over through a TripleBuffer.
+//
+// Key presses arrive at random times. Updating and drawing take a fixed
+// time each (slept, so the two threads don't fight over one core), and a
+// present with vsync blocks until the next 60 Hz refresh. A press counts
+// from when it arrives to when the first present showing it returns, as in
+// the game's own report.
+//
+//   latency_bench [seconds per run] [update ms] [draw ms]   (defaults: 5, 1, 4)
+#include "TripleBuffer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const double REFRESH_MS = 1000.0 / 60.0;
+
+struct Frame {
+    unsigned inputSeq;
+};
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void sleepMs(double ms) {
+    std::this_thread::sleep_for(std::chrono::microseconds(static_cast<long long>(ms * 1000)));
+}
+
+// Blocks until the next refresh with vsync, returns at once without.
+void present(Clock::time_point start, bool vsync) {
+    if (!vsync) return;
+    double now = msSince(start);
+    sleepMs((static_cast<long long>(now / REFRESH_MS) + 1) * REFRESH_MS - now);
+}
+
+struct Run {
+    std::vector<double> presses;   // arrival times, ms from the start
+    size_t polled;                 // presses seen by poll()
+    std::vector<double> latencies;
+
+    // Takes the presses that have arrived; returns the newest one's number.
+    unsigned poll(Clock::time_point start) {
+        double now = msSince(start);
+        while (polled < presses.size() && presses[polled] <= now) ++polled;
+        return static_cast<unsigned>(polled);
+    }
+
+    void presented(unsigned shownSeq, Clock::time_point start, size_t& shown) {
+        double now = msSince(start);
+        for (; shown < shownSeq; ++shown) latencies.push_back(now - presses[shown]);
+    }
+};
+
+Run makeRun(double seconds) {
+    Run run;
+    run.polled = 0;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> gap(40.0, 160.0);
+    for (double t = gap(rng); t < seconds * 1000 - 200; t += gap(rng)) run.presses.push_back(t);
+    return run;
+}
+
+void singleThread(Run& run, double seconds, double updateMs, double drawMs, bool vsync) {
+    Clock::time_point start = Clock::now();
+    size_t shown = 0;
+    while (msSince(start) < seconds * 1000) {
+        unsigned seq = run.poll(start);
+        sleepMs(updateMs);
+        sleepMs(drawMs);
+        present(start, vsync);
+        run.presented(seq, start, shown);
+        sleepMs(16);
+    }
+}
+
+void simulationThread(Run& run, double seconds, double updateMs, double drawMs, bool vsync) {
+    Clock::time_point start = Clock::now();
+    TripleBuffer<Frame> frames;
+    std::atomic<unsigned> inputSeq(0);
+    std::atomic<bool> quit(false);
+
+    std::thread sim([&] {
+        Clock::time_point next = Clock::now();
+        while (!quit.load()) {
+            unsigned seq = inputSeq.load();
+            sleepMs(updateMs);
+            frames.back().inputSeq = seq;
+            frames.publish();
+            next += std::chrono::milliseconds(16);
+            std::this_thread::sleep_until(next);
+        }
+    });
+
+    size_t shown = 0;
+    while (msSince(start) < seconds * 1000) {
+        inputSeq.store(run.poll(start));
+        if (!frames.update()) {
+            sleepMs(1);
+            continue;
+        }
+        unsigned seq = frames.front().inputSeq;
+        sleepMs(drawMs);
+        present(start, vsync);
+        run.presented(seq, start, shown);
+    }
+    quit.store(true);
+    sim.join();
+}
+
+void report(const char* name, Run& run) {
+    std::vector<double>& l = run.latencies;
+    std::sort(l.begin(), l.end());
+    double sum = 0;
+    for (double ms : l) sum += ms;
+    std::printf("%-28s %6zu %9.1f %9.1f %9.1f %9.1f\n", name, l.size(), sum / l.size(), l[l.size() / 2],
+                l[l.size() * 95 / 100], l.back());
+}
+
+}
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? std::atof(argv[1]) : 5.0;
+    double updateMs = argc > 2 ? std::atof(argv[2]) : 1.0;
+    double drawMs = argc > 3 ? std::atof(argv[3]) : 4.0;
+    if (seconds < 1 || updateMs < 0 || drawMs < 0) {
+        std::fprintf(stderr, "usage: latency_bench [seconds per run] [update ms] [draw ms]\n");
+        return 1;
+    }
+
+    std::printf("%-28s %6s %9s %9s %9s %9s\n", "loop", "keys", "mean ms", "median", "95th", "worst");
+    for (int vsync = 0; vsync < 2; ++vsync) {
+        Run a = makeRun(seconds);
+        singleThread(a, seconds, updateMs, drawMs, vsync != 0);
+        report(vsync ? "single thread, vsync" : "single thread, no vsync", a);
+
+        Run b = makeRun(seconds);
+        simulationThread(b, seconds, updateMs, drawMs, vsync != 0);
+        report(vsync ? "simulation thread, vsync" : "simulation thread, no vsync", b);
+    }
+    return 0;
+}
@@ -1,62 +1,71 @@
-#include "PuzzleGame.h"
-#include "RSADecryptor.h"
-#include "SpaceShooter.h"
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
-#include <iostream>
-
-int main() {
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-        std::cerr << "SDL_Init failed: " << SDL_GetError() << std::endl;
-        return 1;
-    }
-
-    if (TTF_Init() < 0) {
-        std::cerr << "TTF_Init failed: " << TTF_GetError() << std::endl;
-        SDL_Quit();
-        return 1;
-    }
-
-    SDL_Window* window = SDL_CreateWindow("MultiGame",
-                                          SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-                                          1024, 768, SDL_WINDOW_SHOWN);
-    if (!window) {
-        std::cerr << "SDL_CreateWindow failed: " << SDL_GetError() << std::endl;
-        TTF_Quit();
-        SDL_Quit();
-        return 1;
-    }
-
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-    if (!renderer) {
-        std::cerr << "SDL_CreateRenderer failed: " << SDL_GetError() << std::endl;
-        SDL_DestroyWindow(window);
-        TTF_Quit();
-        SDL_Quit();
-        return 1;
-    }
-
-    TTF_Font* font = TTF_OpenFont("assets/impact.ttf", 24);
-    if (!font) {
-        std::cerr << "Failed to load font: " << TTF_GetError() << std::endl;
-        SDL_DestroyRenderer(renderer);
-        SDL_DestroyWindow(window);
-        TTF_Quit();
-        SDL_Quit();
-        return 1;
-    }
-
-    // Run games one by one
-    runPuzzle(window, renderer, font);
-    runRSADecyptor(renderer, font);
-    runSpaceShooter(renderer, font);
-
-    // Cleanup
-    TTF_CloseFont(font);
-    SDL_DestroyRenderer(renderer);
-    SDL_DestroyWindow(window);
-    TTF_Quit();
-    SDL_Quit();
-
-    return 0;
-}
+#include "PuzzleGame.h"
+#include "RSADecryptor.h"
+#include "SpaceShooter.h"
+#include "AllocTracker.h"
+#include "FontCache.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <iostream>
+
+int main() {
+    ALLOC_TRACK_START("MultiGame");
+    ALLOC_TRACK_SDL();
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        std::cerr << "SDL_Init failed: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    if (TTF_Init() < 0) {
+        std::cerr << "TTF_Init failed: " << TTF_GetError() << std::endl;
+        SDL_Quit();
+        return 1;
+    }
+
+    SDL_Window* window = SDL_CreateWindow("MultiGame",
+                                          SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                                          1024, 768, SDL_WINDOW_SHOWN);
+    if (!window) {
+        std::cerr << "SDL_CreateWindow failed: " << SDL_GetError() << std::endl;
+        TTF_Quit();
+        SDL_Quit();
+        return 1;
+    }
+
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    if (!renderer) {
+        std::cerr << "SDL_CreateRenderer failed: " << SDL_GetError() << std::endl;
+        SDL_DestroyWindow(window);
+        TTF_Quit();
+        SDL_Quit();
+        return 1;
+    }
+
+    // Labels and the HUD draw from the glyph cache; the name and answer
+    // fields on the first screens still need the TTF font itself.
+    FontCache font(renderer);
+    if (!font.open("assets/impact.ttf", 24) || !font.font()) {
+        std::cerr << "Failed to load font" << std::endl;
+        font.close();
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        TTF_Quit();
+        SDL_Quit();
+        return 1;
+    }
+    font.printReport(std::cout);
+
+    // Run games one by one
+    runPuzzle(window, renderer, font);
+    runRSADecyptor(renderer, font);
+    runSpaceShooter(renderer, font);
+
+    // Cleanup
+    font.close();
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    TTF_Quit();
+    SDL_Quit();
+
+    return 0;
+}